@@ -0,0 +1,1382 @@
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <tuple>
+#include <vector>
+#include <wincpp/patterns/generator.hpp>
+#include <wincpp/patterns/image_index.hpp>
+#include <wincpp/patterns/lanes.hpp>
+#include <wincpp/patterns/pointer_map.hpp>
+#include <wincpp/patterns/regex.hpp>
+#include <wincpp/patterns/scanner.hpp>
+#include <wincpp/patterns/scan_session.hpp>
+#include <wincpp/patterns/signature_set.hpp>
+#include <wincpp/patterns/strings.hpp>
+#include <wincpp/patterns/values.hpp>
+
+using namespace wincpp::patterns;
+
+namespace
+{
+    /// <summary>
+    /// A named buffer to scan.
+    /// </summary>
+    struct corpus_t
+    {
+        std::string name;
+        std::vector< std::uint8_t > bytes;
+    };
+
+    /// <summary>
+    /// The measurements of one algorithm for one pattern.
+    /// </summary>
+    struct result_t
+    {
+        double throughput;  // GB/s of find_all
+        double latency;     // Microseconds until find returns
+        std::size_t hits;
+        bool agrees;
+    };
+
+    /// <summary>
+    /// Appends the bytes of the value in little endian.
+    /// </summary>
+    template< typename T >
+    void append( std::vector< std::uint8_t >& out, T value )
+    {
+        for ( std::size_t i = 0; i < sizeof( T ); ++i )
+            out.push_back( static_cast< std::uint8_t >( static_cast< std::uint64_t >( value ) >> ( i * 8 ) ) );
+    }
+
+    /// <summary>
+    /// Uniformly random bytes.
+    /// </summary>
+    corpus_t random_corpus( std::size_t size, std::mt19937_64& random )
+    {
+        corpus_t corpus{ "random", {} };
+        corpus.bytes.resize( size );
+
+        for ( auto& byte : corpus.bytes )
+            byte = static_cast< std::uint8_t >( random() );
+
+        return corpus;
+    }
+
+    /// <summary>
+    /// Functions built from the instruction encodings that dominate x86-64 code, padded to 16 bytes with int3 like MSVC does.
+    /// </summary>
+    corpus_t code_corpus( std::size_t size, std::mt19937_64& random )
+    {
+        corpus_t corpus{ "code", {} };
+        auto& out = corpus.bytes;
+
+        out.reserve( size + 64 );
+
+        // Relative displacements stay small, so their high bytes are mostly 00 or FF.
+        const auto rel32 = [ & ] { return static_cast< std::int32_t >( random() % 0x20000 ) - 0x10000; };
+
+        while ( out.size() < size )
+        {
+            // Prologue: mov [rsp+8], rbx; push rdi; sub rsp, imm8
+            out.insert( out.end(), { 0x48, 0x89, 0x5C, 0x24, 0x08, 0x57, 0x48, 0x83, 0xEC } );
+            out.push_back( static_cast< std::uint8_t >( 0x20 + ( random() % 8 ) * 0x10 ) );
+
+            for ( auto count = 4 + random() % 24; count > 0; --count )
+            {
+                switch ( random() % 10 )
+                {
+                    case 0: out.insert( out.end(), { 0x48, 0x8B, 0x05 } ), append( out, rel32() ); break;              // mov rax, [rip+rel32]
+                    case 1: out.insert( out.end(), { 0x48, 0x8D, 0x0D } ), append( out, rel32() ); break;              // lea rcx, [rip+rel32]
+                    case 2: out.push_back( 0xE8 ), append( out, rel32() ); break;                                      // call rel32
+                    case 3: out.insert( out.end(), { 0x48, 0x85, 0xC0, 0x74 } ), out.push_back( random() % 0x40 ); break;  // test; je rel8
+                    case 4: out.insert( out.end(), { 0x8B, 0x44, 0x24 } ), out.push_back( random() % 0x80 ); break;    // mov eax, [rsp+imm8]
+                    case 5: out.insert( out.end(), { 0x48, 0x8B, 0x4C, 0x24 } ), out.push_back( random() % 0x80 ); break;  // mov rcx, [rsp+imm8]
+                    case 6: out.insert( out.end(), { 0x33, 0xC0 } ); break;                                            // xor eax, eax
+                    case 7: out.insert( out.end(), { 0x0F, 0x84 } ), append( out, rel32() ); break;                    // je rel32
+                    case 8: out.insert( out.end(), { 0x4C, 0x8B, 0xC3 } ); break;                                      // mov r8, rbx
+                    default: out.insert( out.end(), { 0x89, 0x41 } ), out.push_back( random() % 0x40 ); break;         // mov [rcx+imm8], eax
+                }
+            }
+
+            // Epilogue: mov rbx, [rsp+imm8]; add rsp, imm8; pop rdi; ret
+            out.insert( out.end(), { 0x48, 0x8B, 0x5C, 0x24, 0x30, 0x48, 0x83, 0xC4, 0x20, 0x5F, 0xC3 } );
+
+            while ( out.size() % 16 )
+                out.push_back( 0xCC );
+        }
+
+        out.resize( size );
+        return corpus;
+    }
+
+    /// <summary>
+    /// Data sections: mostly zeros, with small integers, pointers into a module and bits of text in between.
+    /// </summary>
+    corpus_t data_corpus( std::size_t size, std::mt19937_64& random )
+    {
+        corpus_t corpus{ "data", {} };
+        auto& out = corpus.bytes;
+
+        out.reserve( size + 8 );
+
+        while ( out.size() < size )
+        {
+            const auto kind = random() % 20;
+
+            if ( kind < 12 )
+                append( out, std::uint64_t( 0 ) );
+            else if ( kind < 15 )
+                append( out, random() % 256 );
+            else if ( kind < 18 )
+                append( out, 0x00007FF600000000ull + ( random() % 0x1000000 ) * 8 );
+            else
+            {
+                for ( std::size_t i = 0; i < 8; ++i )
+                    out.push_back( static_cast< std::uint8_t >( 'a' + random() % 26 ) );
+            }
+        }
+
+        out.resize( size );
+        return corpus;
+    }
+
+    /// <summary>
+    /// Loads a file from disk. PE files are laid out as they would be in memory, so the scanners see what they see in a module.
+    /// </summary>
+    std::optional< corpus_t > load_corpus( const std::string& path )
+    {
+        std::ifstream file( path, std::ios::binary );
+
+        if ( !file )
+            return std::nullopt;
+
+        corpus_t corpus{ path, std::vector< std::uint8_t >( std::istreambuf_iterator< char >( file ), {} ) };
+        const auto& raw = corpus.bytes;
+
+        const auto read = [ & ]< typename T >( std::size_t offset ) -> T
+        {
+            T value{};
+
+            if ( offset + sizeof( T ) <= raw.size() )
+                std::memcpy( &value, raw.data() + offset, sizeof( T ) );
+
+            return value;
+        };
+
+        // Anything that isn't a PE file is scanned as it is.
+        if ( read.operator()< std::uint16_t >( 0 ) != 0x5A4D )
+            return corpus;
+
+        const auto nt = read.operator()< std::uint32_t >( 0x3C );
+
+        if ( read.operator()< std::uint32_t >( nt ) != 0x00004550 )
+            return corpus;
+
+        const auto sections = read.operator()< std::uint16_t >( nt + 6 );
+        const auto optional_size = read.operator()< std::uint16_t >( nt + 20 );
+        const auto image_size = read.operator()< std::uint32_t >( nt + 24 + 56 );
+        const auto headers_size = read.operator()< std::uint32_t >( nt + 24 + 60 );
+
+        if ( image_size == 0 || image_size > 1024 * 1024 * 1024 )
+            return corpus;
+
+        std::vector< std::uint8_t > image( image_size );
+        std::memcpy( image.data(), raw.data(), std::min< std::size_t >( { headers_size, raw.size(), image.size() } ) );
+
+        for ( std::size_t i = 0; i < sections; ++i )
+        {
+            const auto header = nt + 24 + optional_size + i * 40;
+            const auto address = read.operator()< std::uint32_t >( header + 12 );
+            const auto raw_size = read.operator()< std::uint32_t >( header + 16 );
+            const auto raw_offset = read.operator()< std::uint32_t >( header + 20 );
+
+            if ( raw_offset >= raw.size() || address >= image.size() )
+                continue;
+
+            const auto count = std::min< std::size_t >( { raw_size, raw.size() - raw_offset, image.size() - address } );
+            std::memcpy( image.data() + address, raw.data() + raw_offset, count );
+        }
+
+        corpus.bytes = std::move( image );
+        return corpus;
+    }
+
+    /// <summary>
+    /// Takes a pattern from a random place in the corpus, so it occurs at least once, and wildcards a share of its positions.
+    /// </summary>
+    pattern_t make_pattern( const corpus_t& corpus, std::size_t size, double wildcards, std::mt19937_64& random )
+    {
+        const auto offset = random() % ( corpus.bytes.size() - size );
+        auto pattern = pattern_t( corpus.bytes.data() + offset, size );
+
+        std::bernoulli_distribution wildcard( wildcards );
+        bool strict = false;
+
+        for ( std::size_t i = 0; i < size; ++i )
+        {
+            if ( wildcard( random ) )
+                pattern.atoms[ i ] = atom_t{};
+            else
+                strict = true;
+        }
+
+        // A pattern of only wildcards matches everywhere, which measures nothing.
+        if ( !strict )
+            pattern.atoms[ 0 ] = atom_t{ corpus.bytes[ offset ], 0xFF };
+
+        return pattern;
+    }
+
+    /// <summary>
+    /// Gets the best of three runs of the function, in nanoseconds.
+    /// </summary>
+    template< typename F >
+    double time( F&& function )
+    {
+        auto best = std::numeric_limits< double >::max();
+
+        for ( std::size_t run = 0; run < 3; ++run )
+        {
+            const auto start = std::chrono::steady_clock::now();
+            function();
+            best = std::min( best, std::chrono::duration< double, std::nano >( std::chrono::steady_clock::now() - start ).count() );
+        }
+
+        return best;
+    }
+
+    /// <summary>
+    /// Measures the algorithm on the corpus and compares its matches with the reference.
+    /// </summary>
+    template< scanner::algorithm_t algorithm >
+    result_t run( const corpus_t& corpus, const compiled_pattern_t& pattern, const std::vector< std::uintptr_t >& reference )
+    {
+        auto buffer = std::span( const_cast< std::uint8_t* >( corpus.bytes.data() ), corpus.bytes.size() );
+
+        std::vector< std::uintptr_t > matches;
+        std::optional< std::uintptr_t > first;
+
+        const auto all = time( [ & ] { matches = scanner::find_all< algorithm >( buffer, pattern ); } );
+        const auto once = time( [ & ] { first = scanner::find< algorithm >( buffer, pattern ); } );
+
+        const auto expected = reference.empty() ? std::nullopt : std::make_optional( reference.front() );
+
+        return { static_cast< double >( buffer.size() ) / all, once / 1000.0, matches.size(), matches == reference && first == expected };
+    }
+
+    /// <summary>
+    /// Every algorithm, in the order they are reported.
+    /// </summary>
+    struct algorithm_entry_t
+    {
+        const char* name;
+        result_t ( *run )( const corpus_t&, const compiled_pattern_t&, const std::vector< std::uintptr_t >& );
+    };
+
+    constexpr algorithm_entry_t algorithms[] = {
+        { "naive", &run< scanner::algorithm_t::naive_t > },   { "bmh", &run< scanner::algorithm_t::bmh_t > },
+        { "raita", &run< scanner::algorithm_t::raita_t > },   { "tbm", &run< scanner::algorithm_t::tbm_t > },
+        { "simd", &run< scanner::algorithm_t::simd_t > },     { "bndm", &run< scanner::algorithm_t::bndm_t > },
+        { "shift_or", &run< scanner::algorithm_t::shift_or_t > }, { "auto", &run< scanner::algorithm_t::auto_t > },
+    };
+
+    /// <summary>
+    /// The matches of `scanner::find_all_strings` found one position at a time, to check the vectorized kernels against.
+    /// </summary>
+    std::vector< string_match_t > reference_strings( const corpus_t& corpus, std::string_view text )
+    {
+        const auto fold = []( std::uint8_t byte ) { return byte >= 'A' && byte <= 'Z' ? static_cast< std::uint8_t >( byte | 0x20 ) : byte; };
+        const auto& bytes = corpus.bytes;
+
+        std::vector< string_match_t > results;
+
+        for ( std::size_t i = 0; i < bytes.size(); ++i )
+        {
+            bool ascii = i + text.size() <= bytes.size(), wide = i + text.size() * 2 <= bytes.size();
+
+            for ( std::size_t k = 0; k < text.size() && ( ascii || wide ); ++k )
+            {
+                const auto expected = fold( static_cast< std::uint8_t >( text[ k ] ) );
+
+                ascii = ascii && fold( bytes[ i + k ] ) == expected;
+                wide = wide && fold( bytes[ i + k * 2 ] ) == expected && bytes[ i + k * 2 + 1 ] == 0;
+            }
+
+            if ( ascii )
+                results.push_back( { i, string_encoding_t::ascii_nocase_t } );
+
+            if ( wide )
+                results.push_back( { i, string_encoding_t::utf16le_t } );
+        }
+
+        return results;
+    }
+
+    /// <summary>
+    /// The runs of `extract_strings` found one byte at a time, to check the vectorized kernels against.
+    /// </summary>
+    std::vector< extracted_string_t > reference_extract( std::span< const std::uint8_t > bytes, std::size_t min_length, string_encoding_t encoding )
+    {
+        const auto printable = []( std::uint8_t byte ) { return ( byte >= 0x20 && byte <= 0x7E ) || byte == '\t'; };
+        const auto wide = [ & ]( std::size_t offset )
+        { return offset + 1 < bytes.size() && printable( bytes[ offset ] ) && bytes[ offset + 1 ] == 0; };
+
+        const auto want_ascii = ( static_cast< std::uint8_t >( encoding ) & static_cast< std::uint8_t >( string_encoding_t::ascii_nocase_t ) ) != 0;
+        const auto want_wide = ( static_cast< std::uint8_t >( encoding ) & static_cast< std::uint8_t >( string_encoding_t::utf16le_t ) ) != 0;
+
+        std::vector< extracted_string_t > results;
+
+        for ( std::size_t offset = 0; offset < bytes.size(); ++offset )
+        {
+            // A run starts where the character before it isn't part of one.
+            if ( want_ascii && printable( bytes[ offset ] ) && ( offset == 0 || !printable( bytes[ offset - 1 ] ) ) )
+            {
+                auto end = offset;
+
+                while ( end < bytes.size() && printable( bytes[ end ] ) )
+                    ++end;
+
+                if ( end - offset >= min_length )
+                    results.push_back( { offset, string_encoding_t::ascii_nocase_t, std::string( bytes.begin() + offset, bytes.begin() + end ) } );
+            }
+
+            if ( want_wide && wide( offset ) && ( offset < 2 || !wide( offset - 2 ) ) )
+            {
+                std::string text;
+
+                for ( auto at = offset; wide( at ); at += 2 )
+                    text.push_back( static_cast< char >( bytes[ at ] ) );
+
+                if ( text.size() >= min_length )
+                    results.push_back( { offset, string_encoding_t::utf16le_t, std::move( text ) } );
+            }
+        }
+
+        return results;
+    }
+
+    /// <summary>
+    /// The matches of `find_values` found one position at a time, to check the vectorized kernels against.
+    /// </summary>
+    template< typename T >
+    std::vector< std::uintptr_t > reference_values( const corpus_t& corpus, T low, T high, std::size_t alignment )
+    {
+        std::vector< std::uintptr_t > results;
+
+        for ( std::size_t i = 0; i + sizeof( T ) <= corpus.bytes.size(); i += alignment )
+        {
+            T value;
+            std::memcpy( &value, corpus.bytes.data() + i, sizeof( T ) );
+
+            if ( low <= value && value <= high )
+                results.push_back( i );
+        }
+
+        return results;
+    }
+
+    /// <summary>
+    /// The matches of `scanner::find_approx` found by counting the wrong positions at every location.
+    /// </summary>
+    std::vector< approx_match_t > reference_approx( const corpus_t& corpus, const pattern_t& pattern, std::size_t k, std::size_t limit )
+    {
+        // A position that accepts every byte is a wildcard, and the budget leaves at least one of the others right.
+        std::size_t strict = 0;
+
+        for ( std::size_t i = 0; i < pattern.size; ++i )
+        {
+            for ( std::size_t byte = 0; byte < 256; ++byte )
+            {
+                if ( !pattern.accepts( i, static_cast< std::uint8_t >( byte ) ) )
+                {
+                    ++strict;
+                    break;
+                }
+            }
+        }
+
+        if ( strict == 0 )
+            return {};
+
+        k = std::min( k, strict - 1 );
+
+        std::vector< approx_match_t > results;
+
+        for ( std::size_t offset = 0; offset + pattern.size <= corpus.bytes.size(); ++offset )
+        {
+            std::size_t distance = 0;
+
+            for ( std::size_t i = 0; i < pattern.size && distance <= k; ++i )
+                distance += !pattern.accepts( i, corpus.bytes[ offset + i ] );
+
+            if ( distance <= k )
+                results.push_back( { offset, distance } );
+        }
+
+        std::stable_sort( results.begin(), results.end(), []( const approx_match_t& a, const approx_match_t& b ) { return a.distance < b.distance; } );
+
+        if ( results.size() > limit )
+            results.resize( limit );
+
+        return results;
+    }
+
+    /// <summary>
+    /// A set of bytes repeated between `low` and `high` times, as one piece of an expression for `reference_regex`.
+    /// </summary>
+    struct piece_t
+    {
+        byte_class_t set;
+        std::size_t low, high;
+    };
+
+    /// <summary>
+    /// The matches of `regex_t::find_all` for a sequence of pieces, found by trying every start before the earliest end seen so far.
+    /// </summary>
+    std::vector< regex_t::match_t > reference_regex( std::span< const std::uint8_t > bytes, const std::vector< piece_t >& pieces )
+    {
+        std::size_t longest = 0;
+
+        for ( const auto& piece : pieces )
+            longest += piece.high;
+
+        std::vector< regex_t::match_t > results;
+
+        for ( std::size_t from = 0; from < bytes.size(); )
+        {
+            auto end = bytes.size() + 1, start = end;
+
+            for ( auto offset = from; offset < bytes.size() && offset < end; ++offset )
+            {
+                // The lengths of the matches of the pieces so far that start at the offset.
+                std::vector< bool > lengths( longest + 1 );
+                lengths[ 0 ] = true;
+
+                for ( const auto& piece : pieces )
+                {
+                    std::vector< bool > next( longest + 1 );
+
+                    for ( std::size_t length = 0; length <= longest; ++length )
+                    {
+                        for ( std::size_t count = 0; lengths[ length ]; ++count )
+                        {
+                            const auto at = offset + length + count;
+
+                            if ( count >= piece.low )
+                                next[ length + count ] = true;
+
+                            if ( count == piece.high || at == bytes.size() || !piece.set.contains( bytes[ at ] ) )
+                                break;
+                        }
+                    }
+
+                    lengths = std::move( next );
+                }
+
+                for ( std::size_t length = 1; length <= longest; ++length )
+                {
+                    if ( lengths[ length ] && offset + length < end )
+                    {
+                        end = offset + length;
+                        start = offset;
+                        break;
+                    }
+                }
+            }
+
+            if ( end > bytes.size() )
+                break;
+
+            results.push_back( { start, end - start } );
+            from = end;
+        }
+
+        return results;
+    }
+
+    void usage()
+    {
+        std::cout << "usage: bench [--size <MiB>] [--seed <n>] [--csv] [pe files...]\n"
+                     "  Runs every scanner algorithm over random, code-like and zero-heavy data, plus any files given, sweeping the\n"
+                     "  pattern length and wildcard ratio. Reports GB/s, first-hit latency and agreement with naive. Then searches for\n"
+                     "  a signature set, resolves planted signatures, checks a suffix array and the signatures it generates and an\n"
+                     "  FM-index before and after saving it, and searches for approximate matches, expressions, strings in both\n"
+                     "  encodings and typed values. Extracts printable strings, narrows a scan session, finds the vtables in a heap,\n"
+                     "  maps its pointers, and checks the vectorized kernels against a scalar reference. Exits with 1 if anything\n"
+                     "  disagrees."
+                  << std::endl;
+    }
+}  // namespace
+
+int main( int argc, char** argv )
+{
+    std::size_t size = 8;
+    std::uint64_t seed = 1;
+    bool csv = false;
+    std::vector< std::string > files;
+
+    for ( int i = 1; i < argc; ++i )
+    {
+        const std::string_view arg = argv[ i ];
+
+        if ( arg == "--size" && i + 1 < argc )
+            size = std::stoull( argv[ ++i ] );
+        else if ( arg == "--seed" && i + 1 < argc )
+            seed = std::stoull( argv[ ++i ] );
+        else if ( arg == "--csv" )
+            csv = true;
+        else if ( arg == "--help" || arg == "-h" )
+            return usage(), 0;
+        else
+            files.emplace_back( arg );
+    }
+
+    std::mt19937_64 random( seed );
+    std::vector< corpus_t > corpora;
+
+    corpora.push_back( random_corpus( size * 1024 * 1024, random ) );
+    corpora.push_back( code_corpus( size * 1024 * 1024, random ) );
+    corpora.push_back( data_corpus( size * 1024 * 1024, random ) );
+
+    for ( const auto& file : files )
+    {
+        if ( auto corpus = load_corpus( file ); corpus && corpus->bytes.size() > pattern_t::max_size )
+            corpora.push_back( std::move( *corpus ) );
+        else
+            std::cerr << "[-] Skipping " << file << ": it could not be read or is too small." << std::endl;
+    }
+
+    if ( csv )
+        std::cout << "corpus,length,wildcards,algorithm,gbps,first_us,hits,agrees\n";
+    else
+        std::cout << std::left << std::setw( 24 ) << "corpus" << std::right << std::setw( 7 ) << "length" << std::setw( 10 ) << "wildcards"
+                  << std::setw( 10 ) << "algorithm" << std::setw( 10 ) << "GB/s" << std::setw( 12 ) << "first (us)" << std::setw( 10 ) << "hits"
+                  << "  agrees\n";
+
+    bool agree = true;
+
+    for ( const auto& corpus : corpora )
+    {
+        for ( const std::size_t length : { 4, 8, 16, 32, 64 } )
+        {
+            for ( const double wildcards : { 0.0, 0.25, 0.5 } )
+            {
+                const compiled_pattern_t pattern( make_pattern( corpus, length, wildcards, random ) );
+                auto buffer = std::span( const_cast< std::uint8_t* >( corpus.bytes.data() ), corpus.bytes.size() );
+                const auto reference = scanner::find_all< scanner::algorithm_t::naive_t >( buffer, pattern );
+
+                for ( const auto& algorithm : algorithms )
+                {
+                    const auto result = algorithm.run( corpus, pattern, reference );
+                    agree &= result.agrees;
+
+                    if ( csv )
+                        std::cout << corpus.name << ',' << length << ',' << wildcards << ',' << algorithm.name << ',' << result.throughput << ','
+                                  << result.latency << ',' << result.hits << ',' << result.agrees << '\n';
+                    else
+                        std::cout << std::left << std::setw( 24 ) << corpus.name << std::right << std::setw( 7 ) << length << std::setw( 9 )
+                                  << static_cast< int >( wildcards * 100 ) << '%' << std::setw( 10 ) << algorithm.name << std::fixed
+                                  << std::setprecision( 2 ) << std::setw( 10 ) << result.throughput << std::setw( 12 ) << result.latency
+                                  << std::setw( 10 ) << result.hits << "  " << ( result.agrees ? "yes" : "NO" ) << '\n';
+                }
+            }
+        }
+    }
+
+    // A set of patterns from the corpus with and without wildcards, keys that share a prefix or end inside another key, a pattern that never
+    // occurs, patterns without a strict byte, which are scanned outside of the automaton, and an empty pattern, which never matches. The set is checked against every pattern on its
+    // own over the first MiB, since a pattern of wildcards matches everywhere.
+    for ( const auto& corpus : corpora )
+    {
+        auto buffer = std::span( const_cast< std::uint8_t* >( corpus.bytes.data() ), std::min< std::size_t >( corpus.bytes.size(), 1024 * 1024 ) );
+        const auto offset = random() % ( buffer.size() - 16 );
+
+        std::vector< pattern_t > patterns;
+
+        for ( const double wildcards : { 0.0, 0.25, 0.5 } )
+            patterns.push_back( make_pattern( corpus, 8, wildcards, random ) );
+
+        auto shared = pattern_t( buffer.data() + offset, 12 );
+        patterns.push_back( shared );
+
+        shared.atoms[ 8 ].value ^= 0xFF;
+        patterns.push_back( shared );
+        patterns.push_back( pattern_t( buffer.data() + offset, 4 ) );
+        patterns.push_back( pattern_t( buffer.data() + offset + 2, 6 ) );
+        patterns.push_back( pattern_t::parse( "DE AD BE EF DE AD BE EF" ) );
+        patterns.push_back( pattern_t::parse( "4? ? ?8" ) );
+        patterns.push_back( pattern_t::parse( "? ?" ) );
+        patterns.push_back( pattern_t{} );
+
+        const signature_set set( patterns );
+
+        // The first locations are timed, since every location of the pattern of wildcards would only time the sort of the matches.
+        std::vector< std::optional< std::uintptr_t > > first;
+        const auto elapsed = time( [ & ] { first = set.find( buffer ); } );
+        const auto matches = set.find_all( buffer );
+
+        std::vector< signature_set::match_t > reference;
+        auto agrees = true;
+
+        for ( std::size_t id = 0; id < patterns.size(); ++id )
+        {
+            const auto all = scanner::find_all< scanner::algorithm_t::naive_t >( buffer, compiled_pattern_t( patterns[ id ] ) );
+
+            for ( const auto location : all )
+                reference.push_back( { id, location } );
+
+            agrees &= first[ id ] == ( all.empty() ? std::nullopt : std::make_optional( all.front() ) );
+        }
+
+        std::sort(
+            reference.begin(),
+            reference.end(),
+            []( const signature_set::match_t& a, const signature_set::match_t& b ) { return std::tie( a.offset, a.id ) < std::tie( b.offset, b.id ); } );
+
+        agrees &= std::equal(
+            matches.begin(),
+            matches.end(),
+            reference.begin(),
+            reference.end(),
+            []( const signature_set::match_t& a, const signature_set::match_t& b ) { return a.id == b.id && a.offset == b.offset; } );
+
+        agree &= agrees;
+
+        if ( csv )
+            std::cout << corpus.name << ',' << patterns.size() << ",0,set," << static_cast< double >( buffer.size() ) / elapsed << ",0," << matches.size()
+                      << ',' << agrees << '\n';
+        else
+            std::cout << std::left << std::setw( 24 ) << corpus.name << std::right << std::setw( 7 ) << patterns.size() << std::setw( 10 ) << "-"
+                      << std::setw( 10 ) << "set" << std::fixed << std::setprecision( 2 ) << std::setw( 10 ) << static_cast< double >( buffer.size() ) / elapsed
+                      << std::setw( 12 ) << "-" << std::setw( 10 ) << matches.size() << "  " << ( agrees ? "yes" : "NO" ) << '\n';
+    }
+
+    // A module of random bytes with a lea, a call, a forward and a backward short jump, a cmp with an immediate after its operand and three
+    // loads of globals planted in it, each followed by a tag that makes its signature unique. One global points inside the module, one
+    // outside of it to memory the fallback can read, and one to memory it can't. The resolved addresses are checked against where the
+    // instructions were made to point, both through the set and through each signature with a reader.
+    {
+        constexpr std::uintptr_t base = 0x140000000, outside = 0x7FF700001000, unreadable = 0x7FF700003000, pointee = 0x7FF700002000;
+
+        std::vector< std::uint8_t > module( 0x10000 );
+
+        for ( auto& byte : module )
+            byte = static_cast< std::uint8_t >( random() );
+
+        const auto plant = [ & ]( std::size_t at, std::initializer_list< std::uint8_t > bytes ) { std::ranges::copy( bytes, module.begin() + at ); };
+        const auto write = [ & ]< typename T >( std::size_t at, T value ) { std::memcpy( module.data() + at, &value, sizeof( T ) ); };
+
+        // Each operand is relative to the end of its instruction.
+        plant( 0x1000, { 0x48, 0x8D, 0x0D, 0, 0, 0, 0, 0x11, 0x11, 0x11, 0x11 } );
+        write( 0x1003, std::int32_t( 0x8000 - 0x1007 ) );
+        plant( 0x1100, { 0xE8, 0, 0, 0, 0, 0x22, 0x22, 0x22, 0x22 } );
+        write( 0x1101, std::int32_t( 0x9000 - 0x1105 ) );
+        plant( 0x1200, { 0xEB, 0x40, 0x33, 0x33, 0x33, 0x33 } );
+        plant( 0x1300, { 0xEB, 0xF0, 0x34, 0x34, 0x34, 0x34 } );
+        plant( 0x1400, { 0x80, 0x3D, 0, 0, 0, 0, 0x05, 0x44, 0x44, 0x44, 0x44 } );
+        write( 0x1402, std::int32_t( 0xA000 - 0x1407 ) );
+
+        // mov rax, [rip+rel32] with its tag and the global it loads.
+        const std::tuple< std::size_t, std::uint8_t, std::size_t > loads[] = {
+            { 0x1500, 0x55, 0xB000 },
+            { 0x1600, 0x66, 0xB008 },
+            { 0x1700, 0x77, 0xB010 },
+        };
+
+        for ( const auto& [ at, tag, global ] : loads )
+        {
+            plant( at, { 0x48, 0x8B, 0x05, 0, 0, 0, 0, tag, tag, 0x5A, 0x5A } );
+            write( at + 3, std::int32_t( global - ( at + 7 ) ) );
+        }
+
+        write( 0xB000, std::uint64_t( base + 0xC000 ) );
+        write( 0xB008, std::uint64_t( outside ) );
+        write( 0xB010, std::uint64_t( unreadable ) );
+
+        const auto fallback = [ & ]( std::uintptr_t address, std::span< std::uint8_t > out )
+        {
+            if ( address != outside || out.size() != sizeof( std::uint64_t ) )
+                return false;
+
+            const std::uint64_t value = pointee;
+            std::memcpy( out.data(), &value, sizeof( value ) );
+            return true;
+        };
+
+        const std::vector< signature_t > signatures = {
+            signature_t( pattern_t::parse( "48 8D 0D ? ? ? ? 11 11 11 11" ) ).capture( 3 ).rel32(),
+            signature_t( pattern_t::parse( "E8 ? ? ? ? 22 22 22 22" ) ).capture( 1 ).rel32(),
+            signature_t( pattern_t::parse( "EB ? 33 33 33 33" ) ).capture( 1 ).rel8(),
+            signature_t( pattern_t::parse( "EB ? 34 34 34 34" ) ).capture( 1 ).rel8(),
+            signature_t( pattern_t::parse( "80 3D ? ? ? ? 05 44 44 44 44" ) ).capture( 2 ).rel32( 1 ),
+            signature_t( pattern_t::parse( "48 8B 05 ? ? ? ? 55 55 5A 5A" ) ).capture( 3 ).rel32().deref().add( 0x10 ),
+            signature_t( pattern_t::parse( "48 8B 05 ? ? ? ? 66 66 5A 5A" ) ).capture( 3 ).rel32().deref().deref(),
+            signature_t( pattern_t::parse( "48 8B 05 ? ? ? ? 77 77 5A 5A" ) ).capture( 3 ).rel32().deref().deref(),
+            signature_t( pattern_t::parse( "DE AD BE EF 99 99 99 99" ) ),
+        };
+
+        const std::vector< std::optional< std::uintptr_t > > expected = {
+            base + 0x8000, base + 0x9000, base + 0x1202 + 0x40, base + 0x1302 - 0x10, base + 0xA000,
+            base + 0xC010, pointee,       std::nullopt,         std::nullopt,
+        };
+
+        const signature_set set( signatures );
+        auto buffer = std::span( module.data(), module.size() );
+
+        std::vector< std::optional< std::uintptr_t > > resolved;
+        const auto elapsed = time( [ & ] { resolved = set.resolve( buffer, base, fallback ); } );
+
+        auto agrees = resolved == expected;
+
+        // The same through the reader of each signature, which reads the module like any other memory.
+        const auto reader = [ & ]( std::uintptr_t address, std::span< std::uint8_t > out )
+        {
+            if ( address < base || address - base + out.size() > module.size() )
+                return fallback( address, out );
+
+            std::memcpy( out.data(), module.data() + ( address - base ), out.size() );
+            return true;
+        };
+
+        const auto locations = set.find( buffer );
+
+        for ( std::size_t id = 0; id < signatures.size(); ++id )
+            agrees &= ( locations[ id ] ? signatures[ id ].resolve( base + *locations[ id ], reader ) : std::nullopt ) == expected[ id ];
+
+        // Without a fallback, the pointer outside of the module can't be followed.
+        agrees &= !set.resolve( buffer, base )[ 6 ];
+
+        agree &= agrees;
+
+        const auto count = std::ranges::count_if( resolved, []( const auto& address ) { return address.has_value(); } );
+
+        if ( csv )
+            std::cout << "module," << signatures.size() << ",0,resolve," << static_cast< double >( module.size() ) / elapsed << ",0," << count << ','
+                      << agrees << '\n';
+        else
+            std::cout << std::left << std::setw( 24 ) << "module" << std::right << std::setw( 7 ) << signatures.size() << std::setw( 10 ) << 0
+                      << std::setw( 10 ) << "resolve" << std::fixed << std::setprecision( 2 ) << std::setw( 10 )
+                      << static_cast< double >( module.size() ) / elapsed << std::setw( 12 ) << "-" << std::setw( 10 ) << count << "  "
+                      << ( agrees ? "yes" : "NO" ) << '\n';
+    }
+
+    // The suffix array of the first MiB of each corpus, checked to hold every suffix once and in order. Patterns from the corpus are located
+    // through it and checked against a scan, and signatures generated at random offsets are checked to match only there and to match
+    // elsewhere too once their last byte is dropped.
+    for ( const auto& corpus : corpora )
+    {
+        const auto text = std::span( corpus.bytes.data(), std::min< std::size_t >( corpus.bytes.size(), 1024 * 1024 ) );
+        auto buffer = std::span( const_cast< std::uint8_t* >( text.data() ), text.size() );
+
+        suffix_array_t index;
+        const auto elapsed = time( [ & ] { index = suffix_array_t( std::vector< std::uint8_t >( text.begin(), text.end() ) ); } );
+
+        const auto suffixes = index.suffixes();
+        std::vector< bool > seen( text.size() );
+        auto agrees = suffixes.size() == text.size();
+
+        for ( std::size_t i = 0; agrees && i < suffixes.size(); ++i )
+        {
+            agrees = suffixes[ i ] < text.size() && !seen[ suffixes[ i ] ];
+
+            if ( agrees && i > 0 )
+                agrees = std::ranges::lexicographical_compare( text.subspan( suffixes[ i - 1 ] ), text.subspan( suffixes[ i ] ) );
+
+            if ( agrees )
+                seen[ suffixes[ i ] ] = true;
+        }
+
+        agree &= agrees;
+
+        const auto report = [ & ]( std::size_t length, std::string_view algorithm, double throughput, std::size_t hits, bool agrees )
+        {
+            if ( csv )
+                std::cout << corpus.name << ',' << length << ",0," << algorithm << ',' << throughput << ",0," << hits << ',' << agrees << '\n';
+            else
+                std::cout << std::left << std::setw( 24 ) << corpus.name << std::right << std::setw( 7 ) << length << std::setw( 10 ) << "-"
+                          << std::setw( 10 ) << algorithm << std::fixed << std::setprecision( 2 ) << std::setw( 10 ) << throughput << std::setw( 12 )
+                          << "-" << std::setw( 10 ) << hits << "  " << ( agrees ? "yes" : "NO" ) << '\n';
+        };
+
+        report( 0, "suffixes", static_cast< double >( text.size() ) / elapsed, suffixes.size(), agrees );
+
+        for ( const std::size_t length : { 8, 16, 32 } )
+        {
+            const auto pattern = make_pattern( corpus, length, 0.25, random );
+
+            std::vector< std::uintptr_t > matches;
+            const auto elapsed = time( [ & ] { matches = index.locate( pattern ); } );
+
+            const auto reference = scanner::find_all< scanner::algorithm_t::naive_t >( buffer, compiled_pattern_t( pattern ) );
+            const auto agrees = matches == reference && index.count( pattern ) == reference.size();
+
+            agree &= agrees;
+            report( length, "locate", static_cast< double >( text.size() ) / elapsed, matches.size(), agrees );
+        }
+
+        // Offsets without a unique window of `pattern_t::max_size` bytes get no signature, which isn't checked.
+        std::vector< std::size_t > offsets( 256 );
+
+        for ( auto& offset : offsets )
+            offset = random() % text.size();
+
+        std::vector< std::optional< pattern_t > > signatures;
+        const auto generating = time(
+            [ & ]
+            {
+                signatures.clear();
+
+                for ( const auto offset : offsets )
+                    signatures.push_back( generate_signature( index, offset ) );
+            } );
+
+        std::size_t generated = 0;
+        std::size_t longest = 0;
+        agrees = true;
+
+        for ( std::size_t i = 0; i < offsets.size(); ++i )
+        {
+            if ( !signatures[ i ] )
+                continue;
+
+            auto pattern = *signatures[ i ];
+
+            ++generated;
+            longest = std::max( longest, pattern.size );
+            agrees &= scanner::find_all< scanner::algorithm_t::auto_t >( buffer, pattern ) == std::vector< std::uintptr_t >{ offsets[ i ] };
+
+            if ( pattern.size > 1 )
+            {
+                --pattern.size;
+                agrees &= scanner::find_all< scanner::algorithm_t::auto_t >( buffer, pattern ).size() > 1;
+            }
+        }
+
+        // Reported as the throughput of scanning for each signature, which is what the suffix array replaces.
+        agree &= agrees;
+        report( longest, "generate", static_cast< double >( offsets.size() ) * text.size() / generating, generated, agrees );
+    }
+
+    // The FM-index of the first MiB of each corpus, with patterns from the corpus, patterns whose strict bytes occur at either end of the image
+    // with wildcards that do or don't fit around them, and a pattern of only wildcards. Counting and locating are checked against a scan,
+    // both on the built index and on the same index saved and loaded again.
+    for ( const auto& corpus : corpora )
+    {
+        const auto text = std::span( corpus.bytes.data(), std::min< std::size_t >( corpus.bytes.size(), 1024 * 1024 ) );
+        auto buffer = std::span( const_cast< std::uint8_t* >( text.data() ), text.size() );
+
+        image_index index;
+        const auto elapsed = time( [ & ] { index = image_index( text ); } );
+
+        const auto path = std::filesystem::temp_directory_path() / "wincpp_bench.index";
+        const image_fingerprint_t fingerprint{ 1, static_cast< std::uint32_t >( text.size() ) };
+
+        // The file is only found again under the fingerprint it was saved with.
+        const auto loaded = index.save( path, fingerprint ) ? image_index::load( path, fingerprint ) : std::nullopt;
+        auto agrees = loaded && loaded->size() == index.size() && !image_index::load( path, { 2, fingerprint.size_of_image } );
+
+        std::error_code ec;
+        std::filesystem::remove( path, ec );
+
+        agree &= agrees;
+
+        const auto report = [ & ]( std::size_t length, std::string_view algorithm, double throughput, std::size_t hits, bool agrees )
+        {
+            if ( csv )
+                std::cout << corpus.name << ',' << length << ",0," << algorithm << ',' << throughput << ",0," << hits << ',' << agrees << '\n';
+            else
+                std::cout << std::left << std::setw( 24 ) << corpus.name << std::right << std::setw( 7 ) << length << std::setw( 10 ) << "-"
+                          << std::setw( 10 ) << algorithm << std::fixed << std::setprecision( 2 ) << std::setw( 10 ) << throughput << std::setw( 12 )
+                          << "-" << std::setw( 10 ) << hits << "  " << ( agrees ? "yes" : "NO" ) << '\n';
+        };
+
+        report( 0, "fm-index", static_cast< double >( text.size() ) / elapsed, index.memory_usage(), agrees );
+
+        const auto edge = [ & ]( std::size_t offset, std::size_t leading, std::size_t trailing )
+        {
+            pattern_t pattern;
+            pattern.size = leading + 8 + trailing;
+
+            for ( std::size_t i = 0; i < 8; ++i )
+                pattern.atoms[ leading + i ] = atom_t{ text[ offset + i ], 0xFF };
+
+            return pattern;
+        };
+
+        const auto end = text.size() - 8;
+
+        const pattern_t patterns[] = {
+            make_pattern( corpus, 8, 0.25, random ),
+            make_pattern( corpus, 16, 0.25, random ),
+            make_pattern( corpus, 32, 0.0, random ),
+            edge( 0, 3, 1 ),
+            edge( 2, 2, 0 ),
+            edge( end, 1, 2 ),
+            edge( end - 2, 0, 2 ),
+            pattern_t::parse( "? ? ? ?" ),
+        };
+
+        for ( const auto& pattern : patterns )
+        {
+            std::vector< std::uintptr_t > matches;
+            const auto elapsed = time( [ & ] { matches = index.locate( pattern ); } );
+
+            const auto reference = scanner::find_all< scanner::algorithm_t::naive_t >( buffer, compiled_pattern_t( pattern ) );
+            auto agrees = matches == reference && index.count( pattern ) == reference.size() &&
+                          index.count( pattern, 2 ) == std::min< std::size_t >( reference.size(), 2 );
+
+            if ( loaded )
+                agrees &= loaded->locate( pattern ) == reference && loaded->count( pattern ) == reference.size();
+
+            agree &= agrees;
+            report( pattern.size, "index", static_cast< double >( text.size() ) / elapsed, matches.size(), agrees );
+        }
+    }
+
+    // A module name, a run of letters like those in the data corpus, and a single letter whose every hit needs verifying.
+    for ( const auto& corpus : corpora )
+    {
+        for ( const std::string_view text : { std::string_view( "Kernel32.dll" ), std::string_view( "abcdefgh" ), std::string_view( "e" ) } )
+        {
+            auto buffer = std::span( const_cast< std::uint8_t* >( corpus.bytes.data() ), corpus.bytes.size() );
+
+            std::vector< string_match_t > matches;
+            const auto elapsed = time( [ & ] { matches = scanner::find_all_strings( buffer, text ); } );
+
+            const auto reference = reference_strings( corpus, text );
+            const auto agrees = std::equal(
+                matches.begin(),
+                matches.end(),
+                reference.begin(),
+                reference.end(),
+                []( const string_match_t& a, const string_match_t& b ) { return a.offset == b.offset && a.encoding == b.encoding; } );
+
+            agree &= agrees;
+
+            if ( csv )
+                std::cout << corpus.name << ',' << text.size() << ",0,string," << static_cast< double >( buffer.size() ) / elapsed << ",0,"
+                          << matches.size() << ',' << agrees << '\n';
+            else
+                std::cout << std::left << std::setw( 24 ) << corpus.name << std::right << std::setw( 7 ) << text.size() << std::setw( 10 ) << "-"
+                          << std::setw( 10 ) << "string" << std::fixed << std::setprecision( 2 ) << std::setw( 10 )
+                          << static_cast< double >( buffer.size() ) / elapsed << std::setw( 12 ) << "-" << std::setw( 10 ) << matches.size()
+                          << "  " << ( agrees ? "yes" : "NO" ) << '\n';
+        }
+    }
+
+    // Every run of four or more characters in each corpus, then a buffer of ASCII and UTF-16LE words at both parities between random bytes,
+    // which ends inside a UTF-16LE word. It is also cut a byte short, so its last character loses the zero that makes it wide.
+    {
+        corpus_t text{ "strings", {} };
+
+        while ( text.bytes.size() < size * 1024 * 1024 )
+        {
+            const auto length = 1 + random() % 40;
+
+            switch ( random() % 3 )
+            {
+                case 0:
+                    for ( std::size_t i = 0; i < length; ++i )
+                        text.bytes.push_back( random() % 16 == 0 ? '\t' : static_cast< std::uint8_t >( 0x20 + random() % 0x5F ) );
+                    break;
+                case 1:
+                    for ( std::size_t i = 0; i < length; ++i )
+                        text.bytes.insert( text.bytes.end(), { static_cast< std::uint8_t >( 0x20 + random() % 0x5F ), 0x00 } );
+                    break;
+                default:
+                    for ( std::size_t i = 0; i < length % 16; ++i )
+                        text.bytes.push_back( static_cast< std::uint8_t >( random() ) );
+                    break;
+            }
+        }
+
+        for ( const auto character : std::string_view( "Kernel32.dll" ) )
+            text.bytes.insert( text.bytes.end(), { static_cast< std::uint8_t >( character ), 0x00 } );
+
+        corpus_t cut{ "strings (cut)", std::vector< std::uint8_t >( text.bytes.begin(), text.bytes.end() - 1 ) };
+
+        const auto both = string_encoding_t::both_t, ascii = string_encoding_t::ascii_nocase_t, wide = string_encoding_t::utf16le_t;
+
+        std::vector< std::tuple< const corpus_t*, std::size_t, string_encoding_t > > cases;
+
+        for ( const auto& corpus : corpora )
+            cases.emplace_back( &corpus, 4, both );
+
+        cases.insert( cases.end(), { { &text, 4, both }, { &text, 2, ascii }, { &text, 16, wide }, { &cut, 4, both }, { &cut, 12, wide } } );
+
+        for ( const auto& [ corpus, min_length, encoding ] : cases )
+        {
+            std::vector< extracted_string_t > matches;
+            const auto elapsed = time( [ &, corpus = corpus, min_length = min_length, encoding = encoding ]
+                                       { matches = extract_strings( corpus->bytes, min_length, encoding ); } );
+
+            const auto reference = reference_extract( corpus->bytes, min_length, encoding );
+            const auto agrees = std::equal(
+                matches.begin(),
+                matches.end(),
+                reference.begin(),
+                reference.end(),
+                []( const extracted_string_t& a, const extracted_string_t& b )
+                { return a.offset == b.offset && a.encoding == b.encoding && a.text == b.text; } );
+
+            agree &= agrees;
+
+            if ( csv )
+                std::cout << corpus->name << ',' << min_length << ',' << static_cast< int >( encoding ) << ",extract,"
+                          << static_cast< double >( corpus->bytes.size() ) / elapsed << ",0," << matches.size() << ',' << agrees << '\n';
+            else
+                std::cout << std::left << std::setw( 24 ) << corpus->name << std::right << std::setw( 7 ) << min_length << std::setw( 10 )
+                          << static_cast< int >( encoding ) << std::setw( 10 ) << "extract" << std::fixed << std::setprecision( 2 ) << std::setw( 10 )
+                          << static_cast< double >( corpus->bytes.size() ) / elapsed << std::setw( 12 ) << "-" << std::setw( 10 ) << matches.size()
+                          << "  " << ( agrees ? "yes" : "NO" ) << '\n';
+        }
+    }
+
+    // A signature from the corpus with a few bytes changed, as after an update, the same with a byte class, and budgets up to
+    // and past the number of strict positions, where nearly every location is a match and only the limit bounds the results.
+    for ( const auto& corpus : corpora )
+    {
+        const auto offset = random() % ( corpus.bytes.size() - 16 );
+
+        auto changed = pattern_t( corpus.bytes.data() + offset, 16 );
+        changed.atoms[ 3 ].value ^= 0x01;
+        changed.atoms[ 9 ].value ^= 0x80;
+        changed.atoms[ 5 ] = atom_t{};
+
+        auto classes = changed;
+        classes.classes[ 0 ].position = 12;
+        classes.classes[ 0 ].insert( corpus.bytes[ offset + 12 ] ^ 0x10 );
+        classes.classes[ 0 ].insert( corpus.bytes[ offset + 12 ] ^ 0x20 );
+        classes.class_count = 1;
+
+        const auto sparse = pattern_t::parse( "00 ? ? 01 ? ? ? 02" );
+
+        const auto all = std::numeric_limits< std::size_t >::max();
+
+        const std::tuple< const pattern_t*, std::size_t, std::size_t > cases[] = {
+            { &changed, 2, all }, { &changed, 4, 100 }, { &classes, 3, all }, { &sparse, 2, 1000 }, { &sparse, 3, 1000 }, { &sparse, 8, 1000 },
+        };
+
+        for ( const auto& [ pattern, k, limit ] : cases )
+        {
+            auto buffer = std::span( const_cast< std::uint8_t* >( corpus.bytes.data() ), corpus.bytes.size() );
+
+            std::vector< approx_match_t > matches;
+            const auto elapsed = time( [ &, pattern = pattern, k = k, limit = limit ] { matches = scanner::find_approx( buffer, *pattern, k, limit ); } );
+
+            const auto reference = reference_approx( corpus, *pattern, k, limit );
+            const auto agrees = std::equal(
+                matches.begin(),
+                matches.end(),
+                reference.begin(),
+                reference.end(),
+                []( const approx_match_t& a, const approx_match_t& b ) { return a.offset == b.offset && a.distance == b.distance; } );
+
+            agree &= agrees;
+
+            if ( csv )
+                std::cout << corpus.name << ',' << pattern->size << ',' << k << ",approx," << static_cast< double >( buffer.size() ) / elapsed << ",0,"
+                          << matches.size() << ',' << agrees << '\n';
+            else
+                std::cout << std::left << std::setw( 24 ) << corpus.name << std::right << std::setw( 7 ) << pattern->size << std::setw( 10 ) << k
+                          << std::setw( 10 ) << "approx" << std::fixed << std::setprecision( 2 ) << std::setw( 10 )
+                          << static_cast< double >( buffer.size() ) / elapsed << std::setw( 12 ) << "-" << std::setw( 10 ) << matches.size() << "  "
+                          << ( agrees ? "yes" : "NO" ) << '\n';
+        }
+    }
+
+    // A gap between two bytes, a call followed by a test within the next 16 bytes and a choice of prefix, checked against every start before the
+    // earliest end. Then a gap on bytes that are mostly 00 or 01, where the DFA has a state for every mix of 01s in the gap and the cache of
+    // states is flushed many times over.
+    {
+        const auto piece = []( std::initializer_list< std::uint8_t > values, std::size_t low = 1, std::size_t high = 1 )
+        {
+            piece_t result{ {}, low, high };
+
+            for ( const auto value : values )
+                result.set.insert( value );
+
+            return result;
+        };
+
+        const auto gap = [ & ]( std::size_t low, std::size_t high )
+        {
+            piece_t result{ {}, low, high };
+
+            for ( std::size_t byte = 0; byte < 256; ++byte )
+                result.set.insert( static_cast< std::uint8_t >( byte ) );
+
+            return result;
+        };
+
+        corpus_t bits{ "bits", std::vector< std::uint8_t >( 256 * 1024 ) };
+
+        for ( auto& byte : bits.bytes )
+            byte = random() % 64 == 0 ? 0x02 : random() % 2;
+
+        const std::vector< std::tuple< const corpus_t*, std::string_view, std::vector< piece_t > > > cases = {
+            { &corpora[ 0 ], "00 ?{2,8} 01", { piece( { 0x00 } ), gap( 2, 8 ), piece( { 0x01 } ) } },
+            { &corpora[ 1 ],
+              "E8 ? ? ? ? ?{0,16} 48 85 C0",
+              { piece( { 0xE8 } ), gap( 4, 20 ), piece( { 0x48 } ), piece( { 0x85 } ), piece( { 0xC0 } ) } },
+            { &corpora[ 1 ], "[48|4C] 8B ?{1,3} 24", { piece( { 0x48, 0x4C } ), piece( { 0x8B } ), gap( 1, 3 ), piece( { 0x24 } ) } },
+            { &corpora[ 2 ], "00{2,8} ?{0,4} 00{0,6} 01", { piece( { 0x00 }, 2, 8 ), gap( 0, 4 ), piece( { 0x00 }, 0, 6 ), piece( { 0x01 } ) } },
+            { &bits, "01 ?{12} 02", { piece( { 0x01 } ), gap( 12, 12 ), piece( { 0x02 } ) } },
+        };
+
+        for ( const auto& [ corpus, text, pieces ] : cases )
+        {
+            const regex_t regex( text );
+            auto buffer = std::span( const_cast< std::uint8_t* >( corpus->bytes.data() ), corpus->bytes.size() );
+
+            std::vector< regex_t::match_t > matches;
+            const auto elapsed = time( [ &, regex = &regex ] { matches = regex->find_all( buffer ); } );
+
+            const auto reference = reference_regex( corpus->bytes, pieces );
+            const auto agrees = std::equal(
+                matches.begin(),
+                matches.end(),
+                reference.begin(),
+                reference.end(),
+                []( const regex_t::match_t& a, const regex_t::match_t& b ) { return a.offset == b.offset && a.size == b.size; } );
+
+            agree &= agrees;
+
+            if ( csv )
+                std::cout << corpus->name << ',' << regex.max_size() << ",0,regex," << static_cast< double >( buffer.size() ) / elapsed << ",0,"
+                          << matches.size() << ',' << agrees << '\n';
+            else
+                std::cout << std::left << std::setw( 24 ) << corpus->name << std::right << std::setw( 7 ) << regex.max_size() << std::setw( 10 )
+                          << "-" << std::setw( 10 ) << "regex" << std::fixed << std::setprecision( 2 ) << std::setw( 10 )
+                          << static_cast< double >( buffer.size() ) / elapsed << std::setw( 12 ) << "-" << std::setw( 10 ) << matches.size() << "  "
+                          << ( agrees ? "yes" : "NO" ) << '\n';
+        }
+    }
+
+    // An exact 32-bit integer, the same unaligned, a small range of bytes, a float with a tolerance and a range of 64-bit integers.
+    for ( const auto& corpus : corpora )
+    {
+        const auto check = [ & ]< typename T >( const char* name, T low, T high, std::size_t alignment )
+        {
+            const auto query = value_query_t::between( low, high, alignment );
+
+            std::vector< std::uintptr_t > matches;
+            const auto elapsed = time( [ & ] { matches = find_values( corpus.bytes, query ); } );
+            const auto agrees = matches == reference_values( corpus, low, high, alignment );
+
+            agree &= agrees;
+
+            if ( csv )
+                std::cout << corpus.name << ',' << sizeof( T ) << ',' << alignment << ',' << name << ','
+                          << static_cast< double >( corpus.bytes.size() ) / elapsed << ",0," << matches.size() << ',' << agrees << '\n';
+            else
+                std::cout << std::left << std::setw( 24 ) << corpus.name << std::right << std::setw( 7 ) << sizeof( T ) << std::setw( 10 ) << alignment
+                          << std::setw( 10 ) << name << std::fixed << std::setprecision( 2 ) << std::setw( 10 )
+                          << static_cast< double >( corpus.bytes.size() ) / elapsed << std::setw( 12 ) << "-" << std::setw( 10 ) << matches.size()
+                          << "  " << ( agrees ? "yes" : "NO" ) << '\n';
+        };
+
+        check( "i32", std::int32_t( 100 ), std::int32_t( 100 ), 4 );
+        check( "i32", std::int32_t( 100 ), std::int32_t( 100 ), 1 );
+        check( "u8", std::uint8_t( 0x40 ), std::uint8_t( 0x5F ), 1 );
+        check( "f32", 0.99f, 1.01f, 4 );
+        check( "i64", std::int64_t( -4096 ), std::int64_t( 4096 ), 8 );
+    }
+
+    // A session over the bytes below 0x80 and one over every aligned 32-bit value from a snapshot, narrowed to the values that stay the same
+    // after every seventh byte is bumped. The pass is timed, and the candidates are checked against the same narrowing of a list of addresses.
+    for ( const auto& corpus : corpora )
+    {
+        auto memory = corpus.bytes;
+
+        const auto reader = [ & ]( std::uintptr_t address, std::size_t size, std::uint8_t* buffer )
+        {
+            std::memcpy( buffer, memory.data() + address, size );
+            return true;
+        };
+
+        const scan_session::range_t range{ 0, memory.size() };
+
+        scan_session known( reader, { &range, 1 }, value_query_t::between< std::uint8_t >( 0, 0x7F, 1 ) );
+        scan_session unknown( reader, { &range, 1 }, value_type_t::u32_t, 4 );
+
+        auto expected_known = reference_values( corpus, std::uint8_t( 0 ), std::uint8_t( 0x7F ), 1 );
+        std::vector< std::uintptr_t > expected_unknown;
+
+        for ( std::size_t i = 0; i + 4 <= memory.size(); i += 4 )
+            expected_unknown.push_back( i );
+
+        for ( std::size_t i = 0; i < memory.size(); i += 7 )
+            ++memory[ i ];
+
+        std::erase_if( expected_known, []( std::uintptr_t address ) { return address % 7 == 0; } );
+        std::erase_if( expected_unknown, []( std::uintptr_t address ) { return address % 7 == 0 || address % 7 > 3; } );
+
+        const auto sessions = { std::tuple{ &known, &expected_known, 1, "session" }, std::tuple{ &unknown, &expected_unknown, 4, "unknown" } };
+
+        for ( auto [ session, expected, size, name ] : sessions )
+        {
+            const auto elapsed = time( [ & ] { session->next( value_change_t::unchanged_t ); } );
+            const auto agrees = session->addresses() == *expected;
+
+            agree &= agrees;
+
+            if ( csv )
+                std::cout << corpus.name << ',' << size << ',' << size << ',' << name << ',' << static_cast< double >( memory.size() ) / elapsed << ",0,"
+                          << session->count() << ',' << agrees << '\n';
+            else
+                std::cout << std::left << std::setw( 24 ) << corpus.name << std::right << std::setw( 7 ) << size << std::setw( 10 ) << size
+                          << std::setw( 10 ) << name << std::fixed << std::setprecision( 2 ) << std::setw( 10 )
+                          << static_cast< double >( memory.size() ) / elapsed << std::setw( 12 ) << "-" << std::setw( 10 ) << session->count() << "  "
+                          << ( agrees ? "yes" : "NO" ) << '\n';
+        }
+    }
+
+    // A heap of small integers and pointers with the vtables of a few classes planted in it, like the objects of a game. Finding one vtable
+    // and the whole set are timed, and both are checked against a naive walk over the aligned slots.
+    {
+        std::vector< std::uint8_t > memory( size * 1024 * 1024 );
+        std::vector< std::uint64_t > vtables( 16 );
+
+        for ( auto& vtable : vtables )
+            vtable = 0x7ff600000000 + ( random() % 0x100000 ) * 8;
+
+        for ( std::size_t i = 0; i < memory.size(); i += 8 )
+        {
+            const std::uint64_t value = random() % 64 ? ( random() % 2 ? random() % 0x1000 : 0x20000000 + random() % 0x10000000 )
+                                                      : vtables[ random() % vtables.size() ];
+            std::memcpy( memory.data() + i, &value, 8 );
+        }
+
+        const lane_set set( vtables );
+
+        std::vector< std::uintptr_t > expected_one, expected_set;
+
+        for ( std::size_t i = 0; i < memory.size(); i += 8 )
+        {
+            std::uint64_t value;
+            std::memcpy( &value, memory.data() + i, 8 );
+
+            if ( value == vtables.front() )
+                expected_one.push_back( i );
+
+            if ( std::ranges::find( vtables, value ) != vtables.end() )
+                expected_set.push_back( i );
+        }
+
+        using offsets_t = std::vector< std::uintptr_t >;
+
+        const auto report = [ & ]( const char* name, const offsets_t& found, const offsets_t& expected, double elapsed )
+        {
+            const auto agrees = found == expected;
+            agree &= agrees;
+
+            if ( csv )
+                std::cout << "heap,8,0," << name << ',' << static_cast< double >( memory.size() ) / elapsed << ",0," << found.size() << ',' << agrees
+                          << '\n';
+            else
+                std::cout << std::left << std::setw( 24 ) << "heap" << std::right << std::setw( 7 ) << 8 << std::setw( 10 ) << 0 << std::setw( 10 )
+                          << name << std::fixed << std::setprecision( 2 ) << std::setw( 10 ) << static_cast< double >( memory.size() ) / elapsed
+                          << std::setw( 12 ) << "-" << std::setw( 10 ) << found.size() << "  " << ( agrees ? "yes" : "NO" ) << '\n';
+        };
+
+        offsets_t found;
+
+        auto elapsed = time( [ & ] { found = find_lanes( memory, vtables.front() ); } );
+        report( "lanes", found, expected_one, elapsed );
+
+        elapsed = time( [ & ] { found = find_lanes( memory, set ); } );
+        report( "lane set", found, expected_set, elapsed );
+    }
+
+    // A heap where a quarter of the slots point into it and an image that points into it, with a chain planted from the image to a target.
+    // Mapping the pointers is timed, and every path found is walked through the memory to check that it leads to the target.
+    {
+        constexpr std::uintptr_t image = 0x400000, heap = 0x10000000;
+
+        std::vector< std::uint8_t > memory( size * 1024 * 1024 ), module( 0x10000 );
+
+        for ( auto* bytes : { &memory, &module } )
+        {
+            for ( std::size_t i = 0; i < bytes->size(); i += 8 )
+            {
+                const std::uint64_t value = random() % 4 ? random() % 0x1000 : heap + random() % memory.size();
+                std::memcpy( bytes->data() + i, &value, 8 );
+            }
+        }
+
+        const auto target = heap + 0x2000;
+        const std::uint64_t first = heap + 0x1000, second = target - 0x40;
+
+        std::memcpy( module.data() + 0x100, &first, 8 );
+        std::memcpy( memory.data() + 0x1018, &second, 8 );
+
+        const auto reader = [ & ]( std::uintptr_t address, std::size_t size, std::uint8_t* buffer )
+        {
+            const auto& bytes = address >= heap ? memory : module;
+            const auto base = address >= heap ? heap : image;
+
+            if ( address < base || address - base + size > bytes.size() )
+                return false;
+
+            std::memcpy( buffer, bytes.data() + ( address - base ), size );
+            return true;
+        };
+
+        const pointer_map::range_t ranges[] = { { image, module.size() }, { heap, memory.size() } };
+
+        pointer_map map;
+
+        const auto elapsed = time( [ & ] { map = pointer_map( reader, ranges, { { "image", image, module.size() } } ); } );
+        const auto paths = map.find_paths( target, { 4, 0x100 } );
+
+        auto agrees = std::ranges::any_of(
+            paths,
+            []( const pointer_path_t& path ) { return path.depth == 2 && path.offset == 0x100 && path.offsets[ 0 ] == 0x18 && path.offsets[ 1 ] == 0x40; } );
+
+        for ( const auto& path : paths )
+        {
+            std::uintptr_t address = image + path.offset;
+
+            for ( const auto offset : path.used() )
+            {
+                std::uint64_t value = 0;
+                agrees &= reader( address, 8, reinterpret_cast< std::uint8_t* >( &value ) );
+                address = value + offset;
+            }
+
+            agrees &= address == target;
+        }
+
+        agree &= agrees;
+
+        const auto throughput = static_cast< double >( memory.size() + module.size() ) / elapsed;
+
+        if ( csv )
+            std::cout << "heap,8,8,pointers," << throughput << ",0," << paths.size() << ',' << agrees << '\n';
+        else
+            std::cout << std::left << std::setw( 24 ) << "heap" << std::right << std::setw( 7 ) << 8 << std::setw( 10 ) << 8 << std::setw( 10 )
+                      << "pointers" << std::fixed << std::setprecision( 2 ) << std::setw( 10 ) << throughput << std::setw( 12 ) << "-" << std::setw( 10 )
+                      << paths.size() << "  " << ( agrees ? "yes" : "NO" ) << '\n';
+    }
+
+    std::cout << std::flush;
+
+    if ( !agree )
+    {
+        std::cerr << "[-] Some algorithms disagree with their reference." << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdint>
+
+#if defined( _M_X64 ) || defined( _M_IX86 ) || defined( __x86_64__ ) || defined( __i386__ )
+#define WINCPP_X86
+#endif
+
+// MSVC exposes every intrinsic regardless of the compiler flags, while GCC and Clang need the instruction set enabled per function.
+#if defined( _MSC_VER ) && !defined( __clang__ )
+#define WINCPP_TARGET( isa )
+#else
+#define WINCPP_TARGET( isa ) __attribute__( ( target( isa ) ) )
+#endif
+
+namespace wincpp::core
+{
+    /// <summary>
+    /// The widest vector instruction set that can be used on the current CPU.
+    /// </summary>
+    enum class simd_level_t : std::uint8_t
+    {
+        /// <summary>
+        /// No vector instructions are available.
+        /// </summary>
+        scalar_t,
+
+        /// <summary>
+        /// 128-bit SSE2 instructions are available.
+        /// </summary>
+        sse2_t,
+
+        /// <summary>
+        /// 256-bit AVX2 instructions are available and enabled by the operating system.
+        /// </summary>
+        avx2_t,
+
+        /// <summary>
+        /// 512-bit AVX-512 (F and BW) instructions are available and enabled by the operating system.
+        /// </summary>
+        avx512_t
+    };
+
+    /// <summary>
+    /// Gets the widest vector instruction set supported by the current CPU. The result is computed once and cached.
+    /// </summary>
+    simd_level_t simd_level() noexcept;
+
+}  // namespace wincpp::core
\ No newline at end of file
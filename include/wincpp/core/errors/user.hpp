@@ -20,7 +20,42 @@ namespace wincpp::core
         /// <summary>
         /// The desired export was not found.
         /// </summary>
-        export_not_found_t
+        export_not_found_t,
+
+        /// <summary>
+        /// The pattern string could not be parsed.
+        /// </summary>
+        invalid_pattern_t,
+
+        /// <summary>
+        /// The pattern is larger than a pattern can hold.
+        /// </summary>
+        pattern_too_large_t,
+
+        /// <summary>
+        /// The signature has more steps than a signature can hold.
+        /// </summary>
+        too_many_steps_t,
+
+        /// <summary>
+        /// The value query has an empty range, a NaN bound or an alignment that isn't a power of two.
+        /// </summary>
+        invalid_value_query_t,
+
+        /// <summary>
+        /// The file of a memory snapshot could not be created.
+        /// </summary>
+        snapshot_file_t,
+
+        /// <summary>
+        /// The pointer scan asks for paths deeper or offsets larger than a pointer path can hold.
+        /// </summary>
+        invalid_pointer_scan_t,
+
+        /// <summary>
+        /// The buffer is too large for a suffix array to index.
+        /// </summary>
+        buffer_too_large_t
     };
 
     /// <summary>
@@ -7,6 +7,7 @@
 
 #include <Psapi.h>
 
+#include <limits>
 #include <optional>
 #include <vector>
 
@@ -16,6 +17,46 @@ namespace wincpp::patterns
     /// Forward declaration of the pattern_t struct.
     /// </summary>
     struct pattern_t;
+
+    /// <summary>
+    /// Forward declaration of the compiled_pattern_t struct.
+    /// </summary>
+    struct compiled_pattern_t;
+
+    /// <summary>
+    /// Forward declaration of the signature_set class.
+    /// </summary>
+    class signature_set;
+
+    /// <summary>
+    /// Forward declaration of the signature_t struct.
+    /// </summary>
+    struct signature_t;
+
+    /// <summary>
+    /// Forward declaration of the regex_t class.
+    /// </summary>
+    class regex_t;
+
+    /// <summary>
+    /// Forward declaration of the approx_match_t struct.
+    /// </summary>
+    struct approx_match_t;
+
+    /// <summary>
+    /// Forward declaration of the string_encoding_t enum.
+    /// </summary>
+    enum class string_encoding_t : std::uint8_t;
+
+    /// <summary>
+    /// Forward declaration of the string_match_t struct.
+    /// </summary>
+    struct string_match_t;
+
+    /// <summary>
+    /// Forward declaration of the extracted_string_t struct.
+    /// </summary>
+    struct extracted_string_t;
 }  // namespace wincpp::patterns
 
 namespace wincpp::memory
@@ -161,15 +202,108 @@ namespace wincpp::memory
         /// Searches for the pattern in the memory object.
         /// </summary>
         /// <param name="pattern">The pattern to search for.</param>
+        /// <param name="parallelize">Whether to use multiple threads to search each region.</param>
         /// <returns>The relative location.</returns>
-        std::optional< std::uintptr_t > find( const patterns::pattern_t& pattern ) const noexcept;
+        std::optional< std::uintptr_t > find( const patterns::pattern_t& pattern, bool parallelize = false ) const noexcept;
 
         /// <summary>
         /// Searches for all occurrences of the pattern in the memory object.
         /// </summary>
         /// <param name="pattern">The pattern to search for.</param>
+        /// <param name="parallelize">Whether to use multiple threads to search each region.</param>
+        /// <returns>The relative locations.</returns>
+        std::vector< std::uintptr_t > find_all( const patterns::pattern_t& pattern, bool parallelize = false ) const noexcept;
+
+        /// <summary>
+        /// Searches for the compiled pattern in the memory object.
+        /// </summary>
+        /// <param name="pattern">The compiled pattern to search for.</param>
+        /// <param name="parallelize">Whether to use multiple threads to search each region.</param>
+        /// <returns>The relative location.</returns>
+        std::optional< std::uintptr_t > find( const patterns::compiled_pattern_t& pattern, bool parallelize = false ) const noexcept;
+
+        /// <summary>
+        /// Searches for all occurrences of the compiled pattern in the memory object.
+        /// </summary>
+        /// <param name="pattern">The compiled pattern to search for.</param>
+        /// <param name="parallelize">Whether to use multiple threads to search each region.</param>
         /// <returns>The relative locations.</returns>
-        std::vector< std::uintptr_t > find_all( const patterns::pattern_t& pattern ) const noexcept;
+        std::vector< std::uintptr_t > find_all( const patterns::compiled_pattern_t& pattern, bool parallelize = false ) const noexcept;
+
+        /// <summary>
+        /// Searches for the first occurrence of every pattern in the set, reading the memory object only once.
+        /// </summary>
+        /// <param name="set">The signature set to search for.</param>
+        /// <returns>The address of each pattern, indexed by its id in the set.</returns>
+        std::vector< std::optional< std::uintptr_t > > find( const patterns::signature_set& set ) const noexcept;
+
+        /// <summary>
+        /// Searches for the locations where the pattern matches with at most `k` wrong positions.
+        /// </summary>
+        /// <param name="pattern">The pattern to search for.</param>
+        /// <param name="k">The maximum number of wrong positions.</param>
+        /// <param name="limit">The maximum number of matches to return.</param>
+        /// <returns>The best matches with their addresses, ordered by distance and then by address.</returns>
+        std::vector< patterns::approx_match_t > find_approx(
+            const patterns::pattern_t& pattern,
+            std::size_t k,
+            std::size_t limit = std::numeric_limits< std::size_t >::max() ) const noexcept;
+
+        /// <summary>
+        /// Searches for the string in the encodings, ignoring the case of ASCII letters.
+        /// </summary>
+        /// <param name="text">The string to search for.</param>
+        /// <param name="encoding">The encodings to search for, e.g. `string_encoding_t::both_t`.</param>
+        /// <returns>The first match, with its address.</returns>
+        std::optional< patterns::string_match_t > find_string( std::string_view text, patterns::string_encoding_t encoding ) const noexcept;
+
+        /// <summary>
+        /// Searches for every occurrence of the string in the encodings, ignoring the case of ASCII letters.
+        /// </summary>
+        /// <param name="text">The string to search for.</param>
+        /// <param name="encoding">The encodings to search for, e.g. `string_encoding_t::both_t`.</param>
+        /// <returns>The matches with their addresses, in ascending order.</returns>
+        std::vector< patterns::string_match_t > find_all_strings( std::string_view text, patterns::string_encoding_t encoding ) const noexcept;
+
+        /// <summary>
+        /// Extracts every run of printable ASCII or UTF-16LE characters, like the `strings` tool. Each region is read and classified on
+        /// its own, so a run that crosses into the next region is reported as two.
+        /// </summary>
+        /// <param name="min_length">The minimum number of characters in a run, e.g. 4.</param>
+        /// <param name="encoding">The encodings to extract, e.g. `string_encoding_t::both_t`.</param>
+        /// <param name="parallelize">Whether to read and extract from the regions on multiple threads.</param>
+        /// <returns>The runs with their addresses, in ascending order.</returns>
+        std::vector< patterns::extracted_string_t >
+        strings( std::size_t min_length, patterns::string_encoding_t encoding, bool parallelize = true ) const noexcept;
+
+        /// <summary>
+        /// Searches for the expression in the memory object.
+        /// </summary>
+        /// <param name="regex">The expression to search for.</param>
+        /// <returns>The location of the start of the first match.</returns>
+        std::optional< std::uintptr_t > find( const patterns::regex_t& regex ) const noexcept;
+
+        /// <summary>
+        /// Searches for all occurrences of the expression in the memory object.
+        /// </summary>
+        /// <param name="regex">The expression to search for.</param>
+        /// <returns>The locations of the start of every match.</returns>
+        std::vector< std::uintptr_t > find_all( const patterns::regex_t& regex ) const noexcept;
+
+        /// <summary>
+        /// Searches for the first occurrence of every signature in the set and runs its steps. The memory object is read only once, and
+        /// the steps read from those buffers; only pointers that leave the memory object are read from the process.
+        /// </summary>
+        /// <param name="set">The signature set to resolve.</param>
+        /// <returns>The resolved address of each signature, indexed by its id in the set.</returns>
+        std::vector< std::optional< std::uintptr_t > > resolve( const patterns::signature_set& set ) const;
+
+        /// <summary>
+        /// Searches for the signature and runs its steps.
+        /// </summary>
+        /// <param name="signature">The signature to resolve.</param>
+        /// <returns>The resolved address.</returns>
+        std::optional< std::uintptr_t > resolve( const patterns::signature_t& signature ) const;
 
         /// <summary>
         /// Changes the protection of the memory region.
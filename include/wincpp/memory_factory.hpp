@@ -1,10 +1,14 @@
 #pragma once
 
+#include <filesystem>
 #include <functional>
+#include <limits>
 #include <memory>
 #include <optional>
+#include <span>
 #include <string>
 #include <string_view>
+#include <vector>
 
 #include "memory/protection_operation.hpp"
 #include "modules/object.hpp"
@@ -47,6 +51,29 @@ namespace wincpp::modules
     struct module_t;
 }  // namespace wincpp::modules
 
+namespace wincpp::patterns
+{
+    /// <summary>
+    /// Forward declare the value_query_t struct.
+    /// </summary>
+    struct value_query_t;
+
+    /// <summary>
+    /// Forward declare the value_type_t enum.
+    /// </summary>
+    enum class value_type_t : std::uint8_t;
+
+    /// <summary>
+    /// Forward declare the scan_session class.
+    /// </summary>
+    class scan_session;
+
+    /// <summary>
+    /// Forward declare the pointer_map class.
+    /// </summary>
+    class pointer_map;
+}  // namespace wincpp::patterns
+
 namespace wincpp
 {
     struct process_t;
@@ -77,6 +104,12 @@ namespace wincpp
 
         constexpr static std::size_t buffer_size = 256;
 
+        /// <summary>
+        /// The size of the pieces that regions are split into when searching for values, so a large region is spread across threads and never
+        /// read at once.
+        /// </summary>
+        constexpr static std::size_t chunk_size = 1 << 20;
+
         process_t* p;
         memory_type type;
 
@@ -176,7 +209,7 @@ namespace wincpp
         memory::working_set_information_t working_set_information( std::uintptr_t address ) const;
 
         /// <summary>
-        /// Find the first instance of the provided object in memory.
+        /// Find the first instance of the provided object in memory, i.e. the lowest pointer aligned address that holds its vtable.
         /// </summary>
         /// <param name="object">The object to search for.</param>
         /// <param name="parallelize">Whether to use multiple threads to search.</param>
@@ -184,7 +217,7 @@ namespace wincpp
         std::optional< std::uintptr_t > find_instance_of( const std::shared_ptr< modules::rtti::object_t >& object, bool parallelize = false ) const;
 
         /// <summary>
-        /// Find the first instance of the provided object in memory.
+        /// Find the first instance of the provided object in memory, i.e. the lowest pointer aligned address that holds its vtable.
         /// </summary>
         /// <param name="object">The object to search for.</param>
         /// <param name="compare">An optional comparison function. If the region already matches the default criteria and `compare` returns true, the
@@ -194,6 +227,127 @@ namespace wincpp
         std::optional< std::uintptr_t >
         find_instance_of( const std::shared_ptr< modules::rtti::object_t >& object, const region_compare& compare, bool parallelize = false ) const;
 
+        /// <summary>
+        /// Finds the instances of every provided object in one pass over memory. The pointer aligned values are tested against the vtables
+        /// of all the objects at once, so the cost barely grows with their number.
+        /// </summary>
+        /// <param name="objects">The objects to search for. An object given more than once is only reported under its first index.</param>
+        /// <param name="limit">The maximum number of instances to return for each object. The search ends early once every object has
+        /// that many.</param>
+        /// <param name="parallelize">Whether to use multiple threads to search.</param>
+        /// <returns>The addresses of the instances of each object, in the order of the objects and each in ascending order. Which ones are
+        /// returned when there are more than the limit isn't specified.</returns>
+        std::vector< std::vector< std::uintptr_t > > find_instances_of(
+            std::span< const std::shared_ptr< modules::rtti::object_t > > objects,
+            std::size_t limit = std::numeric_limits< std::size_t >::max(),
+            bool parallelize = true ) const;
+
+        /// <summary>
+        /// Finds the instances of every provided object in one pass over memory. The pointer aligned values are tested against the vtables
+        /// of all the objects at once, so the cost barely grows with their number.
+        /// </summary>
+        /// <param name="objects">The objects to search for. An object given more than once is only reported under its first index.</param>
+        /// <param name="compare">An optional comparison function. If the region already matches the default criteria and `compare` returns true, the
+        /// region is searched.</param>
+        /// <param name="limit">The maximum number of instances to return for each object. The search ends early once every object has
+        /// that many.</param>
+        /// <param name="parallelize">Whether to use multiple threads to search.</param>
+        /// <returns>The addresses of the instances of each object, in the order of the objects and each in ascending order. Which ones are
+        /// returned when there are more than the limit isn't specified.</returns>
+        std::vector< std::vector< std::uintptr_t > > find_instances_of(
+            std::span< const std::shared_ptr< modules::rtti::object_t > > objects,
+            const region_compare& compare,
+            std::size_t limit = std::numeric_limits< std::size_t >::max(),
+            bool parallelize = true ) const;
+
+        /// <summary>
+        /// Finds every value that the query accepts in the committed and readable regions of the process.
+        /// </summary>
+        /// <param name="query">The query.</param>
+        /// <param name="parallelize">Whether to use multiple threads to search.</param>
+        /// <returns>The addresses of the values, in ascending order.</returns>
+        std::vector< std::uintptr_t > find_values( const patterns::value_query_t& query, bool parallelize = true ) const;
+
+        /// <summary>
+        /// Finds every value that the query accepts in the committed and readable regions of the process.
+        /// </summary>
+        /// <param name="query">The query.</param>
+        /// <param name="compare">An optional comparison function. If the region already matches the default criteria and `compare` returns true, the
+        /// region is searched.</param>
+        /// <param name="parallelize">Whether to use multiple threads to search.</param>
+        /// <returns>The addresses of the values, in ascending order.</returns>
+        std::vector< std::uintptr_t > find_values( const patterns::value_query_t& query, const region_compare& compare, bool parallelize = true ) const;
+
+        /// <summary>
+        /// Scans the committed and readable regions of the process for the values that the query accepts, and keeps them as the candidates of a
+        /// session to narrow with later scans. The session reads through this factory, so it must not outlive the process.
+        /// </summary>
+        /// <param name="query">The query.</param>
+        /// <param name="parallelize">Whether to use multiple threads to scan.</param>
+        /// <returns>The session.</returns>
+        patterns::scan_session scan_values( const patterns::value_query_t& query, bool parallelize = true ) const;
+
+        /// <summary>
+        /// Scans the committed and readable regions of the process for the values that the query accepts, and keeps them as the candidates of a
+        /// session to narrow with later scans. The session reads through this factory, so it must not outlive the process.
+        /// </summary>
+        /// <param name="query">The query.</param>
+        /// <param name="compare">An optional comparison function. If the region already matches the default criteria and `compare` returns true, the
+        /// region is scanned.</param>
+        /// <param name="parallelize">Whether to use multiple threads to scan.</param>
+        /// <returns>The session.</returns>
+        patterns::scan_session scan_values( const patterns::value_query_t& query, const region_compare& compare, bool parallelize = true ) const;
+
+        /// <summary>
+        /// Takes a compressed snapshot of the committed and readable regions of the process for a scan whose initial value is unknown. Every
+        /// value of the type at the alignment is a candidate of the session until the first change narrows them. The session reads through
+        /// this factory, so it must not outlive the process.
+        /// </summary>
+        /// <param name="type">The type of the values.</param>
+        /// <param name="alignment">The alignment of the values.</param>
+        /// <param name="spill">The file to keep the snapshot in, or an empty path to keep it in memory.</param>
+        /// <param name="parallelize">Whether to use multiple threads to scan.</param>
+        /// <returns>The session.</returns>
+        patterns::scan_session
+        scan_unknown_values( patterns::value_type_t type, std::size_t alignment, const std::filesystem::path& spill = {}, bool parallelize = true ) const;
+
+        /// <summary>
+        /// Takes a compressed snapshot of the committed and readable regions of the process for a scan whose initial value is unknown. Every
+        /// value of the type at the alignment is a candidate of the session until the first change narrows them. The session reads through
+        /// this factory, so it must not outlive the process.
+        /// </summary>
+        /// <param name="type">The type of the values.</param>
+        /// <param name="alignment">The alignment of the values.</param>
+        /// <param name="compare">An optional comparison function. If the region already matches the default criteria and `compare` returns true, the
+        /// region is scanned.</param>
+        /// <param name="spill">The file to keep the snapshot in, or an empty path to keep it in memory.</param>
+        /// <param name="parallelize">Whether to use multiple threads to scan.</param>
+        /// <returns>The session.</returns>
+        patterns::scan_session scan_unknown_values(
+            patterns::value_type_t type,
+            std::size_t alignment,
+            const region_compare& compare,
+            const std::filesystem::path& spill = {},
+            bool parallelize = true ) const;
+
+        /// <summary>
+        /// Maps the pointers in the committed and readable regions of the process that point into them, with the modules of the process as the
+        /// static images, for finding the paths of pointers that lead to an address.
+        /// </summary>
+        /// <param name="parallelize">Whether to use multiple threads to scan.</param>
+        /// <returns>The map.</returns>
+        patterns::pointer_map map_pointers( bool parallelize = true ) const;
+
+        /// <summary>
+        /// Maps the pointers in the committed and readable regions of the process that point into them, with the modules of the process as the
+        /// static images, for finding the paths of pointers that lead to an address.
+        /// </summary>
+        /// <param name="compare">An optional comparison function. If the region already matches the default criteria and `compare` returns true, the
+        /// region is scanned.</param>
+        /// <param name="parallelize">Whether to use multiple threads to scan.</param>
+        /// <returns>The map.</returns>
+        patterns::pointer_map map_pointers( const region_compare& compare, bool parallelize = true ) const;
+
         /// <summary>
         /// Frees the memory at the specified address.
         /// </summary>
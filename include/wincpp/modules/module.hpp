@@ -4,6 +4,8 @@
 #include "wincpp/core/snapshot.hpp"
 #include "wincpp/memory/memory.hpp"
 #include "wincpp/modules/object.hpp"
+#include "wincpp/patterns/image_index.hpp"
+#include "wincpp/patterns/signature_cache.hpp"
 // clang-format on
 
 #include <Psapi.h>
@@ -87,6 +89,58 @@ namespace wincpp::modules
         /// <returns>A list of objects.</returns>
         std::vector< std::shared_ptr< rtti::object_t > > fetch_objects( const std::string_view mangled ) const;
 
+        /// <summary>
+        /// Generates the shortest pattern that matches at the address and nowhere else in the code sections of the module. Relocated bytes,
+        /// rel32 operands and RIP-relative displacements are wildcarded.
+        /// </summary>
+        /// <remarks>
+        /// The first call reads the code sections and builds a suffix array over them, which takes a while for large modules. Later calls reuse
+        /// it and only need a few lookups each.
+        /// </remarks>
+        /// <param name="address">The address in a code section.</param>
+        /// <returns>The pattern, or nothing if the address isn't in a code section or no pattern of up to 64 bytes is unique.</returns>
+        std::optional< patterns::pattern_t > generate_signature( std::uintptr_t address ) const;
+
+        /// <summary>
+        /// Gets the FM-index of the module image, for sessions that run many queries against the same module. Its locations are relative to
+        /// the base of the module.
+        /// </summary>
+        /// <remarks>
+        /// The first call builds the index, or loads it from the file if it was saved for the same build of the module. A built index is saved
+        /// to the file so the next run can skip the build. Later calls return the same index.
+        /// </remarks>
+        /// <param name="path">The path of the index file, or empty to keep the index in memory only.</param>
+        /// <returns>The index.</returns>
+        std::shared_ptr< const patterns::image_index > index( const std::filesystem::path& path = {} ) const;
+
+        /// <summary>
+        /// Gets the fingerprint of the module, which changes whenever the module is updated.
+        /// </summary>
+        /// <param name="hash_code">Whether to read and hash the code sections, which also catches patched code.</param>
+        /// <returns>The fingerprint.</returns>
+        patterns::image_fingerprint_t fingerprint( bool hash_code = false ) const;
+
+        using memory_t::resolve;
+
+        /// <summary>
+        /// Resolves every signature in the set, taking the location of each pattern from the cache when the module hasn't changed since it was
+        /// cached. Each cached location is verified by reading the pattern back from the module. Only the patterns that miss or fail the check
+        /// are scanned for, in a single pass, and their locations are added to the cache. Patterns that aren't found are cached as missing, and
+        /// aren't scanned for again until the module changes.
+        /// </summary>
+        /// <param name="set">The signature set to resolve.</param>
+        /// <param name="cache">The cache of pattern locations.</param>
+        /// <returns>The resolved address of each signature, indexed by its id in the set.</returns>
+        std::vector< std::optional< std::uintptr_t > > resolve( const patterns::signature_set& set, patterns::signature_cache& cache ) const;
+
+        /// <summary>
+        /// Resolves the signature, taking the location of its pattern from the cache when the module hasn't changed since it was cached.
+        /// </summary>
+        /// <param name="signature">The signature to resolve.</param>
+        /// <param name="cache">The cache of pattern locations.</param>
+        /// <returns>The resolved address.</returns>
+        std::optional< std::uintptr_t > resolve( const patterns::signature_t& signature, patterns::signature_cache& cache ) const;
+
         /// <summary>
         /// Gets the export by its name.
         /// </summary>
@@ -106,8 +160,15 @@ namespace wincpp::modules
         const IMAGE_DOS_HEADER *dos_header;
         const IMAGE_NT_HEADERS *nt_headers;
 
+        /// <summary>
+        /// The suffix array of the code sections and the bytes in them that relocations patch.
+        /// </summary>
+        struct code_index_t;
+
         mutable std::list< std::shared_ptr< module_t::export_t > > _exports;
         mutable std::list< std::shared_ptr< module_t::section_t > > _sections;
+        mutable std::shared_ptr< const code_index_t > _code_index;
+        mutable std::shared_ptr< const patterns::image_index > _image_index;
     
         std::shared_ptr< std::uint8_t[] > buffer;
     };
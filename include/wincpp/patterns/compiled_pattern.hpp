@@ -0,0 +1,152 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+#include "wincpp/patterns/pattern.hpp"
+
+namespace wincpp::patterns
+{
+    /// <summary>
+    /// A pattern together with everything the scanning algorithms derive from it. Building this once and reusing it across `find_all` calls,
+    /// regions and modules avoids rebuilding the skip tables on every call.
+    /// </summary>
+    struct compiled_pattern_t
+    {
+        /// <summary>
+        /// Default constructor for the compiled pattern object.
+        /// </summary>
+        compiled_pattern_t() = default;
+
+        /// <summary>
+        /// Compiles the specified pattern.
+        /// </summary>
+        /// <param name="pattern">The pattern to compile.</param>
+        explicit compiled_pattern_t( const pattern_t& pattern ) noexcept;
+
+        /// <summary>
+        /// Gets the size of the pattern in bytes.
+        /// </summary>
+        constexpr std::size_t size() const noexcept;
+
+        /// <summary>
+        /// Compares every position of the pattern against the data. The data must hold at least `size()` bytes.
+        /// </summary>
+        /// <param name="data">The data to compare against.</param>
+        /// <returns>True if the pattern matches, false otherwise.</returns>
+        inline bool matches( const std::uint8_t* data ) const noexcept;
+
+        /// <summary>
+        /// Checks only the byte classes of the pattern against the data. Used after a value/mask comparison has already passed.
+        /// </summary>
+        /// <param name="data">The data to compare against.</param>
+        /// <returns>True if every class contains its byte, false otherwise.</returns>
+        inline bool matches_classes( const std::uint8_t* data ) const noexcept;
+
+        /// <summary>
+        /// Gets a rough estimate of how common the byte is in x86-64 images. Lower values are rarer.
+        /// </summary>
+        /// <param name="byte">The byte.</param>
+        static std::uint8_t frequency( std::uint8_t byte ) noexcept;
+
+        /// <summary>
+        /// The number of positions that fit in a bit-parallel word. Every pattern fits in a single word.
+        /// </summary>
+        static constexpr std::size_t word_size = 64;
+
+        static_assert( pattern_t::max_size <= word_size );
+
+        /// <summary>
+        /// The source pattern.
+        /// </summary>
+        pattern_t pattern;
+
+        /// <summary>
+        /// The pattern bytes with every bit outside of the mask cleared to zero.
+        /// </summary>
+        std::array< std::uint8_t, pattern_t::max_size > value{};
+
+        /// <summary>
+        /// The packed mask. Strict bytes are 0xFF, wildcards 0x00 and nibble wildcards 0xF0 or 0x0F, so a byte passes if
+        /// `(byte & mask) == value`.
+        /// </summary>
+        std::array< std::uint8_t, pattern_t::max_size > mask{};
+
+        /// <summary>
+        /// The bad-character shifts for the Boyer-Moore family, indexed by the buffer byte under the last pattern position.
+        /// </summary>
+        std::array< std::size_t, 256 > skip_table{};
+
+        /// <summary>
+        /// The good-suffix shifts for the Turbo-BM algorithm, indexed by the position of the mismatch. A wildcard is treated as compatible with
+        /// every byte, so the shifts stay valid for masked patterns.
+        /// </summary>
+        std::array< std::size_t, pattern_t::max_size > good_suffix{};
+
+        /// <summary>
+        /// The bit-parallel encoding of the pattern: bit `i` of `position_masks[ byte ]` is set if position `i` accepts the byte.
+        /// Wildcards set their bit for every byte.
+        /// </summary>
+        std::array< std::uint64_t, 256 > position_masks{};
+
+        /// <summary>
+        /// The positions of the two most selective non-wildcard positions in ascending order. Both are equal if there is only one.
+        /// </summary>
+        std::array< std::size_t, 2 > anchors{};
+
+        /// <summary>
+        /// The number of positions in the pattern that aren't full wildcards.
+        /// </summary>
+        std::size_t strict = 0;
+
+        /// <summary>
+        /// True if every position of the pattern is a strict byte.
+        /// </summary>
+        bool exact = true;
+    };
+
+    constexpr std::size_t compiled_pattern_t::size() const noexcept
+    {
+        return pattern.size;
+    }
+
+    inline bool compiled_pattern_t::matches( const std::uint8_t* data ) const noexcept
+    {
+        const auto n = pattern.size;
+        std::size_t i = 0;
+
+        // Compare eight bytes at a time while they fit in the pattern.
+        for ( ; i + sizeof( std::uint64_t ) <= n; i += sizeof( std::uint64_t ) )
+        {
+            std::uint64_t d, v, m;
+
+            std::memcpy( &d, data + i, sizeof( d ) );
+            std::memcpy( &v, value.data() + i, sizeof( v ) );
+            std::memcpy( &m, mask.data() + i, sizeof( m ) );
+
+            if ( ( d & m ) != v )
+                return false;
+        }
+
+        for ( ; i < n; ++i )
+        {
+            if ( ( data[ i ] & mask[ i ] ) != value[ i ] )
+                return false;
+        }
+
+        return matches_classes( data );
+    }
+
+    inline bool compiled_pattern_t::matches_classes( const std::uint8_t* data ) const noexcept
+    {
+        for ( std::size_t i = 0; i < pattern.class_count; ++i )
+        {
+            if ( !pattern.classes[ i ].contains( data[ pattern.classes[ i ].position ] ) )
+                return false;
+        }
+
+        return true;
+    }
+
+}  // namespace wincpp::patterns
\ No newline at end of file
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <span>
+
+#include "wincpp/patterns/pattern.hpp"
+#include "wincpp/patterns/suffix_array.hpp"
+
+namespace wincpp::patterns
+{
+    /// <summary>
+    /// Generates the shortest pattern that starts at the offset and occurs only once in the indexed buffer. The bytes that change between
+    /// builds or loads are wildcarded: the rel32 operands and RIP-relative displacements of the x86-64 instructions at the offset, and the
+    /// relocated bytes.
+    /// </summary>
+    /// <remarks>
+    /// Every prefix of a pattern matches wherever the pattern does, so uniqueness is monotonic in the length, and the length is found by a
+    /// binary search of about six suffix array lookups. Instructions are decoded until one isn't recognized; the bytes after it are kept
+    /// as they are.
+    /// </remarks>
+    /// <param name="index">The suffix array of the code.</param>
+    /// <param name="offset">The relative location to generate a pattern for.</param>
+    /// <param name="relocated">A byte per byte of the code, nonzero for the bytes patched by base relocations. May be empty.</param>
+    /// <returns>The pattern, or nothing if even `pattern_t::max_size` bytes aren't unique.</returns>
+    std::optional< pattern_t >
+    generate_signature( const suffix_array_t& index, std::size_t offset, std::span< const std::uint8_t > relocated = {} ) noexcept;
+}  // namespace wincpp::patterns
@@ -0,0 +1,189 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <limits>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "wincpp/patterns/compiled_pattern.hpp"
+#include "wincpp/patterns/pattern.hpp"
+#include "wincpp/patterns/signature_cache.hpp"
+
+namespace wincpp::patterns
+{
+    /// <summary>
+    /// An FM-index of an image: the Burrows-Wheeler transform of the image in a wavelet matrix, and a sample of its suffix array. Counting a
+    /// pattern costs a few rank queries per position instead of a pass over the image, and locating costs a short walk per occurrence, so it
+    /// pays off when the same image is queried many times.
+    /// </summary>
+    /// <remarks>
+    /// <para>
+    /// Masked positions and byte classes are handled by backtracking: at every such position the search branches into each byte that occurs
+    /// there and passes the position, so the cost grows with the number of distinct strings that match. Leading and trailing wildcards are
+    /// stripped before the search and cost nothing.
+    /// </para>
+    /// <para>
+    /// The index uses about 1.4 bytes per image byte and doesn't keep the image. Images must be smaller than 2 GiB.
+    /// </para>
+    /// </remarks>
+    class image_index final
+    {
+       public:
+        /// <summary>
+        /// One suffix array entry is kept for every `sample_rate` bytes of the image. Higher rates make the index smaller and locating slower.
+        /// </summary>
+        static constexpr std::size_t sample_rate = 32;
+
+        /// <summary>
+        /// Default constructor for the image index object. The index is empty.
+        /// </summary>
+        image_index() = default;
+
+        /// <summary>
+        /// Builds the index of the image.
+        /// </summary>
+        /// <param name="image">The image to index.</param>
+        explicit image_index( std::span< const std::uint8_t > image );
+
+        /// <summary>
+        /// Gets the size of the indexed image in bytes.
+        /// </summary>
+        std::size_t size() const noexcept;
+
+        /// <summary>
+        /// Gets the number of bytes the index occupies.
+        /// </summary>
+        std::size_t memory_usage() const noexcept;
+
+        /// <summary>
+        /// Counts the occurrences of the pattern in the image.
+        /// </summary>
+        /// <param name="pattern">The pattern to count.</param>
+        /// <param name="limit">The count to stop at, e.g. 2 to tell if the pattern is unique.</param>
+        /// <returns>The number of occurrences, at most `limit`.</returns>
+        std::size_t count( const pattern_t& pattern, std::size_t limit = std::numeric_limits< std::size_t >::max() ) const noexcept;
+
+        /// <summary>
+        /// Locates the occurrences of the pattern in the image.
+        /// </summary>
+        /// <param name="pattern">The pattern to locate.</param>
+        /// <param name="limit">The maximum number of occurrences to return. Which ones are returned when there are more isn't specified.</param>
+        /// <returns>The relative locations, in ascending order.</returns>
+        std::vector< std::uintptr_t >
+        locate( const pattern_t& pattern, std::size_t limit = std::numeric_limits< std::size_t >::max() ) const noexcept;
+
+        /// <summary>
+        /// Writes the index to a file, tagged with the fingerprint of the image. The file is written next to the path and renamed over it, so
+        /// a failed save never leaves a truncated file behind.
+        /// </summary>
+        /// <param name="path">The path of the index file.</param>
+        /// <param name="fingerprint">The fingerprint of the indexed image.</param>
+        /// <returns>True if the file was written.</returns>
+        bool save( const std::filesystem::path& path, const image_fingerprint_t& fingerprint ) const noexcept;
+
+        /// <summary>
+        /// Reads an index from a file written by `save`.
+        /// </summary>
+        /// <param name="path">The path of the index file.</param>
+        /// <param name="fingerprint">The fingerprint of the image the index is for.</param>
+        /// <returns>The index, or nothing if the file doesn't exist, is corrupt or belongs to another build of the image.</returns>
+        static std::optional< image_index > load( const std::filesystem::path& path, const image_fingerprint_t& fingerprint ) noexcept;
+
+       private:
+        /// <summary>
+        /// A bit vector split into cache line sized blocks, each holding the number of set bits before it and the next 448 bits, so a rank
+        /// query touches a single cache line.
+        /// </summary>
+        struct bit_vector_t
+        {
+            /// <summary>
+            /// The number of bits in a block.
+            /// </summary>
+            static constexpr std::size_t block_bits = 448;
+
+            struct alignas( 64 ) block_t
+            {
+                std::uint64_t rank;
+                std::uint64_t words[ block_bits / 64 ];
+            };
+
+            /// <summary>
+            /// Clears the vector to the number of bits.
+            /// </summary>
+            void resize( std::size_t size );
+
+            /// <summary>
+            /// Sets the bit at the position.
+            /// </summary>
+            void set( std::size_t position ) noexcept;
+
+            /// <summary>
+            /// Computes the counts of every block from the bits.
+            /// </summary>
+            void build() noexcept;
+
+            /// <summary>
+            /// Gets the bit at the position.
+            /// </summary>
+            bool get( std::size_t position ) const noexcept;
+
+            /// <summary>
+            /// Counts the set bits before the position.
+            /// </summary>
+            std::size_t rank( std::size_t position ) const noexcept;
+
+            std::vector< block_t > blocks;
+        };
+
+        /// <summary>
+        /// Computes the counts of the bit vectors and the tables derived from the wavelet matrix once its levels are filled in.
+        /// </summary>
+        void finish();
+
+        /// <summary>
+        /// Maps a row of the transform to the row of the suffix that starts one byte earlier.
+        /// </summary>
+        std::size_t last_to_first( std::size_t row ) const noexcept;
+
+        /// <summary>
+        /// Gets the location in the image of the suffix at the row.
+        /// </summary>
+        std::size_t location_of( std::size_t row ) const noexcept;
+
+        /// <summary>
+        /// Calls the callback with every range of rows whose suffixes begin with the positions [first, last) of the pattern, until it returns
+        /// false.
+        /// </summary>
+        /// <returns>False if the callback stopped the search.</returns>
+        template< typename callback_t >
+        bool search( const compiled_pattern_t& pattern, std::size_t first, std::size_t last, callback_t&& callback ) const noexcept;
+
+        /// <summary>
+        /// Counts the occurrences of the positions [first, last) of the pattern that are too close to either end of the image for the whole
+        /// pattern to fit around them. These are checked against the copies of the start and end of the image.
+        /// </summary>
+        std::size_t overhanging( const compiled_pattern_t& pattern, std::size_t first, std::size_t last ) const noexcept;
+
+        // The size of the image, and the row of the suffix that starts at zero, whose transform byte is the end marker.
+        std::size_t _size = 0;
+        std::size_t _primary = 0;
+
+        // One level of the wavelet matrix per bit of a byte, most significant first, and the number of zeros on each.
+        std::array< bit_vector_t, 8 > _levels;
+        std::array< std::size_t, 8 > _zeros{};
+
+        // The first row of each byte on the last level of the matrix, and the first row of each byte in the sorted suffixes.
+        std::array< std::size_t, 256 > _begin{};
+        std::array< std::size_t, 257 > _first{};
+
+        // The rows whose suffix is sampled, and the sampled locations in row order.
+        bit_vector_t _sampled;
+        std::vector< std::uint32_t > _samples;
+
+        // The first and last bytes of the image, to check the matches of trimmed patterns that run past either end.
+        std::vector< std::uint8_t > _head, _tail;
+    };
+}  // namespace wincpp::patterns
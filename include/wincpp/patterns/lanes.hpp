@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace wincpp::patterns
+{
+    /// <summary>
+    /// A set of 64-bit values that the lanes of a buffer are tested against, e.g. the vtables of every class whose instances are wanted.
+    /// </summary>
+    /// <remarks>
+    /// The values are kept in an open addressing hash table at most a quarter full, so a lookup almost always takes a single probe. The
+    /// smallest and largest values bound the set, so a scan only looks up the lanes between them, which for the vtables of a module are few.
+    /// </remarks>
+    class lane_set final
+    {
+       public:
+        /// <summary>
+        /// Creates a set of the values.
+        /// </summary>
+        /// <param name="values">The values. Duplicates are kept once, under their first index.</param>
+        explicit lane_set( std::span< const std::uint64_t > values );
+
+        /// <summary>
+        /// Gets the number of distinct values in the set.
+        /// </summary>
+        std::size_t size() const noexcept;
+
+        /// <summary>
+        /// Gets the smallest and largest value in the set. Both are zero if the set is empty.
+        /// </summary>
+        std::uint64_t low() const noexcept;
+        std::uint64_t high() const noexcept;
+
+        /// <summary>
+        /// Finds a value in the set.
+        /// </summary>
+        /// <param name="value">The value.</param>
+        /// <returns>The index of the value in the values the set was created from, or nothing if it isn't in the set.</returns>
+        std::optional< std::size_t > find( std::uint64_t value ) const noexcept;
+
+       private:
+        struct slot_t
+        {
+            std::uint64_t value;
+            std::uint32_t index;
+        };
+
+        /// <summary>
+        /// Gets the slot a value is looked up from.
+        /// </summary>
+        std::size_t home( std::uint64_t value ) const noexcept;
+
+        // The table, whose empty slots have the largest index, and the number of bits of its size.
+        std::vector< slot_t > _slots;
+        std::size_t _bits = 0;
+
+        std::size_t _size = 0;
+        std::uint64_t _low = 0, _high = 0;
+    };
+
+    /// <summary>
+    /// Finds every aligned 64-bit lane of the buffer that holds the value, e.g. the objects whose first field is a vtable.
+    /// </summary>
+    /// <remarks>
+    /// The buffer is compared two lanes at a time with SSE2, four with AVX2 and eight with AVX-512, instead of at every byte offset like a
+    /// pattern scan. Blocks without a match cost a single branch.
+    /// </remarks>
+    /// <param name="buffer">The buffer to search. Lanes start at multiples of the stride from its start.</param>
+    /// <param name="value">The value.</param>
+    /// <param name="stride">The distance between the lanes, a power of two of at least 8. Other strides are rounded up to one.</param>
+    /// <param name="limit">The maximum number of matches to return.</param>
+    /// <returns>The relative locations of the first matches, in ascending order.</returns>
+    std::vector< std::uintptr_t > find_lanes(
+        std::span< const std::uint8_t > buffer,
+        std::uint64_t value,
+        std::size_t stride = 8,
+        std::size_t limit = std::numeric_limits< std::size_t >::max() ) noexcept;
+
+    /// <summary>
+    /// Finds every aligned 64-bit lane of the buffer that holds a value of the set.
+    /// </summary>
+    /// <remarks>
+    /// The lanes are compared against the bounds of the set a vector at a time like a single value, and only the lanes between them are
+    /// looked up in the set.
+    /// </remarks>
+    /// <param name="buffer">The buffer to search. Lanes start at multiples of the stride from its start.</param>
+    /// <param name="set">The set.</param>
+    /// <param name="stride">The distance between the lanes, a power of two of at least 8. Other strides are rounded up to one.</param>
+    /// <param name="limit">The maximum number of matches to return.</param>
+    /// <returns>The relative locations of the first matches, in ascending order.</returns>
+    std::vector< std::uintptr_t > find_lanes(
+        std::span< const std::uint8_t > buffer,
+        const lane_set& set,
+        std::size_t stride = 8,
+        std::size_t limit = std::numeric_limits< std::size_t >::max() ) noexcept;
+}  // namespace wincpp::patterns
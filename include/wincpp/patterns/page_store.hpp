@@ -0,0 +1,113 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <span>
+#include <vector>
+
+namespace wincpp::patterns
+{
+    /// <summary>
+    /// A compressed store of pages of memory, e.g. the snapshot that an unknown initial value scan compares against. Each page is compressed on
+    /// its own, so any page can be read back or replaced without touching the others.
+    /// </summary>
+    /// <remarks>
+    /// <para>
+    /// Pages are compressed with a byte oriented LZ77 codec in the spirit of LZ4: literals and matches of at least four bytes within the page,
+    /// found through a small hash table and copied back without any entropy decoding. Pages of zeros take a single byte, and pages that don't
+    /// compress are kept as they are, so a page never takes more than a byte over its size.
+    /// </para>
+    /// <para>
+    /// The pages are kept in memory, or in a file when the snapshot is too large for that. Distinct slots can be stored and loaded from several
+    /// threads at once; in a file, the accesses are serialized.
+    /// </para>
+    /// </remarks>
+    class page_store final
+    {
+       public:
+        /// <summary>
+        /// Creates a store that keeps the pages in memory.
+        /// </summary>
+        page_store() = default;
+
+        /// <summary>
+        /// Creates a store that keeps the pages in a file, which is created or truncated now and removed with the store. Throws if the file
+        /// can't be created.
+        /// </summary>
+        /// <param name="path">The path of the file.</param>
+        explicit page_store( const std::filesystem::path& path );
+
+        page_store( const page_store& ) = delete;
+        page_store& operator=( const page_store& ) = delete;
+
+        /// <summary>
+        /// Removes the file of the store, if it has one.
+        /// </summary>
+        ~page_store();
+
+        /// <summary>
+        /// Sets the number of slots. New slots are empty. Must not be called while pages are stored or loaded.
+        /// </summary>
+        /// <param name="slots">The number of slots.</param>
+        void resize( std::size_t slots );
+
+        /// <summary>
+        /// Compresses a page into the slot, replacing what it held.
+        /// </summary>
+        /// <param name="slot">The slot.</param>
+        /// <param name="page">The page, at most `max_page_size` bytes.</param>
+        /// <returns>True if the page was stored.</returns>
+        bool store( std::size_t slot, std::span< const std::uint8_t > page ) noexcept;
+
+        /// <summary>
+        /// Decompresses the page in the slot.
+        /// </summary>
+        /// <param name="slot">The slot.</param>
+        /// <param name="page">The buffer to decompress into, as large as the stored page.</param>
+        /// <returns>True if the slot holds a page of that size and it could be read.</returns>
+        bool load( std::size_t slot, std::span< std::uint8_t > page ) const noexcept;
+
+        /// <summary>
+        /// Empties the slot and frees its memory. In a file, the slot keeps its room for the next page stored in it.
+        /// </summary>
+        /// <param name="slot">The slot.</param>
+        void erase( std::size_t slot ) noexcept;
+
+        /// <summary>
+        /// Gets the number of bytes the store occupies in memory.
+        /// </summary>
+        std::size_t memory_usage() const noexcept;
+
+        /// <summary>
+        /// Gets the number of compressed bytes held for the pages, in memory or in the file.
+        /// </summary>
+        std::size_t compressed_size() const noexcept;
+
+        /// <summary>
+        /// The largest page the store holds.
+        /// </summary>
+        static constexpr std::size_t max_page_size = 1 << 15;
+
+       private:
+        /// <summary>
+        /// Where a page lies in the file, and the room it has there.
+        /// </summary>
+        struct extent_t
+        {
+            std::uint64_t offset;
+            std::uint32_t size;
+            std::uint32_t capacity;
+        };
+
+        // In memory, the compressed pages. In a file, where each one lies, the end of the file and the file itself.
+        std::vector< std::vector< std::uint8_t > > _pages;
+        std::vector< extent_t > _extents;
+        std::uint64_t _end = 0;
+
+        std::filesystem::path _path;
+        mutable std::fstream _file;
+        mutable std::mutex _mutex;
+    };
+}  // namespace wincpp::patterns
@@ -1,36 +1,154 @@
 #pragma once
 
+#include <array>
+#include <bit>
+#include <cstdint>
 #include <memory>
 #include <ostream>
+#include <ranges>
 #include <string>
 #include <string_view>
+#include <type_traits>
+#include <utility>
 
 namespace wincpp::patterns
 {
     /// <summary>
-    /// The class for all patterns. This struct contains the bytes, mask, and size of the pattern.
+    /// A string literal that can be used as a template argument.
     /// </summary>
+    /// <typeparam name="N">The size of the literal, including the null terminator.</typeparam>
+    template< std::size_t N >
+    struct signature_string_t
+    {
+        /// <summary>
+        /// Copies the string literal.
+        /// </summary>
+        /// <param name="text">The string literal.</param>
+        consteval signature_string_t( const char ( &text )[ N ] ) noexcept
+        {
+            for ( std::size_t i = 0; i < N; ++i )
+                data[ i ] = text[ i ];
+        }
+
+        /// <summary>
+        /// Gets the string without the null terminator.
+        /// </summary>
+        constexpr std::string_view view() const noexcept
+        {
+            return std::string_view( data, N - 1 );
+        }
+
+        char data[ N ];
+    };
+
+    /// <summary>
+    /// A single position of a pattern. A byte passes if `(byte & mask) == value`, so a mask of 0xFF is a strict byte, 0x00 is a wildcard and
+    /// 0xF0 or 0x0F fix a single nibble.
+    /// </summary>
+    struct atom_t
+    {
+        /// <summary>
+        /// Determines if the byte passes the value and mask.
+        /// </summary>
+        constexpr bool matches( std::uint8_t byte ) const noexcept
+        {
+            return ( byte & mask ) == value;
+        }
+
+        /// <summary>
+        /// The value of the position, with every bit outside of the mask cleared to zero.
+        /// </summary>
+        std::uint8_t value = 0;
+
+        /// <summary>
+        /// The bits of the value that must match.
+        /// </summary>
+        std::uint8_t mask = 0;
+    };
+
+    /// <summary>
+    /// The exact set of bytes accepted at one position of a pattern. Only needed for alternatives (`[48|4C]`, `E8|E9`) that can't be described
+    /// by a value and mask alone.
+    /// </summary>
+    struct byte_class_t
+    {
+        /// <summary>
+        /// Adds the byte to the set.
+        /// </summary>
+        constexpr void insert( std::uint8_t byte ) noexcept
+        {
+            bits[ byte >> 6 ] |= std::uint64_t( 1 ) << ( byte & 63 );
+        }
+
+        /// <summary>
+        /// Determines if the set contains the byte.
+        /// </summary>
+        constexpr bool contains( std::uint8_t byte ) const noexcept
+        {
+            return ( bits[ byte >> 6 ] >> ( byte & 63 ) ) & 1;
+        }
+
+        /// <summary>
+        /// Gets the number of bytes in the set.
+        /// </summary>
+        constexpr std::size_t count() const noexcept
+        {
+            return std::popcount( bits[ 0 ] ) + std::popcount( bits[ 1 ] ) + std::popcount( bits[ 2 ] ) + std::popcount( bits[ 3 ] );
+        }
+
+        /// <summary>
+        /// The position of the class in the pattern.
+        /// </summary>
+        std::size_t position = 0;
+
+        /// <summary>
+        /// The bit set of accepted bytes.
+        /// </summary>
+        std::uint64_t bits[ 4 ]{};
+    };
+
+    /// <summary>
+    /// The class for all patterns. This struct contains the atoms, byte classes, and size of the pattern.
+    /// </summary>
+    /// <remarks>
+    /// Patterns are plain values: the atoms and classes are stored inline, so a pattern never allocates, is trivially copyable and can be
+    /// built in `constexpr` tables. Positions with a byte class must pass both their atom and the class.
+    /// </remarks>
     struct pattern_t
     {
+        /// <summary>
+        /// The maximum number of positions in a pattern.
+        /// </summary>
+        static constexpr std::size_t max_size = 64;
+
+        /// <summary>
+        /// The maximum number of byte classes in a pattern.
+        /// </summary>
+        static constexpr std::size_t max_classes = 4;
+
         /// <summary>
         /// Default constructor for the pattern object.
         /// </summary>
-        pattern_t() = default;
+        constexpr pattern_t() noexcept = default;
 
         /// <summary>
         /// Creates a new pattern object with the specified object. This function will attempt to convert it to an array of bytes.
         /// </summary>
+        /// <remarks>
+        /// Only objects whose bytes are their value take part. A container or a view would give the bytes of its pointers, and would let a
+        /// list of patterns, e.g. `signature_set{ patterns }`, silently turn into a single pattern of them.
+        /// </remarks>
         /// <typeparam name="T">The type of the object.</typeparam>
         /// <param name="object">The object.</param>
         template< typename T >
+            requires std::is_trivially_copyable_v< T > && ( !std::ranges::view< T > )
         pattern_t( const T& object ) noexcept;
 
         /// <summary>
         /// Creates a new pattern from the bytes of the string (each character is a byte).
         /// </summary>
         /// <param name="object">The string.</param>
-        template<>
-        pattern_t( const std::string& object ) noexcept : pattern_t( object.data(), object.size() )
+        pattern_t( const std::string& object ) : pattern_t( object.data(), object.size() )
         {
         }
 
@@ -38,19 +156,18 @@ namespace wincpp::patterns
         /// Creates a new pattern from the bytes of the string (each character is a byte).
         /// </summary>
         /// <param name="object">The string.</param>
-        template<>
-        pattern_t( const std::string_view& object ) noexcept : pattern_t( object.data(), object.size() )
+        pattern_t( const std::string_view& object ) : pattern_t( object.data(), object.size() )
         {
         }
 
         /// <summary>
-        /// Creates a new pattern object with the specified pointer and its size.
+        /// Creates a new pattern object with the specified pointer and its size. Throws if the size is larger than `max_size`.
         /// </summary>
         /// <typeparam name="T">The type of the pointer.</typeparam>
         /// <param name="object"></param>
         /// <param name="size"></param>
         template< typename T >
-        pattern_t( const T* object, std::size_t size ) noexcept;
+        pattern_t( const T* object, std::size_t size );
 
         /// <summary>
         /// Creates a new pattern object with the specified array of bytes and mask. This is an IDA-style pattern.
@@ -58,7 +175,48 @@ namespace wincpp::patterns
         /// </summary>
         /// <param name="aob"></param>
         /// <param name="mask"></param>
-        pattern_t( const char* const aob, const std::string_view smask ) noexcept;
+        pattern_t( const char* const aob, const std::string_view smask );
+
+        /// <summary>
+        /// Parses an IDA or x64dbg style pattern string. Tokens are separated by whitespace and can be:
+        /// <list type="bullet">
+        /// <item>two hex digits for a strict byte, e.g. `48`</item>
+        /// <item>`?` or `??` for a wildcard</item>
+        /// <item>a hex digit and a `?` for a nibble wildcard, e.g. `4?` or `?8`</item>
+        /// <item>alternatives of the above separated by `|`, optionally in brackets, e.g. `E8|E9` or `[48|4C]`</item>
+        /// </list>
+        /// Example: "[48|4C] 8D 0D ? ? ? ? 4? 8D 55 F8"
+        /// </summary>
+        /// <param name="text">The pattern string.</param>
+        /// <returns>The parsed pattern.</returns>
+        static pattern_t parse( std::string_view text );
+
+        /// <summary>
+        /// Parses a pattern string into the provided pattern.
+        /// </summary>
+        /// <param name="text">The pattern string.</param>
+        /// <param name="result">The pattern to write to.</param>
+        /// <returns>False if the string is invalid or doesn't fit in `max_size` positions and `max_classes` byte classes.</returns>
+        static constexpr bool parse( std::string_view text, pattern_t& result ) noexcept;
+
+        /// <summary>
+        /// Determines if the position of the pattern accepts the byte.
+        /// </summary>
+        /// <param name="position">The position in the pattern.</param>
+        /// <param name="byte">The byte.</param>
+        constexpr bool accepts( std::size_t position, std::uint8_t byte ) const noexcept;
+
+        /// <summary>
+        /// Determines if the position of the pattern only accepts a single byte.
+        /// </summary>
+        /// <param name="position">The position in the pattern.</param>
+        constexpr bool literal( std::size_t position ) const noexcept;
+
+        /// <summary>
+        /// Gets the byte class of the position, or null if it has none.
+        /// </summary>
+        /// <param name="position">The position in the pattern.</param>
+        constexpr const byte_class_t* class_of( std::size_t position ) const noexcept;
 
         /// <summary>
         /// Converts the pattern to a string.
@@ -70,27 +228,219 @@ namespace wincpp::patterns
         /// </summary>
         friend std::ostream& operator<<( std::ostream& os, const pattern_t& p ) noexcept;
 
-        std::shared_ptr< std::uint8_t[] > bytes;
-        std::shared_ptr< bool[] > mask;
+        std::array< atom_t, max_size > atoms{};
+        std::array< byte_class_t, max_classes > classes{};
         std::size_t size = 0;
+        std::size_t class_count = 0;
+
+       private:
+        /// <summary>
+        /// Copies the bytes into the pattern as strict positions. Throws if the size is larger than `max_size`.
+        /// </summary>
+        /// <param name="data">The bytes.</param>
+        /// <param name="size">The number of bytes.</param>
+        void assign( const std::uint8_t* data, std::size_t size );
     };
 
+    static_assert( std::is_trivially_copyable_v< pattern_t > );
+
     template< typename T >
-    inline pattern_t::pattern_t( const T* object, std::size_t size ) noexcept : size( size )
+    inline pattern_t::pattern_t( const T* object, std::size_t size )
     {
-        bytes = std::shared_ptr< std::uint8_t[] >( new std::uint8_t[ size ] );
-        mask = std::shared_ptr< bool[] >( new bool[ size ] );
+        assign( reinterpret_cast< const std::uint8_t* >( object ), size );
+    }
 
-        for ( std::size_t i = 0; i < size; ++i )
+    template< typename T >
+        requires std::is_trivially_copyable_v< T > && ( !std::ranges::view< T > )
+    pattern_t::pattern_t( const T& object ) noexcept
+    {
+        static_assert( sizeof( T ) <= max_size, "The object is larger than a pattern can hold." );
+
+        assign( reinterpret_cast< const std::uint8_t* >( std::addressof( object ) ), sizeof( T ) );
+    }
+
+    constexpr bool pattern_t::accepts( std::size_t position, std::uint8_t byte ) const noexcept
+    {
+        if ( !atoms[ position ].matches( byte ) )
+            return false;
+
+        const auto set = class_of( position );
+        return !set || set->contains( byte );
+    }
+
+    constexpr bool pattern_t::literal( std::size_t position ) const noexcept
+    {
+        return atoms[ position ].mask == 0xFF && !class_of( position );
+    }
+
+    constexpr const byte_class_t* pattern_t::class_of( std::size_t position ) const noexcept
+    {
+        for ( std::size_t i = 0; i < class_count; ++i )
         {
-            bytes[ i ] = reinterpret_cast< const std::uint8_t* >( object )[ i ];
-            mask[ i ] = true;
+            if ( classes[ i ].position == position )
+                return &classes[ i ];
         }
+
+        return nullptr;
     }
 
-    template< typename T >
-    pattern_t::pattern_t( const T& object ) noexcept : pattern_t( std::addressof( object ), sizeof( T ) )
+    constexpr bool pattern_t::parse( std::string_view text, pattern_t& result ) noexcept
     {
+        const auto hex = []( char c ) -> int
+        {
+            if ( c >= '0' && c <= '9' )
+                return c - '0';
+
+            if ( c >= 'a' && c <= 'f' )
+                return c - 'a' + 10;
+
+            if ( c >= 'A' && c <= 'F' )
+                return c - 'A' + 10;
+
+            return -1;
+        };
+
+        const auto space = []( char c ) { return c == ' ' || c == '\t' || c == '\n' || c == '\r'; };
+
+        // Parses a single atom into its value and mask. Returns false if the atom is invalid.
+        const auto atom = [ & ]( std::string_view token, std::uint8_t& value, std::uint8_t& bits ) -> bool
+        {
+            if ( ( token.size() == 1 && token[ 0 ] == '?' ) || ( token.size() == 2 && token[ 0 ] == '?' && token[ 1 ] == '?' ) )
+            {
+                value = bits = 0;
+                return true;
+            }
+
+            if ( token.size() != 2 )
+                return false;
+
+            const auto high = hex( token[ 0 ] ), low = hex( token[ 1 ] );
+
+            if ( ( high == -1 && token[ 0 ] != '?' ) || ( low == -1 && token[ 1 ] != '?' ) )
+                return false;
+
+            value = static_cast< std::uint8_t >( ( high == -1 ? 0 : high << 4 ) | ( low == -1 ? 0 : low ) );
+            bits = static_cast< std::uint8_t >( ( high == -1 ? 0 : 0xF0 ) | ( low == -1 ? 0 : 0x0F ) );
+            return true;
+        };
+
+        result = pattern_t();
+
+        for ( std::size_t i = 0; i < text.size(); )
+        {
+            if ( space( text[ i ] ) )
+            {
+                ++i;
+                continue;
+            }
+
+            // Find the end of the token.
+            auto end = i;
+
+            while ( end < text.size() && !space( text[ end ] ) )
+                ++end;
+
+            auto token = text.substr( i, end - i );
+            i = end;
+
+            if ( result.size == max_size )
+                return false;
+
+            if ( token.front() == '[' || token.back() == ']' )
+            {
+                if ( token.size() < 2 || token.front() != '[' || token.back() != ']' )
+                    return false;
+
+                token = token.substr( 1, token.size() - 2 );
+            }
+
+            // Collect every byte accepted by the alternatives of the token.
+            byte_class_t set{};
+            std::uint8_t value = 0, bits = 0;
+            std::size_t alternatives = 0;
+
+            while ( true )
+            {
+                auto bar = std::string_view::npos;
+
+                for ( std::size_t j = 0; j < token.size() && bar == std::string_view::npos; ++j )
+                {
+                    if ( token[ j ] == '|' )
+                        bar = j;
+                }
+
+                if ( !atom( token.substr( 0, bar ), value, bits ) )
+                    return false;
+
+                for ( std::size_t byte = 0; byte < 256; ++byte )
+                {
+                    if ( ( byte & bits ) == value )
+                        set.insert( static_cast< std::uint8_t >( byte ) );
+                }
+
+                ++alternatives;
+
+                if ( bar == std::string_view::npos )
+                    break;
+
+                token = token.substr( bar + 1 );
+            }
+
+            // Alternatives are stored as the bits that all accepted bytes agree on, and as a byte class if that isn't exact.
+            if ( alternatives > 1 )
+            {
+                std::uint8_t all = 0xFF, any = 0x00;
+
+                for ( std::size_t byte = 0; byte < 256; ++byte )
+                {
+                    if ( set.contains( static_cast< std::uint8_t >( byte ) ) )
+                    {
+                        all &= static_cast< std::uint8_t >( byte );
+                        any |= static_cast< std::uint8_t >( byte );
+                    }
+                }
+
+                bits = static_cast< std::uint8_t >( ~( all ^ any ) );
+                value = all & bits;
+
+                if ( set.count() != ( std::size_t( 1 ) << ( 8 - std::popcount( bits ) ) ) )
+                {
+                    if ( result.class_count == max_classes )
+                        return false;
+
+                    set.position = result.size;
+                    result.classes[ result.class_count++ ] = set;
+                }
+            }
+
+            result.atoms[ result.size++ ] = atom_t{ value, bits };
+        }
+
+        return true;
     }
 
-}  // namespace wincpp::patterns
\ No newline at end of file
+    namespace literals
+    {
+        /// <summary>
+        /// Parses an IDA or x64dbg style pattern string at compile time. Example: "48 8D 0D ?? ?? ?? ?? 4? 8D 55 F8"_sig
+        /// </summary>
+        /// <returns>The parsed pattern.</returns>
+        template< signature_string_t text >
+        consteval pattern_t operator""_sig() noexcept
+        {
+            constexpr auto result = []
+            {
+                pattern_t pattern;
+                const auto valid = pattern_t::parse( text.view(), pattern );
+
+                return std::pair{ valid, pattern };
+            }();
+
+            static_assert( result.first, "The pattern string could not be parsed." );
+            static_assert( result.second.size != 0, "The pattern string is empty." );
+
+            return result.second;
+        }
+    }  // namespace literals
+
+}  // namespace wincpp::patterns
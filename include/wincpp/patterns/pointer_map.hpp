@@ -0,0 +1,229 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "wincpp/patterns/scan_session.hpp"
+
+namespace wincpp::patterns
+{
+    /// <summary>
+    /// An image whose addresses are static for a pointer scan, e.g. a module. A path starts at a pointer inside one of them.
+    /// </summary>
+    struct pointer_image_t
+    {
+        /// <summary>
+        /// The name of the image, which identifies it across runs.
+        /// </summary>
+        std::string name;
+
+        /// <summary>
+        /// The address of the image in this run.
+        /// </summary>
+        std::uintptr_t address;
+
+        /// <summary>
+        /// The size of the image in bytes.
+        /// </summary>
+        std::size_t size;
+    };
+
+    /// <summary>
+    /// A chain of pointers from a static address to a target: the pointer at `offset` from the base of the image is read, the first offset is
+    /// added to it and the pointer there is read, and so on, until the last offset is added to the last pointer read.
+    /// </summary>
+    struct pointer_path_t
+    {
+        /// <summary>
+        /// The most pointers a path reads.
+        /// </summary>
+        static constexpr std::size_t max_depth = 8;
+
+        /// <summary>
+        /// The index of the image in the images of the map that found the path.
+        /// </summary>
+        std::uint32_t image;
+
+        /// <summary>
+        /// The number of pointers the path reads, and so of offsets.
+        /// </summary>
+        std::uint32_t depth;
+
+        /// <summary>
+        /// The offset of the first pointer from the base of the image.
+        /// </summary>
+        std::uintptr_t offset;
+
+        /// <summary>
+        /// The offset added to each pointer read.
+        /// </summary>
+        std::array< std::uint32_t, max_depth > offsets;
+
+        /// <summary>
+        /// Gets the offsets that the path uses.
+        /// </summary>
+        std::span< const std::uint32_t > used() const noexcept
+        {
+            return { offsets.data(), depth };
+        }
+
+        friend bool operator==( const pointer_path_t& left, const pointer_path_t& right ) noexcept
+        {
+            return left.image == right.image && left.offset == right.offset && std::ranges::equal( left.used(), right.used() );
+        }
+    };
+
+    /// <summary>
+    /// Options for finding pointer paths.
+    /// </summary>
+    struct pointer_scan_options_t
+    {
+        /// <summary>
+        /// The most pointers a path may read, at most `pointer_path_t::max_depth`.
+        /// </summary>
+        std::size_t max_depth = 5;
+
+        /// <summary>
+        /// The largest offset added to a pointer, i.e. how far into an object a field may lie.
+        /// </summary>
+        std::size_t max_offset = 0x1000;
+
+        /// <summary>
+        /// The maximum number of paths to produce.
+        /// </summary>
+        std::size_t limit = 1 << 20;
+    };
+
+    /// <summary>
+    /// A reverse map of the pointers in memory, from the address each one points at to the address it lies at, for finding the chains of
+    /// pointers that lead from static addresses to a dynamic one.
+    /// </summary>
+    /// <remarks>
+    /// <para>
+    /// The map is built in one pass over the pointer aligned values of the scanned ranges. The vectorized kernels of `filter_values` drop the
+    /// values outside the span of the ranges, which are the vast majority, and the rest are kept if they point into a range.
+    /// </para>
+    /// <para>
+    /// Paths are found breadth first: each level holds the pointers that point at most `max_offset` below a pointer of the level before,
+    /// starting from the target, and pointers in a static image end a path instead of joining the next level. Only then are the paths
+    /// enumerated, forward from their static ends, so no time is spent on the chains that never reach one.
+    /// </para>
+    /// <para>
+    /// Addresses change between runs, but good paths don't. A map saved in one run can take the paths found in another and keep those that
+    /// lead to the target of its own run as well, which prunes the ones that only held by chance.
+    /// </para>
+    /// </remarks>
+    class pointer_map final
+    {
+       public:
+        /// <summary>
+        /// Reads memory into a buffer, returning false if any of it can't be read.
+        /// </summary>
+        using reader_t = scan_session::reader_t;
+
+        /// <summary>
+        /// A range of memory to scan.
+        /// </summary>
+        using range_t = scan_session::range_t;
+
+        /// <summary>
+        /// Default constructor for the pointer map object. The map is empty.
+        /// </summary>
+        pointer_map() = default;
+
+        /// <summary>
+        /// Maps the pointers in the ranges that point into them.
+        /// </summary>
+        /// <param name="reader">The function to read the memory with.</param>
+        /// <param name="ranges">The ranges to scan, in ascending order and not overlapping.</param>
+        /// <param name="images">The images whose addresses are static.</param>
+        /// <param name="parallelize">Whether to use multiple threads to scan.</param>
+        pointer_map( const reader_t& reader, std::span< const range_t > ranges, std::vector< pointer_image_t > images, bool parallelize = true );
+
+        /// <summary>
+        /// Gets the number of pointers in the map.
+        /// </summary>
+        std::size_t size() const noexcept;
+
+        /// <summary>
+        /// Gets the number of bytes the map occupies.
+        /// </summary>
+        std::size_t memory_usage() const noexcept;
+
+        /// <summary>
+        /// Gets the static images, in ascending order of address.
+        /// </summary>
+        std::span< const pointer_image_t > images() const noexcept;
+
+        /// <summary>
+        /// Finds the paths from the static images to the target. Throws if the depth is zero or larger than `pointer_path_t::max_depth`, or if
+        /// the offset doesn't fit in 32 bits.
+        /// </summary>
+        /// <param name="target">The address to find paths to.</param>
+        /// <param name="options">The depth, offset and limit of the paths.</param>
+        /// <param name="parallelize">Whether to use multiple threads to search.</param>
+        /// <returns>The paths, shortest first. Which ones are returned when there are more than the limit isn't specified.</returns>
+        std::vector< pointer_path_t > find_paths( std::uintptr_t target, const pointer_scan_options_t& options = {}, bool parallelize = true ) const;
+
+        /// <summary>
+        /// Keeps the paths found in another map that lead to the target in this map as well. Images are matched by name, since their addresses
+        /// change between runs.
+        /// </summary>
+        /// <param name="paths">The paths.</param>
+        /// <param name="images">The images of the map that found the paths, which their image indices refer to.</param>
+        /// <param name="target">The address of the target in this map.</param>
+        /// <param name="parallelize">Whether to use multiple threads to check.</param>
+        /// <returns>The paths that are kept, unchanged and in their order.</returns>
+        std::vector< pointer_path_t > intersect(
+            std::span< const pointer_path_t > paths,
+            std::span< const pointer_image_t > images,
+            std::uintptr_t target,
+            bool parallelize = true ) const;
+
+        /// <summary>
+        /// Writes the map to a file. The file is written next to the path and renamed over it, so a failed save never leaves a truncated file
+        /// behind.
+        /// </summary>
+        /// <param name="path">The path of the map file.</param>
+        /// <returns>True if the file was written.</returns>
+        bool save( const std::filesystem::path& path ) const noexcept;
+
+        /// <summary>
+        /// Reads a map from a file written by `save`.
+        /// </summary>
+        /// <param name="path">The path of the map file.</param>
+        /// <returns>The map, or nothing if the file doesn't exist or is corrupt.</returns>
+        static std::optional< pointer_map > load( const std::filesystem::path& path ) noexcept;
+
+       private:
+        /// <summary>
+        /// A pointer: the address it points at and the address it lies at.
+        /// </summary>
+        struct entry_t
+        {
+            std::uintptr_t target, source;
+
+            friend auto operator<=>( const entry_t&, const entry_t& ) = default;
+        };
+
+        /// <summary>
+        /// Gets the pointers whose target lies in [low, high].
+        /// </summary>
+        std::span< const entry_t > pointing_into( std::uintptr_t low, std::uintptr_t high ) const noexcept;
+
+        /// <summary>
+        /// Gets the index of the image that holds the address.
+        /// </summary>
+        std::optional< std::uint32_t > image_of( std::uintptr_t address ) const noexcept;
+
+        // The pointers in ascending order of target, then source.
+        std::vector< entry_t > _entries;
+        std::vector< pointer_image_t > _images;
+    };
+}  // namespace wincpp::patterns
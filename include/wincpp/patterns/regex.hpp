@@ -0,0 +1,161 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "wincpp/patterns/pattern.hpp"
+
+namespace wincpp::patterns
+{
+    /// <summary>
+    /// A byte pattern with variable-length parts, e.g. a call followed by a test within the next 16 bytes. The expression is compiled to an
+    /// automaton that is turned into a DFA lazily while scanning, so every buffer is scanned in a single linear pass.
+    /// </summary>
+    /// <remarks>
+    /// Every repeat is bounded, so a match is never longer than `max_size()`. Matches are reported in order of their end, each one ending as
+    /// early as possible and then starting as early as possible, and don't overlap.
+    /// </remarks>
+    class regex_t final
+    {
+       public:
+        /// <summary>
+        /// A single occurrence of the expression in the buffer.
+        /// </summary>
+        struct match_t
+        {
+            /// <summary>
+            /// The relative location of the match.
+            /// </summary>
+            std::uintptr_t offset;
+
+            /// <summary>
+            /// The number of bytes matched.
+            /// </summary>
+            std::size_t size;
+        };
+
+        /// <summary>
+        /// The largest count allowed in a repeat.
+        /// </summary>
+        static constexpr std::size_t max_repeat = 256;
+
+        /// <summary>
+        /// The largest number of automaton states an expression may compile to, after its repeats are expanded.
+        /// </summary>
+        static constexpr std::size_t max_states = 1 << 16;
+
+        /// <summary>
+        /// The number of DFA states kept while scanning. When the cache is full it is flushed and rebuilt from the current state, so an
+        /// expression with an exponential DFA still scans in bounded memory.
+        /// </summary>
+        static constexpr std::size_t max_cached_states = 4096;
+
+        /// <summary>
+        /// Default constructor for the regex object. It never matches.
+        /// </summary>
+        regex_t() = default;
+
+        /// <summary>
+        /// Compiles an expression. The atoms are the tokens of `pattern_t::parse` (`48`, `?`, `4?`, `[48|4C]`, `E8|E9`), and can be combined with:
+        /// <list type="bullet">
+        /// <item>`( ... )` to group a sequence</item>
+        /// <item>a `|` on its own, e.g. `(E8 ? ? ? ? | FF 15 ? ? ? ?)`, to choose between sequences</item>
+        /// <item>`{n}`, `{n,m}` or `{,m}` after an atom or group to repeat it, e.g. `?{0,16}`</item>
+        /// </list>
+        /// Example: "E8 ? ? ? ? ?{0,16} 48 85 C0"
+        /// </summary>
+        /// <param name="text">The expression.</param>
+        explicit regex_t( std::string_view text );
+
+        /// <summary>
+        /// Gets the length of the shortest match.
+        /// </summary>
+        std::size_t min_size() const noexcept;
+
+        /// <summary>
+        /// Gets the length of the longest match.
+        /// </summary>
+        std::size_t max_size() const noexcept;
+
+        /// <summary>
+        /// Searches for the first occurrence of the expression in the buffer.
+        /// </summary>
+        /// <param name="buffer">The buffer to search in.</param>
+        /// <returns>The first match.</returns>
+        std::optional< match_t > find( std::span< std::uint8_t > buffer ) const noexcept;
+
+        /// <summary>
+        /// Searches for all occurrences of the expression in the buffer.
+        /// </summary>
+        /// <param name="buffer">The buffer to search in.</param>
+        /// <returns>The matches, in order.</returns>
+        std::vector< match_t > find_all( std::span< std::uint8_t > buffer ) const noexcept;
+
+        /// <summary>
+        /// A state of the compiled automaton.
+        /// </summary>
+        struct state_t
+        {
+            /// <summary>
+            /// The different types of states.
+            /// </summary>
+            enum class type_t : std::uint8_t
+            {
+                /// <summary>
+                /// Consumes a byte of `sets[ set ]` and moves to `out`.
+                /// </summary>
+                byte_t,
+
+                /// <summary>
+                /// Moves to both `out` and `alternate` without consuming a byte.
+                /// </summary>
+                split_t,
+
+                /// <summary>
+                /// Moves to `out` without consuming a byte.
+                /// </summary>
+                empty_t,
+
+                /// <summary>
+                /// Accepts.
+                /// </summary>
+                match_t
+            };
+
+            type_t type;
+            std::uint32_t set, out, alternate;
+        };
+
+        /// <summary>
+        /// An automaton over the byte sets of the expression.
+        /// </summary>
+        struct program_t
+        {
+            std::vector< state_t > states;
+            std::uint32_t start = 0;
+        };
+
+       private:
+        /// <summary>
+        /// Scans forward from the offset for the earliest end of a match, then backward from it for the earliest start.
+        /// </summary>
+        template< typename callback_t >
+        void scan( std::span< std::uint8_t > buffer, callback_t&& callback ) const noexcept;
+
+        // The byte sets of the expression, and the partition of all bytes into classes that no set tells apart.
+        std::vector< byte_class_t > sets;
+        std::array< std::uint8_t, 256 > classes{};
+        std::size_t class_count = 0;
+
+        // The bytes that can begin a match, for skipping ahead while the scan is in its start state.
+        byte_class_t first;
+
+        // The expression, and the expression reversed for finding where a match starts.
+        program_t forward, backward;
+
+        std::size_t _min_size = 0, _max_size = 0;
+    };
+}  // namespace wincpp::patterns
@@ -0,0 +1,219 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "wincpp/patterns/page_store.hpp"
+#include "wincpp/patterns/values.hpp"
+
+namespace wincpp::patterns
+{
+    /// <summary>
+    /// The candidates of a value scan, narrowed by one query or change after another, e.g. to find a counter by scanning for its value and then
+    /// for its changes until a handful of addresses are left.
+    /// </summary>
+    /// <remarks>
+    /// <para>
+    /// The scanned memory is split into blocks of `block_size` bytes, and only the blocks that still hold a candidate are kept. A block with
+    /// many candidates keeps one bit per value and a copy of its bytes; a block with a few keeps their offsets and values. Either costs a small
+    /// fraction of the 16 bytes per candidate of an address and a value, and the copy is what "changed" and friends compare against.
+    /// </para>
+    /// <para>
+    /// Each pass reads the adjacent blocks that are left in runs, so a run costs one read however many candidates it holds, and narrows the
+    /// bits a word at a time with `filter_values`, skipping the words whose candidates are all gone.
+    /// </para>
+    /// <para>
+    /// A scan for an unknown initial value starts with every value as a candidate, i.e. with a copy of all of the scanned memory. That copy is
+    /// kept compressed a block per page in a `page_store`, in memory or in a file, and so are the copies of the dense blocks from then on.
+    /// </para>
+    /// </remarks>
+    class scan_session final
+    {
+       public:
+        /// <summary>
+        /// Reads memory into a buffer, returning false if any of it can't be read.
+        /// </summary>
+        using reader_t = std::function< bool( std::uintptr_t address, std::size_t size, std::uint8_t* buffer ) >;
+
+        /// <summary>
+        /// A range of memory to scan.
+        /// </summary>
+        struct range_t
+        {
+            std::uintptr_t address;
+            std::size_t size;
+        };
+
+        /// <summary>
+        /// The size of the blocks that the candidates are kept in. Alignments must not be larger.
+        /// </summary>
+        static constexpr std::size_t block_size = 4096;
+
+        /// <summary>
+        /// Scans the ranges for the values that the query accepts. Throws if the alignment of the query is larger than `block_size`.
+        /// </summary>
+        /// <param name="reader">The function to read the memory with, now and in every later pass.</param>
+        /// <param name="ranges">The ranges to scan, in ascending order and not overlapping.</param>
+        /// <param name="query">The query.</param>
+        /// <param name="parallelize">Whether to use multiple threads to scan.</param>
+        scan_session( reader_t reader, std::span< const range_t > ranges, const value_query_t& query, bool parallelize = true );
+
+        /// <summary>
+        /// Takes a snapshot of the ranges for a scan whose initial value is unknown: every value of the type at the alignment is a candidate
+        /// until the first change or query narrows them. Throws if the alignment isn't a power of two up to `block_size`, or if the file of
+        /// the snapshot can't be created.
+        /// </summary>
+        /// <param name="reader">The function to read the memory with, now and in every later pass.</param>
+        /// <param name="ranges">The ranges to scan, in ascending order and not overlapping.</param>
+        /// <param name="type">The type of the values.</param>
+        /// <param name="alignment">The alignment of the values, relative to the start of each range.</param>
+        /// <param name="spill">The file to keep the snapshot in, or an empty path to keep it in memory.</param>
+        /// <param name="parallelize">Whether to use multiple threads to scan.</param>
+        scan_session(
+            reader_t reader,
+            std::span< const range_t > ranges,
+            value_type_t type,
+            std::size_t alignment,
+            const std::filesystem::path& spill = {},
+            bool parallelize = true );
+
+        /// <summary>
+        /// Keeps the candidates whose current value the query accepts. Throws if the query is for another type than the first scan. The
+        /// alignment of the query doesn't apply.
+        /// </summary>
+        /// <param name="query">The query.</param>
+        /// <param name="parallelize">Whether to use multiple threads to scan.</param>
+        /// <returns>The number of candidates left.</returns>
+        std::size_t next( const value_query_t& query, bool parallelize = true );
+
+        /// <summary>
+        /// Keeps the candidates whose value changed in the given way since the last pass.
+        /// </summary>
+        /// <param name="change">The change to keep.</param>
+        /// <param name="parallelize">Whether to use multiple threads to scan.</param>
+        /// <returns>The number of candidates left.</returns>
+        std::size_t next( value_change_t change, bool parallelize = true );
+
+        /// <summary>
+        /// Gets the number of candidates left.
+        /// </summary>
+        std::size_t count() const noexcept;
+
+        /// <summary>
+        /// Gets the type of the values.
+        /// </summary>
+        value_type_t type() const noexcept;
+
+        /// <summary>
+        /// Gets the addresses of the candidates.
+        /// </summary>
+        /// <param name="limit">The maximum number of addresses to return.</param>
+        /// <returns>The addresses of the first candidates, in ascending order.</returns>
+        std::vector< std::uintptr_t > addresses( std::size_t limit = std::numeric_limits< std::size_t >::max() ) const;
+
+        /// <summary>
+        /// Gets the number of bytes the candidates occupy in memory, including the snapshot if it is kept there.
+        /// </summary>
+        std::size_t memory_usage() const noexcept;
+
+       private:
+        /// <summary>
+        /// The candidates in a block. Dense blocks hold one bit set per offset within a value that the alignment allows, each over the values
+        /// that start at that offset, and the bytes of the block unless they are in the store. Sparse blocks hold the offsets of the candidates
+        /// and their values. Blocks with neither are unknown: every value in them is a candidate, and their bytes are in the store.
+        /// </summary>
+        struct block_t
+        {
+            std::uintptr_t address;
+
+            // The size of the block, and the number of bytes read past it so that the values which start at its end are whole.
+            std::uint16_t size, tail;
+            std::uint32_t count;
+
+            // The slot of the block in the store.
+            std::uint32_t slot;
+
+            std::vector< std::uint64_t > bits;
+            std::vector< std::uint16_t > offsets;
+            std::vector< std::uint8_t > values;
+
+            /// <summary>
+            /// Gets whether the block holds bit sets.
+            /// </summary>
+            bool dense() const noexcept
+            {
+                return !bits.empty();
+            }
+        };
+
+        /// <summary>
+        /// Gets the number of bytes between the first values of two bit sets, and the number of bit sets in a dense block.
+        /// </summary>
+        std::size_t step() const noexcept;
+        std::size_t shifts() const noexcept;
+
+        /// <summary>
+        /// Gets the number of words of each bit set in a dense block.
+        /// </summary>
+        std::size_t words() const noexcept;
+
+        /// <summary>
+        /// Splits the ranges into unknown blocks.
+        /// </summary>
+        void split( std::span< const range_t > ranges );
+
+        /// <summary>
+        /// Counts the values the alignment allows in a block.
+        /// </summary>
+        std::size_t unknown_count( const block_t& block ) const noexcept;
+
+        /// <summary>
+        /// Sets the bits of every value the alignment allows in a block.
+        /// </summary>
+        void seed( block_t& block ) const;
+
+        /// <summary>
+        /// Gets the offsets of the candidates of a dense block, in ascending order.
+        /// </summary>
+        std::vector< std::uintptr_t > offsets_of( const block_t& block ) const;
+
+        /// <summary>
+        /// Turns a dense block into a sparse one, given its current bytes.
+        /// </summary>
+        void sparsify( block_t& block, const std::uint8_t* bytes ) const;
+
+        /// <summary>
+        /// Drops the candidates of a block.
+        /// </summary>
+        void drop( block_t& block ) const noexcept;
+
+        /// <summary>
+        /// Stops reading past the end of a block whose tail can't be read, and drops the candidates that end in it.
+        /// </summary>
+        void drop_tail( block_t& block ) const;
+
+        /// <summary>
+        /// Narrows the candidates of a block given its current bytes, with the filter of a query or a change.
+        /// </summary>
+        template< typename filter_t >
+        void narrow( block_t& block, const std::uint8_t* bytes, filter_t&& filter ) const;
+
+        /// <summary>
+        /// Reads the runs of adjacent blocks and narrows each with the callback, dropping the candidates of the blocks that can't be read.
+        /// </summary>
+        template< typename callback_t >
+        std::size_t pass( bool parallelize, callback_t&& callback );
+
+        reader_t _reader;
+        value_type_t _type;
+        std::size_t _alignment;
+        std::size_t _count = 0;
+        std::vector< block_t > _blocks;
+        std::unique_ptr< page_store > _store;
+    };
+}  // namespace wincpp::patterns
@@ -1,15 +1,92 @@
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <execution>
 #include <iostream>
+#include <iterator>
+#include <limits>
 #include <memory>
 #include <optional>
 #include <span>
+#include <string_view>
+#include <type_traits>
 #include <vector>
 
+#include "wincpp/patterns/compiled_pattern.hpp"
 #include "wincpp/patterns/pattern.hpp"
 
 namespace wincpp::patterns
 {
+    /// <summary>
+    /// Options for enumerating the matches of a pattern.
+    /// </summary>
+    struct scan_options_t
+    {
+        /// <summary>
+        /// The maximum number of matches to produce.
+        /// </summary>
+        std::size_t limit = std::numeric_limits< std::size_t >::max();
+
+        /// <summary>
+        /// Whether matches may overlap. If false, scanning resumes after the end of each match.
+        /// </summary>
+        bool overlapping = true;
+    };
+
+    /// <summary>
+    /// A location where a pattern matches with some positions wrong.
+    /// </summary>
+    struct approx_match_t
+    {
+        /// <summary>
+        /// The relative location of the match.
+        /// </summary>
+        std::uintptr_t offset;
+
+        /// <summary>
+        /// The number of positions of the pattern that don't accept their byte.
+        /// </summary>
+        std::size_t distance;
+    };
+
+    /// <summary>
+    /// The encodings `scanner::find_string` searches for. Letters match either case in both encodings.
+    /// </summary>
+    enum class string_encoding_t : std::uint8_t
+    {
+        /// <summary>
+        /// One byte per character.
+        /// </summary>
+        ascii_nocase_t = 1 << 0,
+
+        /// <summary>
+        /// Two bytes per character, low byte first, with a zero high byte. This is how Windows stores ASCII text in wide strings.
+        /// </summary>
+        utf16le_t = 1 << 1,
+
+        /// <summary>
+        /// Both encodings, found in the same pass.
+        /// </summary>
+        both_t = ascii_nocase_t | utf16le_t
+    };
+
+    /// <summary>
+    /// A location where a string occurs.
+    /// </summary>
+    struct string_match_t
+    {
+        /// <summary>
+        /// The relative location of the first byte of the string.
+        /// </summary>
+        std::uintptr_t offset;
+
+        /// <summary>
+        /// The encoding the string occurs in, either `ascii_nocase_t` or `utf16le_t`.
+        /// </summary>
+        string_encoding_t encoding;
+    };
+
     /// <summary>
     /// Scans a buffer of bytes for a pattern.
     /// </summary>
@@ -21,6 +98,34 @@ namespace wincpp::patterns
         /// </summary>
         enum class algorithm_t;
 
+        /// <summary>
+        /// The thresholds `auto_t` uses to pick an algorithm. The defaults were measured with `calibrate` on x86-64 code.
+        /// </summary>
+        struct tuning_t
+        {
+            /// <summary>
+            /// Buffers up to this size are scanned with the naive algorithm, which has no setup cost.
+            /// </summary>
+            std::size_t small_buffer_size;
+
+            /// <summary>
+            /// Without vector instructions, patterns use BNDM from this size on, and Shift-Or below it.
+            /// </summary>
+            std::size_t min_bndm_size;
+
+            /// <summary>
+            /// The largest percentage of positions that aren't strict bytes for which BNDM is used. Every wildcard shortens the shifts of
+            /// BNDM, while Shift-Or costs the same whatever the pattern.
+            /// </summary>
+            std::uint8_t max_bndm_wildcards;
+        };
+
+        /// <summary>
+        /// A lazy range over the relative locations of a pattern in a buffer. Each increment scans only up to the next match.
+        /// </summary>
+        template< algorithm_t algorithm >
+        class match_range;
+
         /// <summary>
         /// Searches for the pattern in the buffer.
         /// </summary>
@@ -41,7 +146,204 @@ namespace wincpp::patterns
         template< algorithm_t algorithm >
         static std::vector< std::uintptr_t > find_all( std::span< std::uint8_t > buffer, const pattern_t& pattern ) noexcept;
 
+        /// <summary>
+        /// Searches for the compiled pattern in the buffer.
+        /// </summary>
+        /// <param name="buffer">The buffer to search in.</param>
+        /// <param name="pattern">The compiled pattern to search for.</param>
+        /// <param name="algorithm">The algorithm to use.</param>
+        /// <returns>The relative location.</returns>
+        template< algorithm_t algorithm >
+        static std::optional< std::uintptr_t > find( std::span< std::uint8_t > buffer, const compiled_pattern_t& pattern ) noexcept;
+
+        /// <summary>
+        /// Searches for all occurrences of the compiled pattern in the buffer.
+        /// </summary>
+        /// <param name="buffer">The buffer to search in.</param>
+        /// <param name="pattern">The compiled pattern to search for.</param>
+        /// <param name="algorithm">The algorithm to use.</param>
+        /// <returns>The relative locations.</returns>
+        template< algorithm_t algorithm >
+        static std::vector< std::uintptr_t > find_all( std::span< std::uint8_t > buffer, const compiled_pattern_t& pattern ) noexcept;
+
+        /// <summary>
+        /// Lazily enumerates the occurrences of the pattern in the buffer. The buffer must outlive the range.
+        /// </summary>
+        /// <param name="buffer">The buffer to search in.</param>
+        /// <param name="pattern">The pattern to search for.</param>
+        /// <param name="options">The limit and overlap options.</param>
+        /// <returns>The range of relative locations, in ascending order.</returns>
+        template< algorithm_t algorithm >
+        static match_range< algorithm > matches( std::span< std::uint8_t > buffer, const pattern_t& pattern, scan_options_t options = {} );
+
+        /// <summary>
+        /// Lazily enumerates the occurrences of the compiled pattern in the buffer. The buffer and the compiled pattern must outlive the range.
+        /// </summary>
+        /// <param name="buffer">The buffer to search in.</param>
+        /// <param name="pattern">The compiled pattern to search for.</param>
+        /// <param name="options">The limit and overlap options.</param>
+        /// <returns>The range of relative locations, in ascending order.</returns>
+        template< algorithm_t algorithm >
+        static match_range< algorithm >
+        matches( std::span< std::uint8_t > buffer, const compiled_pattern_t& pattern, scan_options_t options = {} ) noexcept;
+
+        /// <summary>
+        /// Counts the occurrences of the pattern in the buffer without allocating. Use `limit` to stop early, e.g. a limit of 2 is enough to
+        /// tell if a pattern is unique.
+        /// </summary>
+        /// <param name="buffer">The buffer to search in.</param>
+        /// <param name="pattern">The compiled pattern to search for.</param>
+        /// <param name="options">The limit and overlap options.</param>
+        /// <returns>The number of occurrences, at most `limit`.</returns>
+        template< algorithm_t algorithm >
+        static std::size_t count( std::span< std::uint8_t > buffer, const compiled_pattern_t& pattern, scan_options_t options = {} ) noexcept;
+
+        /// <summary>
+        /// Searches for the pattern in the buffer, scanning chunks of it with the execution policy.
+        /// </summary>
+        /// <param name="policy">The execution policy, e.g. `std::execution::par`.</param>
+        /// <param name="buffer">The buffer to search in.</param>
+        /// <param name="pattern">The pattern to search for.</param>
+        /// <returns>The relative location.</returns>
+        template< algorithm_t algorithm, typename execution_policy_t >
+            requires std::is_execution_policy_v< std::remove_cvref_t< execution_policy_t > >
+        static std::optional< std::uintptr_t >
+        find( execution_policy_t&& policy, std::span< std::uint8_t > buffer, const pattern_t& pattern ) noexcept;
+
+        /// <summary>
+        /// Searches for all occurrences of the pattern in the buffer, scanning chunks of it with the execution policy.
+        /// </summary>
+        /// <param name="policy">The execution policy, e.g. `std::execution::par`.</param>
+        /// <param name="buffer">The buffer to search in.</param>
+        /// <param name="pattern">The pattern to search for.</param>
+        /// <returns>The relative locations.</returns>
+        template< algorithm_t algorithm, typename execution_policy_t >
+            requires std::is_execution_policy_v< std::remove_cvref_t< execution_policy_t > >
+        static std::vector< std::uintptr_t >
+        find_all( execution_policy_t&& policy, std::span< std::uint8_t > buffer, const pattern_t& pattern ) noexcept;
+
+        /// <summary>
+        /// Searches for the compiled pattern in the buffer, splitting it into chunks of `chunk_size` bytes that are scanned with the execution
+        /// policy. Chunks overlap by `pattern.size() - 1` bytes so matches across a boundary are found, and the lowest match is returned.
+        /// </summary>
+        /// <param name="policy">The execution policy, e.g. `std::execution::par`.</param>
+        /// <param name="buffer">The buffer to search in.</param>
+        /// <param name="pattern">The compiled pattern to search for.</param>
+        /// <returns>The relative location.</returns>
+        template< algorithm_t algorithm, typename execution_policy_t >
+            requires std::is_execution_policy_v< std::remove_cvref_t< execution_policy_t > >
+        static std::optional< std::uintptr_t >
+        find( execution_policy_t&& policy, std::span< std::uint8_t > buffer, const compiled_pattern_t& pattern ) noexcept;
+
+        /// <summary>
+        /// Searches for all occurrences of the compiled pattern in the buffer, splitting it into chunks of `chunk_size` bytes that are scanned
+        /// with the execution policy. The results are in ascending order.
+        /// </summary>
+        /// <param name="policy">The execution policy, e.g. `std::execution::par`.</param>
+        /// <param name="buffer">The buffer to search in.</param>
+        /// <param name="pattern">The compiled pattern to search for.</param>
+        /// <returns>The relative locations.</returns>
+        template< algorithm_t algorithm, typename execution_policy_t >
+            requires std::is_execution_policy_v< std::remove_cvref_t< execution_policy_t > >
+        static std::vector< std::uintptr_t >
+        find_all( execution_policy_t&& policy, std::span< std::uint8_t > buffer, const compiled_pattern_t& pattern ) noexcept;
+
+        /// <summary>
+        /// Searches for the locations where the pattern matches with at most `k` wrong positions, e.g. to recover a signature after an
+        /// update changed a register or an immediate. Wildcards never count as wrong.
+        /// </summary>
+        /// <remarks>
+        /// The positions that aren't wildcards are split into `k + 1` pieces. At least one piece must match exactly, so the pieces are
+        /// searched for with the exact scanners and only their hits are verified. This stays close to the speed of an exact search while
+        /// each piece has a few strict bytes left. Only the best `limit` matches are kept while verifying, so the memory used is bounded by
+        /// the limit rather than by the buffer.
+        /// </remarks>
+        /// <param name="buffer">The buffer to search in.</param>
+        /// <param name="pattern">The pattern to search for.</param>
+        /// <param name="k">The maximum number of wrong positions. It is clamped to one less than the number of positions that aren't
+        /// wildcards, so at least one of them must be right, and a pattern made up of wildcards finds nothing.</param>
+        /// <param name="limit">The maximum number of matches to return.</param>
+        /// <returns>The best matches, ordered by distance and then by location.</returns>
+        static std::vector< approx_match_t > find_approx(
+            std::span< std::uint8_t > buffer,
+            const pattern_t& pattern,
+            std::size_t k,
+            std::size_t limit = std::numeric_limits< std::size_t >::max() ) noexcept;
+
+        /// <summary>
+        /// Searches for the string in the encodings, ignoring the case of ASCII letters. The characters of the string are taken as code points
+        /// below 256, so a byte above 0x7F must match exactly and, in UTF-16LE, with a zero high byte.
+        /// </summary>
+        /// <param name="buffer">The buffer to search in.</param>
+        /// <param name="text">The string to search for.</param>
+        /// <param name="encoding">The encodings to search for.</param>
+        /// <returns>The first match.</returns>
+        static std::optional< string_match_t >
+        find_string( std::span< std::uint8_t > buffer, std::string_view text, string_encoding_t encoding = string_encoding_t::both_t ) noexcept;
+
+        /// <summary>
+        /// Searches for every occurrence of the string in the encodings, ignoring the case of ASCII letters.
+        /// </summary>
+        /// <remarks>
+        /// The vectorized kernels compare the first and last character at every position of a block in a single pass for both encodings. The
+        /// zero high byte of the first UTF-16LE character is compared in the same pass, and only the positions where every comparison passes
+        /// are verified.
+        /// </remarks>
+        /// <param name="buffer">The buffer to search in.</param>
+        /// <param name="text">The string to search for.</param>
+        /// <param name="encoding">The encodings to search for.</param>
+        /// <param name="limit">The maximum number of matches to return.</param>
+        /// <returns>The matches in ascending order. A match in both encodings at the same location lists the ASCII match first.</returns>
+        static std::vector< string_match_t > find_all_strings(
+            std::span< std::uint8_t > buffer,
+            std::string_view text,
+            string_encoding_t encoding = string_encoding_t::both_t,
+            std::size_t limit = std::numeric_limits< std::size_t >::max() ) noexcept;
+
+        /// <summary>
+        /// Picks the algorithm that `auto_t` uses for the compiled pattern and buffer size. Looks at the buffer size, the CPU, the pattern
+        /// size and the share of its positions that are wildcards. With vector instructions, the vectorized search is used for every buffer
+        /// that isn't small: measured on code, data and random bytes, it was never slower than BNDM or Shift-Or by enough to pay for
+        /// picking them, whatever the rarity of the anchors.
+        /// </summary>
+        /// <param name="pattern">The compiled pattern.</param>
+        /// <param name="size">The size of the buffer in bytes.</param>
+        /// <returns>The algorithm to use.</returns>
+        static algorithm_t select( const compiled_pattern_t& pattern, std::size_t size ) noexcept;
+
+        /// <summary>
+        /// Gets the thresholds that `auto_t` currently uses.
+        /// </summary>
+        static tuning_t tuning() noexcept;
+
+        /// <summary>
+        /// Replaces the thresholds that `auto_t` uses.
+        /// </summary>
+        /// <param name="tuning">The new thresholds.</param>
+        static void tune( const tuning_t& tuning ) noexcept;
+
+        /// <summary>
+        /// Measures the algorithms against each other on the sample and fits the thresholds to the results. The sample should be
+        /// representative of what will be scanned, e.g. the code section of a module, and at least 64 KiB. Takes up to a second.
+        /// </summary>
+        /// <param name="sample">The sample to benchmark on.</param>
+        /// <returns>The fitted thresholds. They are not applied until passed to `tune`.</returns>
+        static tuning_t calibrate( std::span< std::uint8_t > sample ) noexcept;
+
+        /// <summary>
+        /// The number of bytes each chunk of a parallel scan starts matches in. Sized to stay in the L2 cache of a core.
+        /// </summary>
+        static constexpr std::size_t chunk_size = 256 * 1024;
+
        private:
+        /// <summary>
+        /// Splits the buffer into chunks of `chunk_size` bytes, each extended by the overlap so that a match starting in the chunk fits.
+        /// </summary>
+        /// <param name="buffer">The buffer to split.</param>
+        /// <param name="overlap">The number of bytes to extend each chunk by.</param>
+        /// <returns>The chunks in ascending order.</returns>
+        static std::vector< std::span< std::uint8_t > > chunks_of( std::span< std::uint8_t > buffer, std::size_t overlap ) noexcept;
+
         /// <summary>
         /// Find the index of the pattern in the buffer.
         /// </summary>
@@ -51,7 +353,7 @@ namespace wincpp::patterns
         /// <param name="size">The size of the buffer in bytes.</param>
         /// <returns>A value greater than or equal to zero if success.</returns>
         template< algorithm_t algorithm >
-        static std::int64_t index_of( const pattern_t& pattern, const std::span< std::uint8_t >& span ) noexcept;
+        static std::int64_t index_of( const compiled_pattern_t& pattern, const std::span< std::uint8_t >& span ) noexcept;
     };
 
     enum class scanner::algorithm_t
@@ -74,39 +376,92 @@ namespace wincpp::patterns
         /// <summary>
         /// The Turo-BM algorithm for scanning.
         /// </summary>
-        tbm_t
+        tbm_t,
+
+        /// <summary>
+        /// Vectorized anchor-byte search with a masked verify. Uses the widest of SSE2, AVX2 or AVX-512 that the CPU supports.
+        /// </summary>
+        simd_t,
+
+        /// <summary>
+        /// The Backward Nondeterministic DAWG Matching algorithm for scanning. Bit-parallel, so wildcards don't shorten its shifts as much as
+        /// they do for the Boyer-Moore family.
+        /// </summary>
+        bndm_t,
+
+        /// <summary>
+        /// The Shift-Or algorithm for scanning. Bit-parallel and branch-free per byte, wildcards cost nothing extra.
+        /// </summary>
+        shift_or_t,
+
+        /// <summary>
+        /// Picks one of the other algorithms for each scan with `scanner::select`.
+        /// </summary>
+        auto_t
     };
 
     /// <summary>
     /// The naive algorithm for scanning.
     /// </summary>
     template<>
-    static std::int64_t scanner::index_of< scanner::algorithm_t::naive_t >(
-        const pattern_t& pattern,
-        const std::span< std::uint8_t >& bytes ) noexcept;
+    std::int64_t scanner::index_of< scanner::algorithm_t::naive_t >( const compiled_pattern_t& pattern, const std::span< std::uint8_t >& bytes ) noexcept;
 
     /// <summary>
     /// The Boyer-Moore-Horspool algorithm for scanning.
     /// </summary>
     template<>
-    static std::int64_t scanner::index_of< scanner::algorithm_t::bmh_t >( const pattern_t& pattern, const std::span< std::uint8_t >& bytes ) noexcept;
+    std::int64_t scanner::index_of< scanner::algorithm_t::bmh_t >( const compiled_pattern_t& pattern, const std::span< std::uint8_t >& bytes ) noexcept;
 
     /// <summary>
     /// The Turbo-BM algorithm for scanning.
     /// </summary>
     template<>
-    static std::int64_t scanner::index_of< scanner::algorithm_t::tbm_t >( const pattern_t& pattern, const std::span< std::uint8_t >& bytes ) noexcept;
+    std::int64_t scanner::index_of< scanner::algorithm_t::tbm_t >( const compiled_pattern_t& pattern, const std::span< std::uint8_t >& bytes ) noexcept;
 
     /// <summary>
     /// The Raita algorithm for scanning.
     /// </summary>
     template<>
-    static std::int64_t scanner::index_of< scanner::algorithm_t::raita_t >(
-        const pattern_t& pattern,
-        const std::span< std::uint8_t >& bytes ) noexcept;
+    std::int64_t scanner::index_of< scanner::algorithm_t::raita_t >( const compiled_pattern_t& pattern, const std::span< std::uint8_t >& bytes ) noexcept;
+
+    /// <summary>
+    /// The vectorized algorithm for scanning.
+    /// </summary>
+    template<>
+    std::int64_t scanner::index_of< scanner::algorithm_t::simd_t >( const compiled_pattern_t& pattern, const std::span< std::uint8_t >& bytes ) noexcept;
+
+    /// <summary>
+    /// The BNDM algorithm for scanning.
+    /// </summary>
+    template<>
+    std::int64_t scanner::index_of< scanner::algorithm_t::bndm_t >( const compiled_pattern_t& pattern, const std::span< std::uint8_t >& bytes ) noexcept;
+
+    /// <summary>
+    /// The Shift-Or algorithm for scanning.
+    /// </summary>
+    template<>
+    std::int64_t scanner::index_of< scanner::algorithm_t::shift_or_t >( const compiled_pattern_t& pattern, const std::span< std::uint8_t >& bytes ) noexcept;
+
+    /// <summary>
+    /// The adaptive algorithm for scanning.
+    /// </summary>
+    template<>
+    std::int64_t scanner::index_of< scanner::algorithm_t::auto_t >( const compiled_pattern_t& pattern, const std::span< std::uint8_t >& bytes ) noexcept;
 
     template< scanner::algorithm_t algorithm >
     std::optional< std::uintptr_t > scanner::find( std::span< std::uint8_t > buffer, const pattern_t& pattern ) noexcept
+    {
+        return scanner::find< algorithm >( buffer, compiled_pattern_t( pattern ) );
+    }
+
+    template< scanner::algorithm_t algorithm >
+    std::vector< std::uintptr_t > scanner::find_all( std::span< std::uint8_t > buffer, const pattern_t& pattern ) noexcept
+    {
+        return scanner::find_all< algorithm >( buffer, compiled_pattern_t( pattern ) );
+    }
+
+    template< scanner::algorithm_t algorithm >
+    std::optional< std::uintptr_t > scanner::find( std::span< std::uint8_t > buffer, const compiled_pattern_t& pattern ) noexcept
     {
         const auto result = scanner::index_of< algorithm >( pattern, buffer );
 
@@ -117,22 +472,269 @@ namespace wincpp::patterns
     }
 
     template< scanner::algorithm_t algorithm >
-    std::vector< std::uintptr_t > scanner::find_all( std::span< std::uint8_t > buffer, const pattern_t& pattern ) noexcept
+    std::vector< std::uintptr_t > scanner::find_all( std::span< std::uint8_t > buffer, const compiled_pattern_t& pattern ) noexcept
     {
         std::vector< std::uintptr_t > results;
 
-        for ( auto i = 0; i < buffer.size(); )
+        for ( const auto result : scanner::matches< algorithm >( buffer, pattern ) )
+            results.push_back( result );
+
+        return results;
+    }
+
+    template< scanner::algorithm_t algorithm >
+    class scanner::match_range final
+    {
+       public:
+        /// <summary>
+        /// The iterator of the range. Advancing it runs the scan up to the next match.
+        /// </summary>
+        class iterator final
+        {
+           public:
+            using value_type = std::uintptr_t;
+            using difference_type = std::ptrdiff_t;
+            using iterator_concept = std::input_iterator_tag;
+
+            iterator() noexcept = default;
+
+            /// <summary>
+            /// Gets the relative location of the current match.
+            /// </summary>
+            std::uintptr_t operator*() const noexcept
+            {
+                return location;
+            }
+
+            /// <summary>
+            /// Scans for the next match.
+            /// </summary>
+            iterator& operator++() noexcept
+            {
+                const auto step = range->options.overlapping ? 1 : range->pattern->size();
+                return seek( location + step );
+            }
+
+            /// <summary>
+            /// Scans for the next match.
+            /// </summary>
+            void operator++( int ) noexcept
+            {
+                ++*this;
+            }
+
+            /// <summary>
+            /// Determines if the scan has finished.
+            /// </summary>
+            bool operator==( std::default_sentinel_t ) const noexcept
+            {
+                return range == nullptr;
+            }
+
+           private:
+            friend class match_range;
+
+            explicit iterator( const match_range* range ) noexcept : range( range )
+            {
+                seek( 0 );
+            }
+
+            /// <summary>
+            /// Moves to the first match at or after the offset, or to the end.
+            /// </summary>
+            iterator& seek( std::size_t offset ) noexcept
+            {
+                if ( found == range->options.limit || offset >= range->buffer.size() )
+                {
+                    range = nullptr;
+                    return *this;
+                }
+
+                const auto result = scanner::index_of< algorithm >( *range->pattern, range->buffer.subspan( offset ) );
+
+                if ( result == -1 )
+                {
+                    range = nullptr;
+                    return *this;
+                }
+
+                location = offset + static_cast< std::size_t >( result );
+                ++found;
+
+                return *this;
+            }
+
+            const match_range* range = nullptr;
+            std::size_t location = 0;
+            std::size_t found = 0;
+        };
+
+        /// <summary>
+        /// Starts the scan and returns the iterator at the first match.
+        /// </summary>
+        iterator begin() const noexcept
         {
-            const auto result = scanner::index_of< algorithm >( pattern, buffer.subspan( i ) );
+            return iterator( this );
+        }
 
-            if ( result == -1 )
-                break;
+        /// <summary>
+        /// Gets the sentinel that marks the end of the scan.
+        /// </summary>
+        std::default_sentinel_t end() const noexcept
+        {
+            return std::default_sentinel;
+        }
+
+       private:
+        friend class scanner;
 
-            results.push_back( i + result );
-            i += result + 1;
+        match_range( std::span< std::uint8_t > buffer, std::shared_ptr< const compiled_pattern_t > pattern, scan_options_t options ) noexcept
+            : buffer( buffer ),
+              pattern( std::move( pattern ) ),
+              options( options )
+        {
         }
 
-        return results;
+        std::span< std::uint8_t > buffer;
+        std::shared_ptr< const compiled_pattern_t > pattern;
+        scan_options_t options;
+    };
+
+    template< scanner::algorithm_t algorithm >
+    scanner::match_range< algorithm > scanner::matches( std::span< std::uint8_t > buffer, const pattern_t& pattern, scan_options_t options )
+    {
+        return match_range< algorithm >( buffer, std::make_shared< const compiled_pattern_t >( pattern ), options );
+    }
+
+    template< scanner::algorithm_t algorithm >
+    scanner::match_range< algorithm >
+    scanner::matches( std::span< std::uint8_t > buffer, const compiled_pattern_t& pattern, scan_options_t options ) noexcept
+    {
+        // The range doesn't own a compiled pattern that was passed in, so it shares no control block.
+        return match_range< algorithm >( buffer, std::shared_ptr< const compiled_pattern_t >( std::shared_ptr< void >(), &pattern ), options );
+    }
+
+    template< scanner::algorithm_t algorithm >
+    std::size_t scanner::count( std::span< std::uint8_t > buffer, const compiled_pattern_t& pattern, scan_options_t options ) noexcept
+    {
+        const auto range = scanner::matches< algorithm >( buffer, pattern, options );
+        std::size_t result = 0;
+
+        for ( auto it = range.begin(); it != range.end(); ++it )
+            ++result;
+
+        return result;
+    }
+
+    inline std::vector< std::span< std::uint8_t > > scanner::chunks_of( std::span< std::uint8_t > buffer, std::size_t overlap ) noexcept
+    {
+        std::vector< std::span< std::uint8_t > > chunks;
+        chunks.reserve( buffer.size() / chunk_size + 1 );
+
+        for ( std::size_t offset = 0; offset < buffer.size(); offset += chunk_size )
+            chunks.push_back( buffer.subspan( offset, std::min( chunk_size + overlap, buffer.size() - offset ) ) );
+
+        return chunks;
+    }
+
+    template< scanner::algorithm_t algorithm, typename execution_policy_t >
+        requires std::is_execution_policy_v< std::remove_cvref_t< execution_policy_t > >
+    std::optional< std::uintptr_t > scanner::find( execution_policy_t&& policy, std::span< std::uint8_t > buffer, const pattern_t& pattern ) noexcept
+    {
+        return scanner::find< algorithm >( std::forward< execution_policy_t >( policy ), buffer, compiled_pattern_t( pattern ) );
+    }
+
+    template< scanner::algorithm_t algorithm, typename execution_policy_t >
+        requires std::is_execution_policy_v< std::remove_cvref_t< execution_policy_t > >
+    std::vector< std::uintptr_t >
+    scanner::find_all( execution_policy_t&& policy, std::span< std::uint8_t > buffer, const pattern_t& pattern ) noexcept
+    {
+        return scanner::find_all< algorithm >( std::forward< execution_policy_t >( policy ), buffer, compiled_pattern_t( pattern ) );
+    }
+
+    template< scanner::algorithm_t algorithm, typename execution_policy_t >
+        requires std::is_execution_policy_v< std::remove_cvref_t< execution_policy_t > >
+    std::optional< std::uintptr_t >
+    scanner::find( execution_policy_t&& policy, std::span< std::uint8_t > buffer, const compiled_pattern_t& pattern ) noexcept
+    {
+        if ( buffer.size() <= chunk_size || pattern.size() == 0 )
+            return scanner::find< algorithm >( buffer, pattern );
+
+        const auto chunks = chunks_of( buffer, pattern.size() - 1 );
+
+        // A match can only start in the chunk it was found in, so the first chunk with a match holds the lowest one. Chunks after the best one
+        // found so far are skipped.
+        std::vector< std::int64_t > results( chunks.size(), -1 );
+        std::atomic< std::size_t > first = chunks.size();
+
+        std::for_each(
+            std::forward< execution_policy_t >( policy ),
+            chunks.begin(),
+            chunks.end(),
+            [ & ]( const std::span< std::uint8_t >& chunk )
+            {
+                const auto index = static_cast< std::size_t >( chunk.data() - buffer.data() ) / chunk_size;
+
+                if ( index > first.load( std::memory_order_relaxed ) )
+                    return;  // Early exit check
+
+                results[ index ] = scanner::index_of< algorithm >( pattern, chunk );
+
+                if ( results[ index ] == -1 )
+                    return;
+
+                auto current = first.load( std::memory_order_relaxed );
+
+                while ( index < current && !first.compare_exchange_weak( current, index, std::memory_order_relaxed ) )
+                {
+                }
+            } );
+
+        if ( first == chunks.size() )
+            return std::nullopt;
+
+        return first * chunk_size + results[ first ];
+    }
+
+    template< scanner::algorithm_t algorithm, typename execution_policy_t >
+        requires std::is_execution_policy_v< std::remove_cvref_t< execution_policy_t > >
+    std::vector< std::uintptr_t >
+    scanner::find_all( execution_policy_t&& policy, std::span< std::uint8_t > buffer, const compiled_pattern_t& pattern ) noexcept
+    {
+        if ( buffer.size() <= chunk_size || pattern.size() == 0 )
+            return scanner::find_all< algorithm >( buffer, pattern );
+
+        const auto chunks = chunks_of( buffer, pattern.size() - 1 );
+
+        // Every match starts in exactly one chunk, so concatenating the chunk results in order gives the sorted results without duplicates.
+        std::vector< std::vector< std::uintptr_t > > results( chunks.size() );
+
+        std::for_each(
+            std::forward< execution_policy_t >( policy ),
+            chunks.begin(),
+            chunks.end(),
+            [ & ]( const std::span< std::uint8_t >& chunk )
+            {
+                const auto offset = static_cast< std::size_t >( chunk.data() - buffer.data() );
+
+                results[ offset / chunk_size ] = scanner::find_all< algorithm >( chunk, pattern );
+
+                for ( auto& result : results[ offset / chunk_size ] )
+                    result += offset;
+            } );
+
+        std::size_t count = 0;
+
+        for ( const auto& result : results )
+            count += result.size();
+
+        std::vector< std::uintptr_t > merged;
+        merged.reserve( count );
+
+        for ( const auto& result : results )
+            merged.insert( merged.end(), result.begin(), result.end() );
+
+        return merged;
     }
 
-}  // namespace wincpp::patterns
+}  // namespace wincpp::patterns
\ No newline at end of file
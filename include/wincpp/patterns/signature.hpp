@@ -0,0 +1,177 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <span>
+
+#include "wincpp/core/error.hpp"
+#include "wincpp/patterns/pattern.hpp"
+
+namespace wincpp::patterns
+{
+    /// <summary>
+    /// A pattern together with the steps that turn the location of a match into the address it refers to. For example, the data address of
+    /// `lea rcx, [rip+rel32]` is `signature_t( "48 8D 0D ? ? ? ?"_sig ).capture( 3 ).rel32()`.
+    /// </summary>
+    /// <remarks>
+    /// Like patterns, signatures are plain values and can be built in `constexpr` tables.
+    /// </remarks>
+    struct signature_t
+    {
+        /// <summary>
+        /// A single post-processing step. Each step moves the cursor, which starts at the match plus the capture offset.
+        /// </summary>
+        struct step_t
+        {
+            /// <summary>
+            /// The different types of steps.
+            /// </summary>
+            enum class type_t : std::uint8_t
+            {
+                /// <summary>
+                /// Resolves a 32-bit relative operand at the cursor: the cursor moves to the end of the operand plus `value` (the size of any
+                /// immediate that follows it), plus the operand.
+                /// </summary>
+                rel32_t,
+
+                /// <summary>
+                /// Resolves an 8-bit relative operand at the cursor, in the same way as `rel32_t`.
+                /// </summary>
+                rel8_t,
+
+                /// <summary>
+                /// Reads the pointer at the cursor and moves the cursor to it.
+                /// </summary>
+                deref_t,
+
+                /// <summary>
+                /// Adds `value` to the cursor.
+                /// </summary>
+                add_t
+            };
+
+            type_t type = type_t::add_t;
+            std::int64_t value = 0;
+        };
+
+        /// <summary>
+        /// Reads memory that isn't in the scan buffer. Returns false if the memory can't be read.
+        /// </summary>
+        using reader_t = std::function< bool( std::uintptr_t address, std::span< std::uint8_t > out ) >;
+
+        /// <summary>
+        /// The maximum number of steps of a signature.
+        /// </summary>
+        static constexpr std::size_t max_steps = 8;
+
+        /// <summary>
+        /// Default constructor for the signature object.
+        /// </summary>
+        constexpr signature_t() noexcept = default;
+
+        /// <summary>
+        /// Creates a signature without any steps, which resolves to the location of the match.
+        /// </summary>
+        /// <param name="pattern">The pattern to search for.</param>
+        constexpr signature_t( const pattern_t& pattern ) noexcept : pattern( pattern )
+        {
+        }
+
+        /// <summary>
+        /// Sets the offset from the match at which the steps start, e.g. the offset of an operand in the matched instruction.
+        /// </summary>
+        /// <param name="offset">The offset from the start of the match.</param>
+        constexpr signature_t& capture( std::int64_t offset ) noexcept;
+
+        /// <summary>
+        /// Adds a step that resolves the 32-bit relative operand at the cursor.
+        /// </summary>
+        /// <param name="trailing">The number of bytes between the operand and the end of the instruction, e.g. an immediate.</param>
+        constexpr signature_t& rel32( std::int64_t trailing = 0 );
+
+        /// <summary>
+        /// Adds a step that resolves the 8-bit relative operand at the cursor.
+        /// </summary>
+        /// <param name="trailing">The number of bytes between the operand and the end of the instruction, e.g. an immediate.</param>
+        constexpr signature_t& rel8( std::int64_t trailing = 0 );
+
+        /// <summary>
+        /// Adds a step that reads the pointer at the cursor.
+        /// </summary>
+        constexpr signature_t& deref();
+
+        /// <summary>
+        /// Adds a step that adds a constant to the cursor.
+        /// </summary>
+        /// <param name="value">The constant.</param>
+        constexpr signature_t& add( std::int64_t value );
+
+        /// <summary>
+        /// Runs the steps from a match.
+        /// </summary>
+        /// <param name="match">The address of the match.</param>
+        /// <param name="read">Reads the operands and pointers the steps need.</param>
+        /// <returns>The final address, or nothing if a read failed.</returns>
+        std::optional< std::uintptr_t > resolve( std::uintptr_t match, const reader_t& read ) const;
+
+        /// <summary>
+        /// Runs the steps from a match, reading from the buffer the match was found in. Reads outside of the buffer go to the fallback.
+        /// </summary>
+        /// <param name="buffer">The scanned buffer.</param>
+        /// <param name="base">The address of the first byte of the buffer.</param>
+        /// <param name="location">The relative location of the match in the buffer.</param>
+        /// <param name="fallback">Reads memory outside of the buffer. If empty, those reads fail.</param>
+        /// <returns>The final address, or nothing if a read failed.</returns>
+        std::optional< std::uintptr_t >
+        resolve( std::span< const std::uint8_t > buffer, std::uintptr_t base, std::uintptr_t location, const reader_t& fallback = {} ) const;
+
+        pattern_t pattern;
+        std::int64_t offset = 0;
+        std::array< step_t, max_steps > steps{};
+        std::size_t step_count = 0;
+
+       private:
+        /// <summary>
+        /// Appends a step. Throws if the signature already holds `max_steps` steps.
+        /// </summary>
+        constexpr signature_t& push( step_t::type_t type, std::int64_t value );
+    };
+
+    constexpr signature_t& signature_t::capture( std::int64_t offset ) noexcept
+    {
+        this->offset = offset;
+        return *this;
+    }
+
+    constexpr signature_t& signature_t::rel32( std::int64_t trailing )
+    {
+        return push( step_t::type_t::rel32_t, trailing );
+    }
+
+    constexpr signature_t& signature_t::rel8( std::int64_t trailing )
+    {
+        return push( step_t::type_t::rel8_t, trailing );
+    }
+
+    constexpr signature_t& signature_t::deref()
+    {
+        return push( step_t::type_t::deref_t, 0 );
+    }
+
+    constexpr signature_t& signature_t::add( std::int64_t value )
+    {
+        return push( step_t::type_t::add_t, value );
+    }
+
+    constexpr signature_t& signature_t::push( step_t::type_t type, std::int64_t value )
+    {
+        if ( step_count == max_steps )
+            throw core::error::from_user( core::user_error_type_t::too_many_steps_t, "A signature can hold at most {} steps", max_steps );
+
+        steps[ step_count++ ] = { type, value };
+        return *this;
+    }
+
+}  // namespace wincpp::patterns
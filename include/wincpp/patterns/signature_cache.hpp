@@ -0,0 +1,147 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "wincpp/patterns/pattern.hpp"
+
+namespace wincpp::patterns
+{
+    /// <summary>
+    /// Identifies a build of an image. Two images with the same fingerprint are assumed to place every pattern at the same relative location.
+    /// </summary>
+    struct image_fingerprint_t
+    {
+        /// <summary>
+        /// The link time of the image, from the file header.
+        /// </summary>
+        std::uint32_t time_date_stamp = 0;
+
+        /// <summary>
+        /// The size of the mapped image, from the optional header.
+        /// </summary>
+        std::uint32_t size_of_image = 0;
+
+        /// <summary>
+        /// The checksum of the image, from the optional header. Often zero for images that aren't drivers or system DLLs.
+        /// </summary>
+        std::uint32_t checksum = 0;
+
+        /// <summary>
+        /// A hash of the code sections, or zero if they weren't hashed.
+        /// </summary>
+        std::uint64_t code_hash = 0;
+
+        constexpr bool operator==( const image_fingerprint_t& ) const noexcept = default;
+    };
+
+    /// <summary>
+    /// A persistent map from an image fingerprint and a pattern to the relative location of its first match. Lets a tool that scans the same
+    /// build of a module on every launch replace the scan with a file read, and rescan only after the module is updated.
+    /// </summary>
+    /// <remarks>
+    /// The cache stores where each pattern matched rather than what its signature resolves to, because resolution steps may dereference
+    /// pointers that change between runs. The cache isn't thread-safe.
+    /// </remarks>
+    class signature_cache final
+    {
+       public:
+        /// <summary>
+        /// Creates an empty cache that isn't backed by a file.
+        /// </summary>
+        signature_cache() = default;
+
+        /// <summary>
+        /// Creates a cache backed by the file at the path, and loads the file if it exists.
+        /// </summary>
+        /// <param name="path">The path of the cache file.</param>
+        /// <param name="hash_code">Whether fingerprints include a hash of the code sections, which also catches patched images.</param>
+        explicit signature_cache( std::filesystem::path path, bool hash_code = false );
+
+        /// <summary>
+        /// Gets the relative location of the pattern in the image.
+        /// </summary>
+        /// <param name="image">The name of the image.</param>
+        /// <param name="fingerprint">The fingerprint of the image.</param>
+        /// <param name="pattern">The pattern.</param>
+        /// <returns>The relative location, `not_found` if the pattern was cached as missing, or nothing if it isn't cached or the image has
+        /// changed.</returns>
+        std::optional< std::uintptr_t > lookup( std::string_view image, const image_fingerprint_t& fingerprint, const pattern_t& pattern ) const;
+
+        /// <summary>
+        /// Stores the relative location of the pattern in the image. If the fingerprint differs from the cached one, every location cached for
+        /// the image is dropped first.
+        /// </summary>
+        /// <param name="image">The name of the image.</param>
+        /// <param name="fingerprint">The fingerprint of the image.</param>
+        /// <param name="pattern">The pattern.</param>
+        /// <param name="offset">The relative location of the pattern, or `not_found` if the image doesn't contain it.</param>
+        void store( std::string_view image, const image_fingerprint_t& fingerprint, const pattern_t& pattern, std::uintptr_t offset );
+
+        /// <summary>
+        /// Replaces the contents of the cache with the file. A missing or malformed file leaves the cache empty.
+        /// </summary>
+        /// <returns>True if the file was loaded, false otherwise.</returns>
+        bool load() noexcept;
+
+        /// <summary>
+        /// Writes the cache to its file. The file is replaced as a whole, so a failed write leaves the previous file intact.
+        /// </summary>
+        /// <returns>True if the file was written, false otherwise.</returns>
+        bool save() const noexcept;
+
+        /// <summary>
+        /// Removes every entry from the cache. The file is left untouched until the next `save`.
+        /// </summary>
+        void clear() noexcept;
+
+        /// <summary>
+        /// Gets the path of the cache file.
+        /// </summary>
+        const std::filesystem::path& path() const noexcept;
+
+        /// <summary>
+        /// Gets whether fingerprints for this cache include a hash of the code sections.
+        /// </summary>
+        bool hash_code() const noexcept;
+
+        /// <summary>
+        /// Hashes the data. The hash is fast rather than strong, and is meant for detecting changed images.
+        /// </summary>
+        /// <param name="data">The data to hash.</param>
+        /// <param name="seed">The previous hash when hashing several pieces of data in a row.</param>
+        static std::uint64_t hash( std::span< const std::uint8_t > data, std::uint64_t seed = 0 ) noexcept;
+
+        /// <summary>
+        /// Gets the key of the pattern in the cache, which changes whenever any of its positions change.
+        /// </summary>
+        /// <param name="pattern">The pattern.</param>
+        static std::uint64_t key_of( const pattern_t& pattern ) noexcept;
+
+        /// <summary>
+        /// The location cached for a pattern that the image doesn't contain, so a broken signature isn't scanned for on every run. It is dropped
+        /// with the other locations once the image changes.
+        /// </summary>
+        static constexpr std::uintptr_t not_found = ~std::uintptr_t( 0 );
+
+       private:
+        /// <summary>
+        /// The cached locations of a single image.
+        /// </summary>
+        struct image_t
+        {
+            image_fingerprint_t fingerprint;
+            std::unordered_map< std::uint64_t, std::uint64_t > offsets;
+        };
+
+        std::filesystem::path _path;
+        bool _hash_code = false;
+
+        std::unordered_map< std::string, image_t > images;
+    };
+}  // namespace wincpp::patterns
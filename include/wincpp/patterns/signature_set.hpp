@@ -0,0 +1,142 @@
+#pragma once
+
+#include <cstdint>
+#include <initializer_list>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "wincpp/patterns/compiled_pattern.hpp"
+#include "wincpp/patterns/pattern.hpp"
+#include "wincpp/patterns/signature.hpp"
+
+namespace wincpp::patterns
+{
+    /// <summary>
+    /// A set of patterns that are all searched for in a single pass over a buffer. The longest run of strict bytes of every pattern is
+    /// compiled into one Aho-Corasick automaton, and each hit of a run is verified against its full (masked) pattern.
+    /// </summary>
+    class signature_set final
+    {
+       public:
+        /// <summary>
+        /// A single occurrence of a pattern in the buffer.
+        /// </summary>
+        struct match_t
+        {
+            /// <summary>
+            /// The index of the pattern in the set.
+            /// </summary>
+            std::size_t id;
+
+            /// <summary>
+            /// The relative location of the pattern.
+            /// </summary>
+            std::uintptr_t offset;
+        };
+
+        /// <summary>
+        /// The maximum number of strict bytes of each pattern that are put in the automaton. The rest is checked during verification.
+        /// </summary>
+        static constexpr std::size_t max_key_size = 8;
+
+        /// <summary>
+        /// Default constructor for the signature set object.
+        /// </summary>
+        signature_set() = default;
+
+        /// <summary>
+        /// Compiles the patterns into a new signature set. The id of each pattern is its index in the span.
+        /// </summary>
+        /// <param name="patterns">The patterns.</param>
+        explicit signature_set( std::span< const pattern_t > patterns );
+
+        /// <summary>
+        /// Compiles the patterns into a new signature set. The id of each pattern is its index in the list.
+        /// </summary>
+        /// <param name="patterns">The patterns.</param>
+        signature_set( std::initializer_list< pattern_t > patterns );
+
+        /// <summary>
+        /// Compiles the patterns of the signatures into a new signature set. The id of each signature is its index in the span.
+        /// </summary>
+        /// <param name="signatures">The signatures.</param>
+        explicit signature_set( std::span< const signature_t > signatures );
+
+        /// <summary>
+        /// Compiles the patterns of the signatures into a new signature set. The id of each signature is its index in the list.
+        /// </summary>
+        /// <param name="signatures">The signatures.</param>
+        signature_set( std::initializer_list< signature_t > signatures );
+
+        /// <summary>
+        /// Gets the number of patterns in the set.
+        /// </summary>
+        std::size_t size() const noexcept;
+
+        /// <summary>
+        /// Gets the compiled pattern with the specified id.
+        /// </summary>
+        const compiled_pattern_t& operator[]( std::size_t id ) const noexcept;
+
+        /// <summary>
+        /// Gets the signature with the specified id. Signatures created from a plain pattern have no steps.
+        /// </summary>
+        const signature_t& signature( std::size_t id ) const noexcept;
+
+        /// <summary>
+        /// Searches for the first occurrence of every pattern in the buffer.
+        /// </summary>
+        /// <param name="buffer">The buffer to search in.</param>
+        /// <returns>The relative location of each pattern, indexed by id.</returns>
+        std::vector< std::optional< std::uintptr_t > > find( std::span< std::uint8_t > buffer ) const noexcept;
+
+        /// <summary>
+        /// Searches for all occurrences of every pattern in the buffer.
+        /// </summary>
+        /// <param name="buffer">The buffer to search in.</param>
+        /// <returns>The matches, ordered by location and then by id.</returns>
+        std::vector< match_t > find_all( std::span< std::uint8_t > buffer ) const noexcept;
+
+        /// <summary>
+        /// Searches for the first occurrence of every signature in the buffer and runs its steps. Operands and pointers inside the buffer are
+        /// read from it directly, so resolving a batch of signatures needs no reads beyond those that leave the buffer.
+        /// </summary>
+        /// <param name="buffer">The buffer to search in.</param>
+        /// <param name="base">The address of the first byte of the buffer.</param>
+        /// <param name="fallback">Reads memory outside of the buffer. If empty, those reads fail.</param>
+        /// <returns>The resolved address of each signature, indexed by id. Empty if the pattern wasn't found or a read failed.</returns>
+        std::vector< std::optional< std::uintptr_t > >
+        resolve( std::span< std::uint8_t > buffer, std::uintptr_t base, const signature_t::reader_t& fallback = {} ) const;
+
+       private:
+        /// <summary>
+        /// The run of strict bytes of a pattern that is placed in the automaton.
+        /// </summary>
+        struct key_t
+        {
+            std::size_t offset, size;
+        };
+
+        /// <summary>
+        /// Walks the automaton over the buffer and calls the callback with the id and location of every verified match, except for the
+        /// patterns without a key. Stops early if the callback returns false.
+        /// </summary>
+        template< typename callback_t >
+        void scan( std::span< std::uint8_t > buffer, callback_t&& callback ) const noexcept;
+
+        std::vector< signature_t > signatures;
+        std::vector< compiled_pattern_t > patterns;
+        std::vector< key_t > keys;
+
+        // Patterns without a single strict byte are kept out of the automaton and scanned on their own.
+        std::vector< std::size_t > unkeyed;
+
+        // The transition table of the automaton, 256 entries per state.
+        std::vector< std::uint32_t > transitions;
+
+        // The ids of the patterns whose key ends in each state, including those reached through failure links.
+        std::vector< std::uint32_t > output_offsets;
+        std::vector< std::uint32_t > outputs;
+    };
+}  // namespace wincpp::patterns
\ No newline at end of file
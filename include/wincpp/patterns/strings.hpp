@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "wincpp/patterns/scanner.hpp"
+
+namespace wincpp::patterns
+{
+    /// <summary>
+    /// A run of printable characters found by `extract_strings`.
+    /// </summary>
+    struct extracted_string_t
+    {
+        /// <summary>
+        /// The relative location of the first byte of the run.
+        /// </summary>
+        std::uintptr_t offset;
+
+        /// <summary>
+        /// The encoding of the run, either `ascii_nocase_t` for one byte per character or `utf16le_t` for two.
+        /// </summary>
+        string_encoding_t encoding;
+
+        /// <summary>
+        /// The characters of the run. UTF-16LE runs are narrowed to one byte per character.
+        /// </summary>
+        std::string text;
+    };
+
+    /// <summary>
+    /// Extracts every run of printable characters of at least `min_length` characters, like the `strings` tool. A character is printable
+    /// if it is a tab or in [0x20, 0x7E]; in UTF-16LE its high byte must also be zero.
+    /// </summary>
+    /// <remarks>
+    /// The buffer is classified 64 bytes at a time into a bit mask of printable bytes and a bit mask of printable bytes followed by a zero,
+    /// with the widest of SSE2, AVX2 or AVX-512 that the CPU supports. The runs are then read off the masks, so a block without a string
+    /// or inside a long one costs a few instructions.
+    /// </remarks>
+    /// <param name="buffer">The buffer to extract from.</param>
+    /// <param name="min_length">The minimum number of characters in a run.</param>
+    /// <param name="encoding">The encodings to extract.</param>
+    /// <returns>The runs in ascending order of their location.</returns>
+    std::vector< extracted_string_t > extract_strings(
+        std::span< const std::uint8_t > buffer,
+        std::size_t min_length = 4,
+        string_encoding_t encoding = string_encoding_t::both_t ) noexcept;
+}  // namespace wincpp::patterns
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "wincpp/patterns/compiled_pattern.hpp"
+#include "wincpp/patterns/pattern.hpp"
+
+namespace wincpp::patterns
+{
+    /// <summary>
+    /// The suffix array of a buffer, built in linear time with SA-IS. Locating a run of strict bytes is a binary search, so checking how often
+    /// a pattern occurs costs a logarithmic lookup plus verifying the hits of its longest strict run, instead of a scan over the buffer.
+    /// </summary>
+    /// <remarks>
+    /// The index keeps its own copy of the buffer, and uses four bytes per buffer byte for the suffixes. Buffers must be smaller than 2 GiB.
+    /// </remarks>
+    class suffix_array_t final
+    {
+       public:
+        /// <summary>
+        /// Default constructor for the suffix array object.
+        /// </summary>
+        suffix_array_t() = default;
+
+        /// <summary>
+        /// Builds the suffix array of the buffer.
+        /// </summary>
+        /// <param name="text">The buffer to index, which must be smaller than 2 GiB.</param>
+        explicit suffix_array_t( std::vector< std::uint8_t > text );
+
+        /// <summary>
+        /// Gets the indexed buffer.
+        /// </summary>
+        std::span< const std::uint8_t > text() const noexcept;
+
+        /// <summary>
+        /// Gets the start of every suffix of the buffer, in lexicographic order.
+        /// </summary>
+        std::span< const std::uint32_t > suffixes() const noexcept;
+
+        /// <summary>
+        /// Finds the suffixes that begin with the bytes.
+        /// </summary>
+        /// <param name="needle">The bytes to search for.</param>
+        /// <returns>The half-open range of `suffixes()` that begin with the bytes.</returns>
+        std::pair< std::size_t, std::size_t > range( std::span< const std::uint8_t > needle ) const noexcept;
+
+        /// <summary>
+        /// Counts the occurrences of the pattern in the buffer.
+        /// </summary>
+        /// <param name="pattern">The pattern to count.</param>
+        /// <param name="limit">The count to stop at, e.g. 2 to tell if the pattern is unique.</param>
+        /// <returns>The number of occurrences, at most `limit`.</returns>
+        std::size_t count( const pattern_t& pattern, std::size_t limit = std::numeric_limits< std::size_t >::max() ) const noexcept;
+
+        /// <summary>
+        /// Locates the occurrences of the pattern in the buffer.
+        /// </summary>
+        /// <param name="pattern">The pattern to locate.</param>
+        /// <param name="limit">The maximum number of occurrences to return. Which ones are returned when there are more isn't specified.</param>
+        /// <returns>The relative locations, in ascending order.</returns>
+        std::vector< std::uintptr_t >
+        locate( const pattern_t& pattern, std::size_t limit = std::numeric_limits< std::size_t >::max() ) const noexcept;
+
+        /// <summary>
+        /// Sorts the suffixes of the buffer with SA-IS. Throws if the buffer isn't smaller than 2 GiB.
+        /// </summary>
+        /// <param name="text">The buffer.</param>
+        /// <returns>The start of every suffix, in lexicographic order.</returns>
+        static std::vector< std::uint32_t > build( std::span< const std::uint8_t > text );
+
+       private:
+        /// <summary>
+        /// Calls the callback with the location of every occurrence of the pattern, in no particular order, until it returns false.
+        /// </summary>
+        template< typename callback_t >
+        void visit( const compiled_pattern_t& pattern, callback_t&& callback ) const noexcept;
+
+        std::vector< std::uint8_t > _text;
+        std::vector< std::uint32_t > _suffixes;
+    };
+}  // namespace wincpp::patterns
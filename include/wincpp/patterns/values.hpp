@@ -0,0 +1,282 @@
+#pragma once
+
+#include <concepts>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+namespace wincpp::patterns
+{
+    /// <summary>
+    /// The types of value `find_values` can compare. Every type is read in little endian from any address.
+    /// </summary>
+    enum class value_type_t : std::uint8_t
+    {
+        /// <summary>
+        /// A signed 8-bit integer.
+        /// </summary>
+        i8_t,
+
+        /// <summary>
+        /// An unsigned 8-bit integer.
+        /// </summary>
+        u8_t,
+
+        /// <summary>
+        /// A signed 16-bit integer.
+        /// </summary>
+        i16_t,
+
+        /// <summary>
+        /// An unsigned 16-bit integer.
+        /// </summary>
+        u16_t,
+
+        /// <summary>
+        /// A signed 32-bit integer.
+        /// </summary>
+        i32_t,
+
+        /// <summary>
+        /// An unsigned 32-bit integer.
+        /// </summary>
+        u32_t,
+
+        /// <summary>
+        /// A signed 64-bit integer.
+        /// </summary>
+        i64_t,
+
+        /// <summary>
+        /// An unsigned 64-bit integer.
+        /// </summary>
+        u64_t,
+
+        /// <summary>
+        /// An IEEE 754 single precision float.
+        /// </summary>
+        f32_t,
+
+        /// <summary>
+        /// An IEEE 754 double precision float.
+        /// </summary>
+        f64_t
+    };
+
+    /// <summary>
+    /// The arithmetic types that map onto a `value_type_t`.
+    /// </summary>
+    template< typename T >
+    concept scannable_value = std::is_arithmetic_v< T > && !std::is_same_v< T, long double > &&
+                              ( sizeof( T ) == 1 || sizeof( T ) == 2 || sizeof( T ) == 4 || sizeof( T ) == 8 );
+
+    /// <summary>
+    /// Gets the value type of the arithmetic type.
+    /// </summary>
+    template< scannable_value T >
+    constexpr value_type_t value_type_of() noexcept
+    {
+        if constexpr ( std::is_floating_point_v< T > )
+            return sizeof( T ) == 4 ? value_type_t::f32_t : value_type_t::f64_t;
+        else if constexpr ( sizeof( T ) == 1 )
+            return std::is_signed_v< T > ? value_type_t::i8_t : value_type_t::u8_t;
+        else if constexpr ( sizeof( T ) == 2 )
+            return std::is_signed_v< T > ? value_type_t::i16_t : value_type_t::u16_t;
+        else if constexpr ( sizeof( T ) == 4 )
+            return std::is_signed_v< T > ? value_type_t::i32_t : value_type_t::u32_t;
+        else
+            return std::is_signed_v< T > ? value_type_t::i64_t : value_type_t::u64_t;
+    }
+
+    /// <summary>
+    /// Gets the size of a value of the type in bytes.
+    /// </summary>
+    constexpr std::size_t size_of( value_type_t type ) noexcept
+    {
+        switch ( type )
+        {
+            case value_type_t::i8_t:
+            case value_type_t::u8_t: return 1;
+            case value_type_t::i16_t:
+            case value_type_t::u16_t: return 2;
+            case value_type_t::i32_t:
+            case value_type_t::u32_t:
+            case value_type_t::f32_t: return 4;
+            default: return 8;
+        }
+    }
+
+    /// <summary>
+    /// How a value compares with its previous value, for narrowing the results of an earlier scan.
+    /// </summary>
+    enum class value_change_t : std::uint8_t
+    {
+        /// <summary>
+        /// The value is different. NaN is always different.
+        /// </summary>
+        changed_t,
+
+        /// <summary>
+        /// The value is the same.
+        /// </summary>
+        unchanged_t,
+
+        /// <summary>
+        /// The value is greater.
+        /// </summary>
+        increased_t,
+
+        /// <summary>
+        /// The value is smaller.
+        /// </summary>
+        decreased_t
+    };
+
+    /// <summary>
+    /// What `find_values` looks for: every value of a type in an inclusive range, at every offset that is a multiple of the alignment.
+    /// Equality and floating point tolerance are ranges too, so the kernels only ever compare against two bounds.
+    /// </summary>
+    /// <remarks>
+    /// Floating point ranges never match NaN, and match both zeros if they contain either.
+    /// </remarks>
+    struct value_query_t
+    {
+        /// <summary>
+        /// Creates a query for the values in [low, high]. Throws if the range is empty, a bound is NaN or the alignment isn't a power of two.
+        /// </summary>
+        /// <param name="type">The type of the values.</param>
+        /// <param name="low">The bits of the lowest value, zero extended.</param>
+        /// <param name="high">The bits of the highest value, zero extended.</param>
+        /// <param name="alignment">The alignment of the values, relative to the start of the buffer. 1 finds unaligned values.</param>
+        value_query_t( value_type_t type, std::uint64_t low, std::uint64_t high, std::size_t alignment );
+
+        /// <summary>
+        /// Creates a query for the values equal to the value.
+        /// </summary>
+        /// <typeparam name="T">The type of the values.</typeparam>
+        /// <param name="value">The value.</param>
+        /// <param name="alignment">The alignment of the values. Defaults to the natural alignment of the type.</param>
+        template< scannable_value T >
+        static value_query_t equal( T value, std::size_t alignment = alignof( T ) );
+
+        /// <summary>
+        /// Creates a query for the values in the inclusive range.
+        /// </summary>
+        /// <typeparam name="T">The type of the values.</typeparam>
+        /// <param name="low">The lowest value.</param>
+        /// <param name="high">The highest value.</param>
+        /// <param name="alignment">The alignment of the values. Defaults to the natural alignment of the type.</param>
+        template< scannable_value T >
+        static value_query_t between( T low, T high, std::size_t alignment = alignof( T ) );
+
+        /// <summary>
+        /// Creates a query for the floating point values within the tolerance of the value, e.g. a health of 100 that is stored as 99.9999.
+        /// </summary>
+        /// <typeparam name="T">The type of the values.</typeparam>
+        /// <param name="value">The value.</param>
+        /// <param name="epsilon">The largest accepted difference from the value.</param>
+        /// <param name="alignment">The alignment of the values. Defaults to the natural alignment of the type.</param>
+        template< scannable_value T >
+            requires std::floating_point< T >
+        static value_query_t near( T value, T epsilon, std::size_t alignment = alignof( T ) );
+
+        /// <summary>
+        /// Gets the size of the values in bytes.
+        /// </summary>
+        constexpr std::size_t size() const noexcept
+        {
+            return size_of( type );
+        }
+
+        /// <summary>
+        /// The type of the values.
+        /// </summary>
+        value_type_t type;
+
+        /// <summary>
+        /// The bits of the lowest and highest accepted value, zero extended.
+        /// </summary>
+        std::uint64_t low, high;
+
+        /// <summary>
+        /// The alignment of the values, a power of two.
+        /// </summary>
+        std::size_t alignment;
+
+       private:
+        template< scannable_value T >
+        static std::uint64_t bits_of( T value ) noexcept
+        {
+            std::uint64_t bits = 0;
+            std::memcpy( &bits, &value, sizeof( T ) );
+            return bits;
+        }
+    };
+
+    /// <summary>
+    /// Finds every value that the query accepts.
+    /// </summary>
+    /// <remarks>
+    /// The buffer is compared a vector of values at a time with the widest of SSE2, AVX2 or AVX-512 that the CPU supports, as an unsigned
+    /// distance from the low bound for integers and as two ordered compares for floating point. Unaligned queries run one such pass per
+    /// offset within a value. SSE2 has no 64-bit integer compare, so 64-bit integers need AVX2 to be vectorized.
+    /// </remarks>
+    /// <param name="buffer">The buffer to search.</param>
+    /// <param name="query">The query.</param>
+    /// <param name="limit">The maximum number of matches to return.</param>
+    /// <returns>The relative locations of the first matches, in ascending order.</returns>
+    std::vector< std::uintptr_t >
+    find_values( std::span< const std::uint8_t > buffer, const value_query_t& query, std::size_t limit = std::numeric_limits< std::size_t >::max() ) noexcept;
+
+    /// <summary>
+    /// Narrows a set of candidates to the values that the query accepts. The buffer holds consecutive values of the type of the query, and
+    /// bit `i % 64` of word `i / 64` of the set stands for value `i`. The alignment of the query doesn't apply.
+    /// </summary>
+    /// <remarks>
+    /// Runs the kernels of `find_values` over the words of the set that still have a candidate, and skips the rest.
+    /// </remarks>
+    /// <param name="values">The current values.</param>
+    /// <param name="query">The query.</param>
+    /// <param name="candidates">The set of candidates, narrowed in place. Bits past the end of the values are cleared.</param>
+    /// <returns>The number of candidates left.</returns>
+    std::size_t filter_values( std::span< const std::uint8_t > values, const value_query_t& query, std::span< std::uint64_t > candidates ) noexcept;
+
+    /// <summary>
+    /// Narrows a set of candidates to the values that changed in the given way. Both buffers hold consecutive values of the type, and bit
+    /// `i % 64` of word `i / 64` of the set stands for value `i`.
+    /// </summary>
+    /// <param name="values">The current values.</param>
+    /// <param name="previous">The previous values.</param>
+    /// <param name="type">The type of the values.</param>
+    /// <param name="change">The change to keep.</param>
+    /// <param name="candidates">The set of candidates, narrowed in place. Bits past the end of the values are cleared.</param>
+    /// <returns>The number of candidates left.</returns>
+    std::size_t filter_values(
+        std::span< const std::uint8_t > values,
+        std::span< const std::uint8_t > previous,
+        value_type_t type,
+        value_change_t change,
+        std::span< std::uint64_t > candidates ) noexcept;
+
+    template< scannable_value T >
+    inline value_query_t value_query_t::equal( T value, std::size_t alignment )
+    {
+        return value_query_t( value_type_of< T >(), bits_of( value ), bits_of( value ), alignment );
+    }
+
+    template< scannable_value T >
+    inline value_query_t value_query_t::between( T low, T high, std::size_t alignment )
+    {
+        return value_query_t( value_type_of< T >(), bits_of( low ), bits_of( high ), alignment );
+    }
+
+    template< scannable_value T >
+        requires std::floating_point< T >
+    inline value_query_t value_query_t::near( T value, T epsilon, std::size_t alignment )
+    {
+        return value_query_t( value_type_of< T >(), bits_of( T( value - epsilon ) ), bits_of( T( value + epsilon ) ), alignment );
+    }
+}  // namespace wincpp::patterns
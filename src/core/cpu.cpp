@@ -0,0 +1,85 @@
+#include "wincpp/core/cpu.hpp"
+
+#if defined( WINCPP_X86 )
+#if defined( _MSC_VER )
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+namespace wincpp::core
+{
+#if defined( WINCPP_X86 )
+    static void cpuid( std::uint32_t leaf, std::uint32_t subleaf, std::uint32_t ( &regs )[ 4 ] ) noexcept
+    {
+#if defined( _MSC_VER )
+        int info[ 4 ];
+        __cpuidex( info, static_cast< int >( leaf ), static_cast< int >( subleaf ) );
+
+        for ( int i = 0; i < 4; ++i )
+            regs[ i ] = static_cast< std::uint32_t >( info[ i ] );
+#else
+        __cpuid_count( leaf, subleaf, regs[ 0 ], regs[ 1 ], regs[ 2 ], regs[ 3 ] );
+#endif
+    }
+
+    static std::uint64_t xgetbv() noexcept
+    {
+#if defined( _MSC_VER )
+        return _xgetbv( 0 );
+#else
+        std::uint32_t eax, edx;
+        __asm__( "xgetbv" : "=a"( eax ), "=d"( edx ) : "c"( 0 ) );
+        return ( static_cast< std::uint64_t >( edx ) << 32 ) | eax;
+#endif
+    }
+
+    static simd_level_t detect_simd_level() noexcept
+    {
+        std::uint32_t regs[ 4 ];
+
+        cpuid( 0, 0, regs );
+        const auto max_leaf = regs[ 0 ];
+
+        cpuid( 1, 0, regs );
+
+        if ( !( regs[ 3 ] & ( 1u << 26 ) ) )
+            return simd_level_t::scalar_t;
+
+        // The OS has to save the YMM (and ZMM) state on context switches, otherwise the wide registers can't be used.
+        const bool osxsave = regs[ 2 ] & ( 1u << 27 );
+        const bool avx = regs[ 2 ] & ( 1u << 28 );
+
+        if ( !osxsave || !avx || max_leaf < 7 )
+            return simd_level_t::sse2_t;
+
+        const auto xcr0 = xgetbv();
+
+        if ( ( xcr0 & 0x6 ) != 0x6 )
+            return simd_level_t::sse2_t;
+
+        cpuid( 7, 0, regs );
+
+        const bool avx2 = regs[ 1 ] & ( 1u << 5 );
+        const bool avx512f = regs[ 1 ] & ( 1u << 16 );
+        const bool avx512bw = regs[ 1 ] & ( 1u << 30 );
+
+        if ( avx512f && avx512bw && ( xcr0 & 0xE6 ) == 0xE6 )
+            return simd_level_t::avx512_t;
+
+        return avx2 ? simd_level_t::avx2_t : simd_level_t::sse2_t;
+    }
+#else
+    static simd_level_t detect_simd_level() noexcept
+    {
+        return simd_level_t::scalar_t;
+    }
+#endif
+
+    simd_level_t simd_level() noexcept
+    {
+        static const simd_level_t level = detect_simd_level();
+        return level;
+    }
+}  // namespace wincpp::core
\ No newline at end of file
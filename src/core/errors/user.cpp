@@ -22,6 +22,13 @@ namespace wincpp::core
             case user_error_type_t::module_not_found_t: return "The desired module was not found.";
             case user_error_type_t::thread_not_found_t: return "The desired thread was not found.";
             case user_error_type_t::export_not_found_t: return "The desired export was not found.";
+            case user_error_type_t::invalid_pattern_t: return "The pattern string could not be parsed.";
+            case user_error_type_t::pattern_too_large_t: return "The pattern is larger than a pattern can hold.";
+            case user_error_type_t::too_many_steps_t: return "The signature has more steps than a signature can hold.";
+            case user_error_type_t::invalid_value_query_t: return "The value query is invalid.";
+            case user_error_type_t::snapshot_file_t: return "The file of a memory snapshot could not be created.";
+            case user_error_type_t::invalid_pointer_scan_t: return "The pointer scan is invalid.";
+            case user_error_type_t::buffer_too_large_t: return "The buffer is too large to index.";
             default: return "Unknown error";
         }
     }
@@ -1,5 +1,13 @@
+#include <algorithm>
+#include <cstring>
+#include <execution>
+#include <iterator>
+
 #include "wincpp/memory/region.hpp"
+#include "wincpp/patterns/regex.hpp"
 #include "wincpp/patterns/scanner.hpp"
+#include "wincpp/patterns/signature_set.hpp"
+#include "wincpp/patterns/strings.hpp"
 
 namespace wincpp::memory
 {
@@ -35,7 +43,17 @@ namespace wincpp::memory
                !region.protection().has( memory::protection_t::noaccess_t ) && !region.protection().has( memory::protection_t::guard_t );
     }
 
-    std::optional< std::uintptr_t > memory_t::find( const patterns::pattern_t &pattern ) const noexcept
+    std::optional< std::uintptr_t > memory_t::find( const patterns::pattern_t &pattern, bool parallelize ) const noexcept
+    {
+        return find( patterns::compiled_pattern_t( pattern ), parallelize );
+    }
+
+    std::vector< std::uintptr_t > memory_t::find_all( const patterns::pattern_t &pattern, bool parallelize ) const noexcept
+    {
+        return find_all( patterns::compiled_pattern_t( pattern ), parallelize );
+    }
+
+    std::optional< std::uintptr_t > memory_t::find( const patterns::compiled_pattern_t &pattern, bool parallelize ) const noexcept
     {
         for ( const auto &region : regions() )
         {
@@ -46,14 +64,19 @@ namespace wincpp::memory
 
             std::span< std::uint8_t > bytes( buffer.get(), region.size() );
 
-            if ( const auto result = patterns::scanner::find< patterns::scanner::algorithm_t::naive_t >( bytes, pattern ) )
+            using algorithm_t = patterns::scanner::algorithm_t;
+
+            const auto result = parallelize ? patterns::scanner::find< algorithm_t::auto_t >( std::execution::par, bytes, pattern )
+                                            : patterns::scanner::find< algorithm_t::auto_t >( bytes, pattern );
+
+            if ( result )
                 return region.address() + *result;
         }
 
         return std::nullopt;
     }
 
-    std::vector< std::uintptr_t > memory_t::find_all( const patterns::pattern_t &pattern ) const noexcept
+    std::vector< std::uintptr_t > memory_t::find_all( const patterns::compiled_pattern_t &pattern, bool parallelize ) const noexcept
     {
         std::vector< std::uintptr_t > results;
 
@@ -66,13 +89,282 @@ namespace wincpp::memory
 
             std::span< std::uint8_t > bytes( buffer.get(), region.size() );
 
-            for ( const auto &result : patterns::scanner::find_all< patterns::scanner::algorithm_t::naive_t >( bytes, pattern ) )
+            using algorithm_t = patterns::scanner::algorithm_t;
+
+            const auto found = parallelize ? patterns::scanner::find_all< algorithm_t::auto_t >( std::execution::par, bytes, pattern )
+                                           : patterns::scanner::find_all< algorithm_t::auto_t >( bytes, pattern );
+
+            for ( const auto &result : found )
                 results.push_back( region.address() + result );
         }
 
         return results;
     }
 
+    std::vector< std::optional< std::uintptr_t > > memory_t::find( const patterns::signature_set &set ) const noexcept
+    {
+        std::vector< std::optional< std::uintptr_t > > results( set.size() );
+        std::size_t remaining = set.size();
+
+        for ( const auto &region : regions() )
+        {
+            if ( !is_valid_region( region ) || remaining == 0 )
+                break;
+
+            const auto buffer = factory.read( region.address(), region.size() );
+
+            std::span< std::uint8_t > bytes( buffer.get(), region.size() );
+
+            const auto matches = set.find( bytes );
+
+            for ( std::size_t id = 0; id < matches.size(); ++id )
+            {
+                if ( matches[ id ] && !results[ id ] )
+                {
+                    results[ id ] = region.address() + *matches[ id ];
+                    --remaining;
+                }
+            }
+        }
+
+        return results;
+    }
+
+    std::vector< patterns::approx_match_t > memory_t::find_approx( const patterns::pattern_t &pattern, std::size_t k, std::size_t limit ) const noexcept
+    {
+        std::vector< patterns::approx_match_t > results;
+
+        for ( const auto &region : regions() )
+        {
+            if ( !is_valid_region( region ) )
+                break;
+
+            const auto buffer = factory.read( region.address(), region.size() );
+
+            std::span< std::uint8_t > bytes( buffer.get(), region.size() );
+
+            for ( auto match : patterns::scanner::find_approx( bytes, pattern, k, limit ) )
+            {
+                match.offset += region.address();
+                results.push_back( match );
+            }
+
+            // The regions are in ascending order, so a stable sort by distance keeps the addresses ascending. Trimming after each region
+            // keeps at most twice the limit around.
+            std::stable_sort(
+                results.begin(),
+                results.end(),
+                []( const patterns::approx_match_t &a, const patterns::approx_match_t &b ) { return a.distance < b.distance; } );
+
+            if ( results.size() > limit )
+                results.resize( limit );
+        }
+
+        return results;
+    }
+
+    std::optional< patterns::string_match_t > memory_t::find_string( std::string_view text, patterns::string_encoding_t encoding ) const noexcept
+    {
+        for ( const auto &region : regions() )
+        {
+            if ( !is_valid_region( region ) )
+                break;
+
+            const auto buffer = factory.read( region.address(), region.size() );
+
+            std::span< std::uint8_t > bytes( buffer.get(), region.size() );
+
+            if ( auto result = patterns::scanner::find_string( bytes, text, encoding ) )
+            {
+                result->offset += region.address();
+                return result;
+            }
+        }
+
+        return std::nullopt;
+    }
+
+    std::vector< patterns::string_match_t > memory_t::find_all_strings( std::string_view text, patterns::string_encoding_t encoding ) const noexcept
+    {
+        std::vector< patterns::string_match_t > results;
+
+        for ( const auto &region : regions() )
+        {
+            if ( !is_valid_region( region ) )
+                break;
+
+            const auto buffer = factory.read( region.address(), region.size() );
+
+            std::span< std::uint8_t > bytes( buffer.get(), region.size() );
+
+            for ( auto match : patterns::scanner::find_all_strings( bytes, text, encoding ) )
+            {
+                match.offset += region.address();
+                results.push_back( match );
+            }
+        }
+
+        return results;
+    }
+
+    std::vector< patterns::extracted_string_t >
+    memory_t::strings( std::size_t min_length, patterns::string_encoding_t encoding, bool parallelize ) const noexcept
+    {
+        std::vector< std::pair< std::uintptr_t, std::size_t > > ranges;
+
+        for ( const auto &region : regions() )
+        {
+            if ( !is_valid_region( region ) )
+                break;
+
+            ranges.emplace_back( region.address(), region.size() );
+        }
+
+        std::vector< std::vector< patterns::extracted_string_t > > found( ranges.size() );
+
+        const auto extract = [ & ]( const std::pair< std::uintptr_t, std::size_t > &range )
+        {
+            const auto [ address, size ] = range;
+            const auto buffer = factory.read( address, size );
+
+            if ( !buffer )
+                return;
+
+            auto &results = found[ &range - ranges.data() ];
+            results = patterns::extract_strings( { buffer.get(), size }, min_length, encoding );
+
+            for ( auto &result : results )
+                result.offset += address;
+        };
+
+        if ( parallelize )
+            std::for_each( std::execution::par, ranges.begin(), ranges.end(), extract );
+        else
+            std::for_each( ranges.begin(), ranges.end(), extract );
+
+        // The regions are in ascending order, so appending their runs keeps the whole list in order.
+        std::vector< patterns::extracted_string_t > results;
+
+        for ( auto &region : found )
+            std::move( region.begin(), region.end(), std::back_inserter( results ) );
+
+        return results;
+    }
+
+    std::optional< std::uintptr_t > memory_t::find( const patterns::regex_t &regex ) const noexcept
+    {
+        for ( const auto &region : regions() )
+        {
+            if ( !is_valid_region( region ) )
+                break;
+
+            const auto buffer = factory.read( region.address(), region.size() );
+
+            std::span< std::uint8_t > bytes( buffer.get(), region.size() );
+
+            if ( const auto result = regex.find( bytes ) )
+                return region.address() + result->offset;
+        }
+
+        return std::nullopt;
+    }
+
+    std::vector< std::uintptr_t > memory_t::find_all( const patterns::regex_t &regex ) const noexcept
+    {
+        std::vector< std::uintptr_t > results;
+
+        for ( const auto &region : regions() )
+        {
+            if ( !is_valid_region( region ) )
+                break;
+
+            const auto buffer = factory.read( region.address(), region.size() );
+
+            std::span< std::uint8_t > bytes( buffer.get(), region.size() );
+
+            for ( const auto &match : regex.find_all( bytes ) )
+                results.push_back( region.address() + match.offset );
+        }
+
+        return results;
+    }
+
+    std::vector< std::optional< std::uintptr_t > > memory_t::resolve( const patterns::signature_set &set ) const
+    {
+        struct chunk_t
+        {
+            std::uintptr_t address;
+            std::shared_ptr< std::uint8_t[] > buffer;
+            std::size_t size;
+        };
+
+        std::vector< chunk_t > chunks;
+        std::vector< std::optional< std::uintptr_t > > matches( set.size() );
+        std::vector< std::size_t > owners( set.size() );
+        std::size_t remaining = set.size();
+
+        for ( const auto &region : regions() )
+        {
+            if ( !is_valid_region( region ) || remaining == 0 )
+                break;
+
+            const auto buffer = factory.read( region.address(), region.size() );
+
+            if ( !buffer )
+                continue;
+
+            std::span< std::uint8_t > bytes( buffer.get(), region.size() );
+
+            const auto found = set.find( bytes );
+
+            for ( std::size_t id = 0; id < found.size(); ++id )
+            {
+                if ( found[ id ] && !matches[ id ] )
+                {
+                    matches[ id ] = *found[ id ];
+                    owners[ id ] = chunks.size();
+                    --remaining;
+                }
+            }
+
+            chunks.push_back( { region.address(), buffer, region.size() } );
+        }
+
+        // Operands usually sit in the region of their match, but pointers can lead to any other region that was already read.
+        const auto reader = [ & ]( std::uintptr_t address, std::span< std::uint8_t > out )
+        {
+            for ( const auto &chunk : chunks )
+            {
+                if ( address >= chunk.address && address - chunk.address <= chunk.size && out.size() <= chunk.size - ( address - chunk.address ) )
+                {
+                    std::memcpy( out.data(), chunk.buffer.get() + ( address - chunk.address ), out.size() );
+                    return true;
+                }
+            }
+
+            return factory.read( address, out.size(), out.data() );
+        };
+
+        std::vector< std::optional< std::uintptr_t > > results( set.size() );
+
+        for ( std::size_t id = 0; id < set.size(); ++id )
+        {
+            if ( !matches[ id ] )
+                continue;
+
+            const auto &chunk = chunks[ owners[ id ] ];
+
+            results[ id ] = set.signature( id ).resolve( { chunk.buffer.get(), chunk.size }, chunk.address, *matches[ id ], reader );
+        }
+
+        return results;
+    }
+
+    std::optional< std::uintptr_t > memory_t::resolve( const patterns::signature_t &signature ) const
+    {
+        return resolve( patterns::signature_set( { signature } ) ).front();
+    }
+
     protection_operation memory_t::protect( std::uintptr_t offset, std::size_t size, protection_flags_t new_flags, bool scoped ) const
     {
         return factory.protect( address() + offset, size, new_flags, scoped );
@@ -1,14 +1,48 @@
 #include "wincpp/memory_factory.hpp"
 
+#include <algorithm>
 #include <atomic>
+#include <cstring>
 #include <execution>
+#include <limits>
 
 #include "wincpp/core/error.hpp"
-#include "wincpp/patterns/scanner.hpp"
+#include "wincpp/patterns/lanes.hpp"
+#include "wincpp/patterns/pointer_map.hpp"
+#include "wincpp/patterns/scan_session.hpp"
+#include "wincpp/patterns/values.hpp"
 #include "wincpp/process.hpp"
 
 namespace wincpp
 {
+    namespace
+    {
+        /// <summary>
+        /// Gets whether the region can be read for a value scan.
+        /// </summary>
+        bool scannable( const memory::region_t& region )
+        {
+            return region.state() == memory::region_t::state_t::commit_t && !region.protection().has( memory::protection_t::noaccess_t ) &&
+                   !region.protection().has( memory::protection_t::guard_t );
+        }
+
+        /// <summary>
+        /// Gets the ranges of the regions that can be read for a value scan and pass the comparison.
+        /// </summary>
+        std::vector< patterns::scan_session::range_t > scannable_ranges( const memory::region_list& regions, const memory_factory::region_compare& compare )
+        {
+            std::vector< patterns::scan_session::range_t > ranges;
+
+            for ( const auto& region : regions )
+            {
+                if ( scannable( region ) && compare( region ) )
+                    ranges.push_back( { region.address(), region.size() } );
+            }
+
+            return ranges;
+        }
+    }  // namespace
+
     memory_factory::memory_factory( process_t* p, memory_type type ) noexcept : p( p ), type( type )
     {
     }
@@ -115,7 +149,96 @@ namespace wincpp
         const region_compare& compare,
         bool parallelize ) const
     {
-        std::vector< memory::region_t > region_list;
+        struct chunk_t
+        {
+            std::uintptr_t address;
+            std::size_t size;
+        };
+
+        std::vector< chunk_t > chunks;
+
+        for ( const auto& region : regions() )
+        {
+            if ( region.protection() != memory::protection_flags_t::readwrite || region.type() != memory::region_t::type_t::private_t ||
+                 region.state() != memory::region_t::state_t::commit_t )
+                continue;
+
+            if ( !compare( region ) )
+                continue;
+
+            // A single large region would otherwise keep one thread busy while the rest sit idle, so it is split into chunks as well.
+            for ( std::size_t offset = 0; offset < region.size(); offset += chunk_size )
+                chunks.push_back( { region.address() + offset, std::min( chunk_size, region.size() - offset ) } );
+        }
+
+        // The lowest instance found so far. The chunks above it can't hold a lower one, so they are skipped.
+        std::atomic< std::uintptr_t > address = std::numeric_limits< std::uintptr_t >::max();
+
+        const auto lambda = [ & ]( const chunk_t& chunk )
+        {
+            if ( chunk.address >= address.load( std::memory_order_relaxed ) )
+                return;
+
+            const auto buffer = read( chunk.address, chunk.size );
+
+            if ( !buffer )
+                return;
+
+            // Objects are pointer aligned, so only the aligned lanes can hold the vtable.
+            const auto result = patterns::find_lanes( { buffer.get(), chunk.size }, object->vtable(), sizeof( std::uintptr_t ), 1 );
+
+            if ( result.empty() )
+                return;
+
+            const auto found = chunk.address + result.front();
+            auto current = address.load( std::memory_order_relaxed );
+
+            while ( found < current && !address.compare_exchange_weak( current, found, std::memory_order_relaxed ) )
+                ;
+        };
+
+        if ( parallelize )
+            std::for_each( std::execution::par, chunks.begin(), chunks.end(), lambda );
+        else
+            std::for_each( chunks.begin(), chunks.end(), lambda );
+
+        return address != std::numeric_limits< std::uintptr_t >::max() ? std::make_optional( address.load() ) : std::nullopt;
+    }
+
+    std::vector< std::vector< std::uintptr_t > > memory_factory::find_instances_of(
+        std::span< const std::shared_ptr< modules::rtti::object_t > > objects,
+        std::size_t limit,
+        bool parallelize ) const
+    {
+        return find_instances_of( objects, []( const memory::region_t& region ) { return true; }, limit, parallelize );
+    }
+
+    std::vector< std::vector< std::uintptr_t > > memory_factory::find_instances_of(
+        std::span< const std::shared_ptr< modules::rtti::object_t > > objects,
+        const region_compare& compare,
+        std::size_t limit,
+        bool parallelize ) const
+    {
+        std::vector< std::vector< std::uintptr_t > > instances( objects.size() );
+
+        if ( objects.empty() || !limit )
+            return instances;
+
+        std::vector< std::uint64_t > vtables;
+        vtables.reserve( objects.size() );
+
+        for ( const auto& object : objects )
+            vtables.push_back( object->vtable() );
+
+        const patterns::lane_set set( vtables );
+
+        struct chunk_t
+        {
+            std::uintptr_t address;
+            std::size_t size;
+        };
+
+        std::vector< chunk_t > chunks;
 
         for ( const auto& region : regions() )
         {
@@ -123,38 +246,178 @@ namespace wincpp
                  region.state() != memory::region_t::state_t::commit_t )
                 continue;
 
-            if ( compare( region ) )
-                region_list.push_back( region );
+            if ( !compare( region ) )
+                continue;
+
+            for ( std::size_t offset = 0; offset < region.size(); offset += chunk_size )
+                chunks.push_back( { region.address() + offset, std::min( chunk_size, region.size() - offset ) } );
         }
 
-        std::atomic< std::uintptr_t > address = 0;
-        std::stop_source stop_source;
+        // The instances found in each chunk, as the index of their object and their address.
+        std::vector< std::vector< std::pair< std::uint32_t, std::uintptr_t > > > found( chunks.size() );
+
+        // The number of instances found of each object, and of objects that don't have enough yet. Once none are left, the remaining chunks
+        // are skipped.
+        std::vector< std::atomic< std::size_t > > counts( objects.size() );
+        std::atomic< std::size_t > remaining = set.size();
 
-        const auto lambda = [ & ]( const memory::region_t& region )
+        const auto lambda = [ & ]( const chunk_t& chunk )
         {
-            if ( stop_source.stop_requested() )
-                return;  // Early exit check
+            if ( !remaining.load( std::memory_order_relaxed ) )
+                return;
+
+            const auto buffer = read( chunk.address, chunk.size );
 
-            const auto buffer = read( region.address(), region.size() );
             if ( !buffer )
                 return;
 
-            std::span< std::uint8_t > bytes( buffer.get(), region.size() );
-            const auto result = patterns::scanner::find< patterns::scanner::algorithm_t::tbm_t >( bytes, object->vtable() );
+            auto& result = found[ &chunk - chunks.data() ];
 
-            if ( result )
+            for ( const auto offset : patterns::find_lanes( { buffer.get(), chunk.size }, set, sizeof( std::uintptr_t ) ) )
             {
-                address = region.address() + *result;
-                stop_source.request_stop();  // Signal other threads to stop
+                std::uint64_t value;
+                std::memcpy( &value, buffer.get() + offset, sizeof( value ) );
+
+                const auto index = *set.find( value );
+
+                if ( counts[ index ].load( std::memory_order_relaxed ) >= limit )
+                    continue;
+
+                if ( counts[ index ].fetch_add( 1, std::memory_order_relaxed ) + 1 == limit )
+                    remaining.fetch_sub( 1, std::memory_order_relaxed );
+
+                result.emplace_back( static_cast< std::uint32_t >( index ), chunk.address + offset );
             }
         };
 
         if ( parallelize )
-            std::for_each( std::execution::par_unseq, region_list.begin(), region_list.end(), lambda );
+            std::for_each( std::execution::par, chunks.begin(), chunks.end(), lambda );
+        else
+            std::for_each( chunks.begin(), chunks.end(), lambda );
+
+        // The chunks are in ascending order of address, so the instances of each object are as well.
+        for ( const auto& result : found )
+            for ( const auto& [ index, address ] : result )
+                if ( instances[ index ].size() < limit )
+                    instances[ index ].push_back( address );
+
+        return instances;
+    }
+
+    std::vector< std::uintptr_t > memory_factory::find_values( const patterns::value_query_t& query, bool parallelize ) const
+    {
+        return find_values( query, []( const memory::region_t& region ) { return true; }, parallelize );
+    }
+
+    std::vector< std::uintptr_t >
+    memory_factory::find_values( const patterns::value_query_t& query, const region_compare& compare, bool parallelize ) const
+    {
+        struct chunk_t
+        {
+            std::uintptr_t address;
+
+            // The size of the chunk, and the number of bytes read past it so that the values which start at its end are whole.
+            std::size_t size, overlap;
+        };
+
+        std::vector< chunk_t > chunks;
+
+        for ( const auto& region : regions() )
+        {
+            if ( !scannable( region ) || !compare( region ) )
+                continue;
+
+            for ( std::size_t offset = 0; offset < region.size(); offset += chunk_size )
+            {
+                const auto size = std::min( chunk_size, region.size() - offset );
+                chunks.push_back( { region.address() + offset, size, std::min( query.size() - 1, region.size() - offset - size ) } );
+            }
+        }
+
+        std::vector< std::vector< std::uintptr_t > > found( chunks.size() );
+
+        const auto lambda = [ & ]( const chunk_t& chunk )
+        {
+            const auto buffer = read( chunk.address, chunk.size + chunk.overlap );
+
+            if ( !buffer )
+                return;
+
+            // The overlap is shorter than a value, so no value starts in it and is found twice.
+            auto& results = found[ &chunk - chunks.data() ];
+            results = patterns::find_values( { buffer.get(), chunk.size + chunk.overlap }, query );
+
+            for ( auto& result : results )
+                result += chunk.address;
+        };
+
+        if ( parallelize )
+            std::for_each( std::execution::par, chunks.begin(), chunks.end(), lambda );
         else
-            std::for_each( std::execution::unseq, region_list.begin(), region_list.end(), lambda );
+            std::for_each( chunks.begin(), chunks.end(), lambda );
+
+        // The chunks are in ascending order, so appending their values keeps the whole list in order.
+        std::vector< std::uintptr_t > addresses;
+
+        for ( const auto& results : found )
+            addresses.insert( addresses.end(), results.begin(), results.end() );
+
+        return addresses;
+    }
+
+    patterns::scan_session memory_factory::scan_values( const patterns::value_query_t& query, bool parallelize ) const
+    {
+        return scan_values( query, []( const memory::region_t& region ) { return true; }, parallelize );
+    }
+
+    patterns::scan_session memory_factory::scan_values( const patterns::value_query_t& query, const region_compare& compare, bool parallelize ) const
+    {
+        return patterns::scan_session(
+            [ this ]( std::uintptr_t address, std::size_t size, std::uint8_t* buffer ) { return read( address, size, buffer ); },
+            scannable_ranges( regions(), compare ),
+            query,
+            parallelize );
+    }
+
+    patterns::scan_session
+    memory_factory::scan_unknown_values( patterns::value_type_t type, std::size_t alignment, const std::filesystem::path& spill, bool parallelize ) const
+    {
+        return scan_unknown_values( type, alignment, []( const memory::region_t& region ) { return true; }, spill, parallelize );
+    }
+
+    patterns::scan_session memory_factory::scan_unknown_values(
+        patterns::value_type_t type,
+        std::size_t alignment,
+        const region_compare& compare,
+        const std::filesystem::path& spill,
+        bool parallelize ) const
+    {
+        return patterns::scan_session(
+            [ this ]( std::uintptr_t address, std::size_t size, std::uint8_t* buffer ) { return read( address, size, buffer ); },
+            scannable_ranges( regions(), compare ),
+            type,
+            alignment,
+            spill,
+            parallelize );
+    }
+
+    patterns::pointer_map memory_factory::map_pointers( bool parallelize ) const
+    {
+        return map_pointers( []( const memory::region_t& region ) { return true; }, parallelize );
+    }
+
+    patterns::pointer_map memory_factory::map_pointers( const region_compare& compare, bool parallelize ) const
+    {
+        std::vector< patterns::pointer_image_t > images;
+
+        for ( const auto& module : p->module_factory.modules() )
+            images.push_back( { std::string( module->name() ), module->address(), module->size() } );
 
-        return address ? std::make_optional( address.load() ) : std::nullopt;
+        return patterns::pointer_map(
+            [ this ]( std::uintptr_t address, std::size_t size, std::uint8_t* buffer ) { return read( address, size, buffer ); },
+            scannable_ranges( regions(), compare ),
+            std::move( images ),
+            parallelize );
     }
 
     void memory_factory::free( std::uintptr_t address ) const
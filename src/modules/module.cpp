@@ -1,14 +1,53 @@
 #include "wincpp/modules/module.hpp"
 
 #include <algorithm>
+#include <array>
 
 #include "wincpp/modules/object.hpp"
 #include "wincpp/modules/section.hpp"
+#include "wincpp/patterns/generator.hpp"
 #include "wincpp/patterns/scanner.hpp"
+#include "wincpp/patterns/signature_set.hpp"
 #include "wincpp/process.hpp"
 
 namespace wincpp::modules
 {
+    struct module_t::code_index_t
+    {
+        /// <summary>
+        /// The code sections, concatenated in the order of `sections`.
+        /// </summary>
+        patterns::suffix_array_t index;
+
+        /// <summary>
+        /// A byte per byte of the index, nonzero if a base relocation patches it.
+        /// </summary>
+        std::vector< std::uint8_t > relocated;
+
+        /// <summary>
+        /// The RVA and size of every code section in the index.
+        /// </summary>
+        std::vector< std::pair< std::uint32_t, std::uint32_t > > sections;
+
+        /// <summary>
+        /// Converts an RVA to a location in the index.
+        /// </summary>
+        std::optional< std::size_t > offset_of( std::uintptr_t rva ) const noexcept
+        {
+            std::size_t offset = 0;
+
+            for ( const auto [ start, size ] : sections )
+            {
+                if ( rva >= start && rva - start < size )
+                    return offset + ( rva - start );
+
+                offset += size;
+            }
+
+            return std::nullopt;
+        }
+    };
+
     module_t::module_t( const memory_factory &factory, const core::module_entry_t &entry ) noexcept
         : memory_t( factory, entry.base_address, entry.base_size ),
           entry( entry ),
@@ -191,6 +230,198 @@ namespace wincpp::modules
         return objects;
     }
 
+    std::optional< patterns::pattern_t > module_t::generate_signature( std::uintptr_t address ) const
+    {
+        if ( !_code_index )
+        {
+            auto result = std::make_shared< code_index_t >();
+            std::vector< std::uint8_t > code;
+
+            const auto section = IMAGE_FIRST_SECTION( nt_headers );
+
+            for ( std::uint16_t i = 0; i < nt_headers->FileHeader.NumberOfSections; ++i )
+            {
+                if ( !( section[ i ].Characteristics & IMAGE_SCN_CNT_CODE ) )
+                    continue;
+
+                const auto size = section[ i ].Misc.VirtualSize;
+                const auto bytes = read( section[ i ].VirtualAddress, size );
+
+                if ( !bytes )
+                    continue;
+
+                code.insert( code.end(), bytes.get(), bytes.get() + size );
+                result->sections.emplace_back( section[ i ].VirtualAddress, size );
+            }
+
+            // Mark every byte that a DIR64 or HIGHLOW base relocation patches.
+            result->relocated.assign( code.size(), 0 );
+
+            const auto directory = nt_headers->OptionalHeader.DataDirectory[ IMAGE_DIRECTORY_ENTRY_BASERELOC ];
+
+            if ( directory.VirtualAddress && directory.Size )
+            {
+                const auto relocations = read( directory.VirtualAddress, directory.Size );
+
+                for ( std::size_t at = 0; relocations && at + sizeof( IMAGE_BASE_RELOCATION ) <= directory.Size; )
+                {
+                    const auto block = reinterpret_cast< const IMAGE_BASE_RELOCATION * >( relocations.get() + at );
+
+                    if ( block->SizeOfBlock < sizeof( IMAGE_BASE_RELOCATION ) || at + block->SizeOfBlock > directory.Size )
+                        break;
+
+                    const auto entries = reinterpret_cast< const std::uint16_t * >( block + 1 );
+                    const auto count = ( block->SizeOfBlock - sizeof( IMAGE_BASE_RELOCATION ) ) / sizeof( std::uint16_t );
+
+                    for ( std::size_t i = 0; i < count; ++i )
+                    {
+                        const auto type = entries[ i ] >> 12;
+                        const auto width = type == IMAGE_REL_BASED_DIR64 ? 8 : type == IMAGE_REL_BASED_HIGHLOW ? 4 : 0;
+
+                        for ( auto j = 0; j < width; ++j )
+                        {
+                            if ( const auto offset = result->offset_of( block->VirtualAddress + ( entries[ i ] & 0xFFF ) + j ) )
+                                result->relocated[ *offset ] = 1;
+                        }
+                    }
+
+                    at += block->SizeOfBlock;
+                }
+            }
+
+            result->index = patterns::suffix_array_t( std::move( code ) );
+            _code_index = std::move( result );
+        }
+
+        const auto offset = _code_index->offset_of( address - this->address() );
+
+        if ( !offset )
+            return std::nullopt;
+
+        return patterns::generate_signature( _code_index->index, *offset, _code_index->relocated );
+    }
+
+    std::shared_ptr< const patterns::image_index > module_t::index( const std::filesystem::path& path ) const
+    {
+        if ( _image_index )
+            return _image_index;
+
+        const auto print = fingerprint();
+
+        if ( !path.empty() )
+        {
+            if ( auto loaded = patterns::image_index::load( path, print ) )
+                return _image_index = std::make_shared< const patterns::image_index >( std::move( *loaded ) );
+        }
+
+        const auto image = read();
+        auto built = std::make_shared< const patterns::image_index >( std::span< const std::uint8_t >( image.get(), size() ) );
+
+        if ( !path.empty() )
+            built->save( path, print );
+
+        return _image_index = std::move( built );
+    }
+
+    patterns::image_fingerprint_t module_t::fingerprint( bool hash_code ) const
+    {
+        patterns::image_fingerprint_t result{ nt_headers->FileHeader.TimeDateStamp,
+                                              nt_headers->OptionalHeader.SizeOfImage,
+                                              nt_headers->OptionalHeader.CheckSum };
+
+        if ( !hash_code )
+            return result;
+
+        const auto section = IMAGE_FIRST_SECTION( nt_headers );
+
+        for ( std::uint16_t i = 0; i < nt_headers->FileHeader.NumberOfSections; ++i )
+        {
+            if ( !( section[ i ].Characteristics & IMAGE_SCN_CNT_CODE ) )
+                continue;
+
+            const auto size = section[ i ].Misc.VirtualSize;
+            const auto code = read( section[ i ].VirtualAddress, size );
+
+            if ( code )
+                result.code_hash = patterns::signature_cache::hash( { code.get(), size }, result.code_hash );
+        }
+
+        return result;
+    }
+
+    std::vector< std::optional< std::uintptr_t > > module_t::resolve( const patterns::signature_set &set, patterns::signature_cache &cache ) const
+    {
+        const auto print = fingerprint( cache.hash_code() );
+
+        // Take what we can from the cache, and collect the rest into a smaller set that is scanned in one pass.
+        std::vector< std::optional< std::uintptr_t > > matches( set.size() );
+        std::vector< patterns::pattern_t > missing;
+        std::vector< std::size_t > ids;
+
+        // A cached location is checked against the module before it is trusted, since the fingerprint doesn't catch every patch.
+        const auto verify = [ this ]( std::uintptr_t offset, const patterns::compiled_pattern_t &pattern )
+        {
+            std::array< std::uint8_t, patterns::pattern_t::max_size > bytes;
+
+            return pattern.size() <= size() && offset <= size() - pattern.size() &&
+                   factory.read( address() + offset, pattern.size(), bytes.data() ) && pattern.matches( bytes.data() );
+        };
+
+        for ( std::size_t id = 0; id < set.size(); ++id )
+        {
+            const auto offset = cache.lookup( name(), print, set.signature( id ).pattern );
+
+            if ( offset == patterns::signature_cache::not_found )
+                continue;
+
+            if ( offset && verify( *offset, set[ id ] ) )
+            {
+                matches[ id ] = address() + *offset;
+            }
+            else
+            {
+                missing.push_back( set.signature( id ).pattern );
+                ids.push_back( id );
+            }
+        }
+
+        if ( !missing.empty() )
+        {
+            const auto found = find( patterns::signature_set( missing ) );
+
+            for ( std::size_t i = 0; i < found.size(); ++i )
+            {
+                if ( !found[ i ] )
+                {
+                    cache.store( name(), print, missing[ i ], patterns::signature_cache::not_found );
+                    continue;
+                }
+
+                matches[ ids[ i ] ] = *found[ i ];
+                cache.store( name(), print, missing[ i ], *found[ i ] - address() );
+            }
+        }
+
+        // The steps are always run, because they may dereference pointers that differ between runs.
+        const auto reader = [ this ]( std::uintptr_t address, std::span< std::uint8_t > out )
+        { return factory.read( address, out.size(), out.data() ); };
+
+        std::vector< std::optional< std::uintptr_t > > results( set.size() );
+
+        for ( std::size_t id = 0; id < set.size(); ++id )
+        {
+            if ( matches[ id ] )
+                results[ id ] = set.signature( id ).resolve( *matches[ id ], reader );
+        }
+
+        return results;
+    }
+
+    std::optional< std::uintptr_t > module_t::resolve( const patterns::signature_t &signature, patterns::signature_cache &cache ) const
+    {
+        return resolve( patterns::signature_set( { signature } ), cache ).front();
+    }
+
     const module_t::export_t &module_t::operator[]( const std::string_view name ) const
     {
         if ( const auto result = fetch_export( name ) )
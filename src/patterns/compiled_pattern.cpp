@@ -0,0 +1,139 @@
+#include "wincpp/patterns/compiled_pattern.hpp"
+
+#include <algorithm>
+#include <bit>
+
+namespace wincpp::patterns
+{
+    compiled_pattern_t::compiled_pattern_t( const pattern_t& pattern ) noexcept
+        : pattern( pattern )
+    {
+        for ( std::size_t i = 0; i < pattern.size; ++i )
+        {
+            mask[ i ] = pattern.atoms[ i ].mask;
+            value[ i ] = pattern.atoms[ i ].value & mask[ i ];
+
+            if ( mask[ i ] != 0x00 || pattern.class_of( i ) )
+                ++strict;
+        }
+
+        exact = pattern.class_count == 0 && std::all_of( mask.begin(), mask.begin() + pattern.size, []( std::uint8_t m ) { return m == 0xFF; } );
+
+        // Every byte accepted at a position limits the shift to that position, so a wildcard before the final position caps every shift.
+        std::fill( skip_table.begin(), skip_table.end(), pattern.size );
+
+        for ( std::size_t i = 0; i + 1 < pattern.size; ++i )
+        {
+            const auto distance = pattern.size - 1 - i;
+
+            if ( pattern.literal( i ) )
+            {
+                skip_table[ value[ i ] ] = std::min( skip_table[ value[ i ] ], distance );
+                continue;
+            }
+
+            for ( std::size_t byte = 0; byte < 256; ++byte )
+            {
+                if ( pattern.accepts( i, static_cast< std::uint8_t >( byte ) ) )
+                    skip_table[ byte ] = std::min( skip_table[ byte ], distance );
+            }
+        }
+
+        // Encode every position of the pattern into the masks of the bytes it accepts.
+        for ( std::size_t i = 0; i < pattern.size; ++i )
+        {
+            for ( std::size_t byte = 0; byte < 256; ++byte )
+            {
+                if ( pattern.accepts( i, static_cast< std::uint8_t >( byte ) ) )
+                    position_masks[ byte ] |= std::uint64_t( 1 ) << i;
+            }
+        }
+
+        if ( pattern.size != 0 )
+        {
+            const auto m = pattern.size;
+
+            // Two positions are compatible if some byte could pass both. Byte classes are ignored, which only makes the shifts smaller.
+            const auto compatible = [ & ]( std::size_t a, std::size_t b ) { return ( ( value[ a ] ^ value[ b ] ) & mask[ a ] & mask[ b ] ) == 0; };
+
+            // A shift `s` is safe after a mismatch at position `i` if the pattern overlaps itself on every position after `i`. Find the last
+            // conflicting position of every shift and keep the smallest shift per conflict.
+            std::array< std::size_t, pattern_t::max_size > smallest;
+
+            smallest.fill( m );
+
+            for ( std::size_t shift = 1; shift < m; ++shift )
+            {
+                std::size_t conflict = 0;
+
+                for ( std::size_t k = m - 1; k >= shift; --k )
+                {
+                    if ( !compatible( k - shift, k ) )
+                    {
+                        conflict = k;
+                        break;
+                    }
+                }
+
+                smallest[ conflict ] = std::min( smallest[ conflict ], shift );
+            }
+
+            for ( std::size_t i = 0, best = m; i < m; ++i )
+            {
+                best = std::min( best, smallest[ i ] );
+                good_suffix[ i ] = best;
+            }
+        }
+
+        // Pick the two most selective positions as anchors. Strict bytes are ranked by how rare they are, and every unknown bit of a position
+        // ranks it below all strict bytes.
+        const auto score = [ & ]( std::size_t i ) { return ( 8 - std::popcount( mask[ i ] ) ) * 256 + frequency( value[ i ] ); };
+
+        std::size_t best = pattern.size, second = pattern.size;
+
+        for ( std::size_t i = 0; i < pattern.size; ++i )
+        {
+            if ( mask[ i ] == 0x00 )
+                continue;
+
+            if ( best == pattern.size || score( i ) < score( best ) )
+            {
+                second = best;
+                best = i;
+            }
+            else if ( second == pattern.size || score( i ) < score( second ) )
+            {
+                second = i;
+            }
+        }
+
+        if ( best == pattern.size )
+            best = 0;
+
+        if ( second == pattern.size )
+            second = best;
+
+        anchors = { std::min( best, second ), std::max( best, second ) };
+    }
+
+    std::uint8_t compiled_pattern_t::frequency( std::uint8_t byte ) noexcept
+    {
+        // The most common bytes in x86-64 code and data sections, most common first.
+        static constexpr std::uint8_t common[] = { 0x00, 0xFF, 0xCC, 0x48, 0x8B, 0x89, 0x24, 0x0F, 0x4C, 0x8D, 0x44, 0xE8, 0x01,
+                                                   0x83, 0x45, 0x85, 0xC0, 0x74, 0x10, 0x08, 0x20, 0x41, 0x49, 0x75, 0x4D, 0x90,
+                                                   0xC3, 0x40, 0x33, 0x18, 0x28, 0x30, 0xE9, 0xEB, 0x02, 0x04, 0x03, 0x5C, 0xD2 };
+
+        static const auto table = []
+        {
+            std::array< std::uint8_t, 256 > result;
+            result.fill( 0 );
+
+            for ( std::size_t i = 0; i < std::size( common ); ++i )
+                result[ common[ i ] ] = static_cast< std::uint8_t >( 255 - i );
+
+            return result;
+        }();
+
+        return table[ byte ];
+    }
+}  // namespace wincpp::patterns
\ No newline at end of file
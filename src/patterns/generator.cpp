@@ -0,0 +1,310 @@
+#include "wincpp/patterns/generator.hpp"
+
+#include <algorithm>
+#include <array>
+
+namespace wincpp::patterns
+{
+    namespace
+    {
+        /// <summary>
+        /// The parts of a decoded instruction that a signature cares about.
+        /// </summary>
+        struct instruction_t
+        {
+            /// <summary>
+            /// The length of the instruction in bytes.
+            /// </summary>
+            std::size_t length = 0;
+
+            /// <summary>
+            /// The location and size of the rel32 operand or RIP-relative displacement, if any. The size is zero if there is none.
+            /// </summary>
+            std::size_t operand = 0, operand_size = 0;
+        };
+
+        // Bit sets over the opcode byte, 64 bits per word.
+        using opcodes_t = std::array< std::uint64_t, 4 >;
+
+        constexpr opcodes_t opcodes( std::initializer_list< std::pair< std::uint8_t, std::uint8_t > > ranges ) noexcept
+        {
+            opcodes_t result{};
+
+            for ( const auto& [ first, last ] : ranges )
+            {
+                for ( auto op = std::size_t( first ); op <= last; ++op )
+                    result[ op >> 6 ] |= std::uint64_t( 1 ) << ( op & 63 );
+            }
+
+            return result;
+        }
+
+        constexpr bool contains( const opcodes_t& set, std::uint8_t op ) noexcept
+        {
+            return ( set[ op >> 6 ] >> ( op & 63 ) ) & 1;
+        }
+
+        // One-byte opcodes with a ModRM byte.
+        constexpr auto modrm_1 = opcodes( { { 0x00, 0x03 }, { 0x08, 0x0B }, { 0x10, 0x13 }, { 0x18, 0x1B }, { 0x20, 0x23 }, { 0x28, 0x2B },
+                                            { 0x30, 0x33 }, { 0x38, 0x3B }, { 0x63, 0x63 }, { 0x69, 0x69 }, { 0x6B, 0x6B }, { 0x80, 0x81 },
+                                            { 0x83, 0x8F }, { 0xC0, 0xC1 }, { 0xC6, 0xC7 }, { 0xD0, 0xD3 }, { 0xD8, 0xDF }, { 0xF6, 0xF7 },
+                                            { 0xFE, 0xFF } } );
+
+        // One-byte opcodes with an 8-bit immediate.
+        constexpr auto imm8_1 = opcodes( { { 0x04, 0x04 }, { 0x0C, 0x0C }, { 0x14, 0x14 }, { 0x1C, 0x1C }, { 0x24, 0x24 }, { 0x2C, 0x2C },
+                                           { 0x34, 0x34 }, { 0x3C, 0x3C }, { 0x6A, 0x6B }, { 0x70, 0x80 }, { 0x83, 0x83 }, { 0xA8, 0xA8 },
+                                           { 0xB0, 0xB7 }, { 0xC0, 0xC1 }, { 0xC6, 0xC6 }, { 0xCD, 0xCD }, { 0xE0, 0xE7 }, { 0xEB, 0xEB } } );
+
+        // One-byte opcodes with a 16- or 32-bit immediate, depending on the operand size.
+        constexpr auto immz_1 = opcodes( { { 0x05, 0x05 }, { 0x0D, 0x0D }, { 0x15, 0x15 }, { 0x1D, 0x1D }, { 0x25, 0x25 }, { 0x2D, 0x2D },
+                                           { 0x35, 0x35 }, { 0x3D, 0x3D }, { 0x68, 0x69 }, { 0x81, 0x81 }, { 0xA9, 0xA9 }, { 0xB8, 0xBF },
+                                           { 0xC7, 0xC7 } } );
+
+        // One-byte opcodes that don't exist in 64-bit mode.
+        constexpr auto invalid_1 = opcodes( { { 0x06, 0x07 }, { 0x0E, 0x0E }, { 0x16, 0x17 }, { 0x1E, 0x1F }, { 0x27, 0x27 }, { 0x2F, 0x2F },
+                                              { 0x37, 0x37 }, { 0x3F, 0x3F }, { 0x60, 0x61 }, { 0x82, 0x82 }, { 0x9A, 0x9A }, { 0xCE, 0xCE },
+                                              { 0xD4, 0xD6 }, { 0xEA, 0xEA } } );
+
+        // Two-byte (0F) opcodes without a ModRM byte.
+        constexpr auto no_modrm_2 = opcodes( { { 0x05, 0x09 }, { 0x0B, 0x0B }, { 0x30, 0x37 }, { 0x77, 0x77 }, { 0x80, 0x8F }, { 0xA0, 0xA2 },
+                                               { 0xA8, 0xAA }, { 0xC8, 0xCF } } );
+
+        // Two-byte (0F) opcodes with an 8-bit immediate.
+        constexpr auto imm8_2 = opcodes( { { 0x70, 0x73 }, { 0xA4, 0xA4 }, { 0xAC, 0xAC }, { 0xBA, 0xBA }, { 0xC2, 0xC2 }, { 0xC4, 0xC6 } } );
+
+        /// <summary>
+        /// Decodes the length of an x86-64 instruction and finds its position-dependent operand. Covers the legacy, VEX and EVEX encodings
+        /// that compilers emit; anything else isn't recognized.
+        /// </summary>
+        std::optional< instruction_t > decode( const std::uint8_t* code, std::size_t available ) noexcept
+        {
+            instruction_t result;
+            std::size_t i = 0;
+            bool operand_16 = false, address_32 = false, rex_w = false;
+
+            const auto next = [ & ]() -> std::optional< std::uint8_t >
+            {
+                if ( i >= available || i >= 15 )
+                    return std::nullopt;
+
+                return code[ i++ ];
+            };
+
+            auto op = next();
+
+            // Legacy prefixes, then REX.
+            while ( op && ( *op == 0x66 || *op == 0x67 || *op == 0xF0 || *op == 0xF2 || *op == 0xF3 || *op == 0x2E || *op == 0x36 ||
+                            *op == 0x3E || *op == 0x26 || *op == 0x64 || *op == 0x65 ) )
+            {
+                operand_16 |= *op == 0x66;
+                address_32 |= *op == 0x67;
+                op = next();
+            }
+
+            if ( op && ( *op & 0xF0 ) == 0x40 )
+            {
+                rex_w = *op & 0x08;
+                op = next();
+            }
+
+            if ( !op )
+                return std::nullopt;
+
+            // 0 for the one-byte map, otherwise 1, 2 or 3 for 0F, 0F 38 and 0F 3A.
+            std::size_t map = 0;
+            bool has_modrm = false;
+            std::size_t immediate = 0;
+
+            if ( *op == 0xC4 || *op == 0xC5 || *op == 0x62 )
+            {
+                // VEX and EVEX carry the map in their payload, and are always followed by the opcode and a ModRM byte (except vzeroupper).
+                const auto payload = *op == 0xC5 ? 1 : *op == 0xC4 ? 2 : 3;
+                const auto first = next();
+
+                if ( !first )
+                    return std::nullopt;
+
+                map = *op == 0xC5 ? 1 : ( *first & ( *op == 0x62 ? 0x07 : 0x1F ) );
+
+                for ( auto k = 1; k < payload; ++k )
+                {
+                    if ( !next() )
+                        return std::nullopt;
+                }
+
+                op = next();
+
+                if ( !op || map < 1 || map > 3 )
+                    return std::nullopt;
+
+                has_modrm = !( map == 1 && *op == 0x77 );
+                immediate = map == 3 || ( map == 1 && contains( imm8_2, *op ) ) ? 1 : 0;
+            }
+            else if ( *op == 0x0F )
+            {
+                op = next();
+
+                if ( !op )
+                    return std::nullopt;
+
+                if ( *op == 0x38 || *op == 0x3A )
+                {
+                    map = *op == 0x38 ? 2 : 3;
+                    op = next();
+
+                    if ( !op )
+                        return std::nullopt;
+
+                    has_modrm = true;
+                    immediate = map == 3 ? 1 : 0;
+                }
+                else
+                {
+                    map = 1;
+                    has_modrm = !contains( no_modrm_2, *op );
+                    immediate = contains( imm8_2, *op ) ? 1 : 0;
+
+                    // Jcc rel32.
+                    if ( *op >= 0x80 && *op <= 0x8F )
+                    {
+                        result.operand = i;
+                        result.operand_size = 4;
+                        immediate = 4;
+                    }
+                }
+            }
+            else
+            {
+                if ( contains( invalid_1, *op ) )
+                    return std::nullopt;
+
+                has_modrm = contains( modrm_1, *op );
+
+                if ( contains( imm8_1, *op ) )
+                    immediate += 1;
+
+                if ( contains( immz_1, *op ) )
+                    immediate += ( *op >= 0xB8 && *op <= 0xBF && rex_w ) ? 8 : operand_16 ? 2 : 4;
+
+                switch ( *op )
+                {
+                    case 0xA0:
+                    case 0xA1:
+                    case 0xA2:
+                    case 0xA3: immediate = address_32 ? 4 : 8; break;
+                    case 0xC2:
+                    case 0xCA: immediate = 2; break;
+                    case 0xC8: immediate = 3; break;
+                    case 0xE8:
+                    case 0xE9:
+                        // Call and jmp rel32.
+                        result.operand = i;
+                        result.operand_size = 4;
+                        immediate = 4;
+                        break;
+                    default: break;
+                }
+            }
+
+            if ( has_modrm )
+            {
+                const auto modrm = next();
+
+                if ( !modrm )
+                    return std::nullopt;
+
+                const auto mod = *modrm >> 6, reg = ( *modrm >> 3 ) & 7, rm = *modrm & 7;
+
+                // The test forms of F6 and F7 are the only members of their groups with an immediate.
+                if ( map == 0 && ( *op == 0xF6 || *op == 0xF7 ) && reg <= 1 )
+                    immediate = *op == 0xF6 ? 1 : operand_16 ? 2 : 4;
+
+                std::size_t displacement = mod == 1 ? 1 : mod == 2 ? 4 : 0;
+
+                if ( mod != 3 && rm == 4 )
+                {
+                    const auto sib = next();
+
+                    if ( !sib )
+                        return std::nullopt;
+
+                    if ( mod == 0 && ( *sib & 7 ) == 5 )
+                        displacement = 4;
+                }
+                else if ( mod == 0 && rm == 5 )
+                {
+                    // RIP-relative.
+                    result.operand = i;
+                    result.operand_size = 4;
+                    displacement = 4;
+                }
+
+                i += displacement;
+            }
+
+            i += immediate;
+
+            if ( i > available || i > 15 )
+                return std::nullopt;
+
+            result.length = i;
+            return result;
+        }
+    }  // namespace
+
+    std::optional< pattern_t > generate_signature( const suffix_array_t& index, std::size_t offset, std::span< const std::uint8_t > relocated ) noexcept
+    {
+        const auto text = index.text();
+
+        if ( offset >= text.size() )
+            return std::nullopt;
+
+        const auto window = std::min( pattern_t::max_size, text.size() - offset );
+
+        pattern_t candidate;
+
+        for ( std::size_t i = 0; i < window; ++i )
+        {
+            const auto volatile_byte = !relocated.empty() && relocated[ offset + i ];
+            candidate.atoms[ i ] = volatile_byte ? atom_t{} : atom_t{ text[ offset + i ], 0xFF };
+        }
+
+        // Wildcard the operands that depend on where the code and its targets were placed.
+        for ( std::size_t position = 0; position < window; )
+        {
+            const auto instruction = decode( text.data() + offset + position, text.size() - offset - position );
+
+            if ( !instruction )
+                break;
+
+            for ( std::size_t i = 0; i < instruction->operand_size && position + instruction->operand + i < window; ++i )
+                candidate.atoms[ position + instruction->operand + i ] = atom_t{};
+
+            position += instruction->length;
+        }
+
+        const auto unique = [ & ]( std::size_t length )
+        {
+            candidate.size = length;
+            return index.count( candidate, 2 ) == 1;
+        };
+
+        if ( !unique( window ) )
+            return std::nullopt;
+
+        std::size_t low = 1, high = window;
+
+        while ( low < high )
+        {
+            const auto middle = low + ( high - low ) / 2;
+
+            if ( unique( middle ) )
+                high = middle;
+            else
+                low = middle + 1;
+        }
+
+        candidate.size = low;
+        return candidate;
+    }
+}  // namespace wincpp::patterns
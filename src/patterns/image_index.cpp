@@ -0,0 +1,541 @@
+#include "wincpp/patterns/image_index.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <fstream>
+#include <system_error>
+
+#include "wincpp/patterns/suffix_array.hpp"
+
+namespace wincpp::patterns
+{
+    namespace
+    {
+        // The first bytes of every index file, followed by the format version.
+        constexpr std::uint32_t magic = 0x49464357;  // "WCFI"
+        constexpr std::uint32_t version = 1;
+
+        // The copies of the start and end of the image hold a full pattern.
+        constexpr std::size_t edge_size = pattern_t::max_size;
+
+        template< typename T >
+        void write( std::ofstream& out, const T& value )
+        {
+            out.write( reinterpret_cast< const char* >( &value ), sizeof( T ) );
+        }
+
+        template< typename T >
+        void write( std::ofstream& out, const std::vector< T >& values )
+        {
+            out.write( reinterpret_cast< const char* >( values.data() ), static_cast< std::streamsize >( values.size() * sizeof( T ) ) );
+        }
+
+        template< typename T >
+        bool read( std::ifstream& in, T& value )
+        {
+            return static_cast< bool >( in.read( reinterpret_cast< char* >( &value ), sizeof( T ) ) );
+        }
+
+        template< typename T >
+        bool read( std::ifstream& in, std::vector< T >& values, std::size_t count )
+        {
+            values.resize( count );
+            return static_cast< bool >( in.read( reinterpret_cast< char* >( values.data() ), static_cast< std::streamsize >( count * sizeof( T ) ) ) );
+        }
+
+        /// <summary>
+        /// A position of a pattern that accepts every byte and can be trimmed from either end.
+        /// </summary>
+        bool trimmable( const compiled_pattern_t& pattern, std::size_t position ) noexcept
+        {
+            return pattern.mask[ position ] == 0 && !pattern.pattern.class_of( position );
+        }
+    }  // namespace
+
+    void image_index::bit_vector_t::resize( std::size_t size )
+    {
+        // A spare block gives the rank of the position after the last bit a count to start from.
+        blocks.assign( size / block_bits + 1, block_t{} );
+    }
+
+    void image_index::bit_vector_t::set( std::size_t position ) noexcept
+    {
+        const auto offset = position % block_bits;
+        blocks[ position / block_bits ].words[ offset >> 6 ] |= std::uint64_t( 1 ) << ( offset & 63 );
+    }
+
+    void image_index::bit_vector_t::build() noexcept
+    {
+        std::uint64_t total = 0;
+
+        for ( auto& block : blocks )
+        {
+            block.rank = total;
+
+            for ( const auto word : block.words )
+                total += std::popcount( word );
+        }
+    }
+
+    bool image_index::bit_vector_t::get( std::size_t position ) const noexcept
+    {
+        const auto offset = position % block_bits;
+        return ( blocks[ position / block_bits ].words[ offset >> 6 ] >> ( offset & 63 ) ) & 1;
+    }
+
+    std::size_t image_index::bit_vector_t::rank( std::size_t position ) const noexcept
+    {
+        const auto& block = blocks[ position / block_bits ];
+        const auto offset = position % block_bits, word = offset >> 6;
+
+        std::size_t result = block.rank;
+
+        for ( std::size_t i = 0; i < word; ++i )
+            result += std::popcount( block.words[ i ] );
+
+        if ( offset & 63 )
+            result += std::popcount( block.words[ word ] & ( ( std::uint64_t( 1 ) << ( offset & 63 ) ) - 1 ) );
+
+        return result;
+    }
+
+    image_index::image_index( std::span< const std::uint8_t > image ) : _size( image.size() )
+    {
+        // The rows of the transform are the sorted suffixes of the image followed by an end marker that sorts before every byte, so the
+        // first row is the empty suffix and the rest follow the suffix array of the image.
+        const auto rows = _size + 1;
+        std::vector< std::uint8_t > bytes( rows );
+
+        _sampled.resize( rows );
+
+        {
+            const auto suffixes = suffix_array_t::build( image );
+
+            for ( std::size_t row = 0; row < rows; ++row )
+            {
+                const std::size_t location = row == 0 ? _size : suffixes[ row - 1 ];
+
+                // The end marker is stored as a zero, and subtracted from the rank of zero where it matters.
+                if ( location == 0 )
+                    _primary = row;
+                else
+                    bytes[ row ] = image[ location - 1 ];
+
+                if ( location % sample_rate == 0 )
+                {
+                    _sampled.set( row );
+                    _samples.push_back( static_cast< std::uint32_t >( location ) );
+                }
+            }
+        }
+
+        // Every level stably moves the bytes with a zero in its bit in front of those with a one.
+        std::vector< std::uint8_t > next( rows );
+
+        for ( std::size_t level = 0; level < _levels.size(); ++level )
+        {
+            const auto bit = 7 - level;
+            auto& vector = _levels[ level ];
+
+            vector.resize( rows );
+
+            std::size_t zeros = 0;
+
+            for ( std::size_t row = 0; row < rows; ++row )
+            {
+                if ( ( bytes[ row ] >> bit ) & 1 )
+                    vector.set( row );
+                else
+                    ++zeros;
+            }
+
+            auto zero = next.begin(), one = next.begin() + static_cast< std::ptrdiff_t >( zeros );
+
+            for ( const auto byte : bytes )
+                *( ( ( byte >> bit ) & 1 ) ? one++ : zero++ ) = byte;
+
+            bytes.swap( next );
+        }
+
+        const auto edge = std::min( edge_size, _size );
+
+        _head.assign( image.begin(), image.begin() + edge );
+        _tail.assign( image.end() - edge, image.end() );
+
+        finish();
+    }
+
+    void image_index::finish()
+    {
+        const auto rows = _size + 1;
+
+        for ( std::size_t level = 0; level < _levels.size(); ++level )
+        {
+            _levels[ level ].build();
+            _zeros[ level ] = rows - _levels[ level ].rank( rows );
+        }
+
+        _sampled.build();
+
+        // Walking a byte down the matrix from a row gives its rank on the last level, where every byte occupies a contiguous range.
+        const auto walk = [ this ]( std::size_t byte, std::size_t row )
+        {
+            for ( std::size_t level = 0; level < _levels.size(); ++level )
+            {
+                const auto ones = _levels[ level ].rank( row );
+                row = ( ( byte >> ( 7 - level ) ) & 1 ) ? _zeros[ level ] + ones : row - ones;
+            }
+
+            return row;
+        };
+
+        // The end marker sorts first.
+        _first[ 0 ] = 1;
+
+        for ( std::size_t byte = 0; byte < 256; ++byte )
+        {
+            _begin[ byte ] = walk( byte, 0 );
+
+            const auto count = walk( byte, rows ) - _begin[ byte ] - ( byte == 0 ? 1 : 0 );
+            _first[ byte + 1 ] = _first[ byte ] + count;
+        }
+    }
+
+    std::size_t image_index::size() const noexcept
+    {
+        return _size;
+    }
+
+    std::size_t image_index::memory_usage() const noexcept
+    {
+        std::size_t result = sizeof( *this ) + _samples.size() * sizeof( std::uint32_t ) + _head.size() + _tail.size();
+
+        for ( const auto* vector : { &_levels[ 0 ], &_levels[ 1 ], &_levels[ 2 ], &_levels[ 3 ], &_levels[ 4 ], &_levels[ 5 ], &_levels[ 6 ],
+                                     &_levels[ 7 ], &_sampled } )
+            result += vector->blocks.size() * sizeof( bit_vector_t::block_t );
+
+        return result;
+    }
+
+    std::size_t image_index::last_to_first( std::size_t row ) const noexcept
+    {
+        std::size_t byte = 0, position = row;
+
+        for ( std::size_t level = 0; level < _levels.size(); ++level )
+        {
+            const auto ones = _levels[ level ].rank( position );
+
+            if ( _levels[ level ].get( position ) )
+            {
+                byte |= std::size_t( 1 ) << ( 7 - level );
+                position = _zeros[ level ] + ones;
+            }
+            else
+            {
+                position -= ones;
+            }
+        }
+
+        auto rank = position - _begin[ byte ];
+
+        if ( byte == 0 && _primary < row )
+            --rank;
+
+        return _first[ byte ] + rank;
+    }
+
+    std::size_t image_index::location_of( std::size_t row ) const noexcept
+    {
+        std::size_t steps = 0;
+
+        // The suffix at the start of the image is always sampled, so the walk never steps onto the end marker.
+        while ( !_sampled.get( row ) )
+        {
+            row = last_to_first( row );
+            ++steps;
+        }
+
+        return _samples[ _sampled.rank( row ) ] + steps;
+    }
+
+    template< typename callback_t >
+    bool image_index::search( const compiled_pattern_t& pattern, std::size_t first, std::size_t last, callback_t&& callback ) const noexcept
+    {
+        // Prepends the position before `position` to the rows [low, high), branching into every byte in the transform of those rows that the
+        // position accepts. The bits of a strict mask prune the descent through the matrix, so a strict byte never branches.
+        const auto extend = [ & ]( const auto& extend, std::size_t position, std::size_t low, std::size_t high ) -> bool
+        {
+            if ( low >= high )
+                return true;
+
+            if ( position == first )
+                return callback( low, high );
+
+            const auto i = position - 1;
+            const auto value = pattern.value[ i ], mask = pattern.mask[ i ];
+
+            const auto descend = [ & ]( const auto& descend, std::size_t level, std::size_t begin, std::size_t end, std::size_t byte ) -> bool
+            {
+                if ( begin >= end )
+                    return true;
+
+                if ( level == _levels.size() )
+                {
+                    if ( !( ( pattern.position_masks[ byte ] >> i ) & 1 ) )
+                        return true;
+
+                    auto rank_low = begin - _begin[ byte ], rank_high = end - _begin[ byte ];
+
+                    if ( byte == 0 )
+                    {
+                        rank_low -= _primary < low ? 1 : 0;
+                        rank_high -= _primary < high ? 1 : 0;
+                    }
+
+                    return extend( extend, i, _first[ byte ] + rank_low, _first[ byte ] + rank_high );
+                }
+
+                const auto bit = 7 - level;
+                const auto fixed = ( mask >> bit ) & 1, one = ( value >> bit ) & 1;
+                const auto ones_begin = _levels[ level ].rank( begin ), ones_end = _levels[ level ].rank( end );
+
+                if ( ( !fixed || !one ) && !descend( descend, level + 1, begin - ones_begin, end - ones_end, byte ) )
+                    return false;
+
+                if ( ( !fixed || one ) &&
+                     !descend( descend, level + 1, _zeros[ level ] + ones_begin, _zeros[ level ] + ones_end, byte | ( std::size_t( 1 ) << bit ) ) )
+                    return false;
+
+                return true;
+            };
+
+            return descend( descend, 0, low, high, 0 );
+        };
+
+        return extend( extend, last, 0, _size + 1 );
+    }
+
+    std::size_t image_index::overhanging( const compiled_pattern_t& pattern, std::size_t first, std::size_t last ) const noexcept
+    {
+        const auto size = pattern.size(), length = last - first;
+
+        // Reads a byte of the image near either end.
+        const auto at = [ & ]( std::size_t location ) { return location < _head.size() ? _head[ location ] : _tail[ location - ( _size - _tail.size() ) ]; };
+
+        const auto matches = [ & ]( std::size_t location )
+        {
+            for ( auto i = first; i < last; ++i )
+            {
+                if ( !( ( pattern.position_masks[ at( location + i - first ) ] >> i ) & 1 ) )
+                    return false;
+            }
+
+            return true;
+        };
+
+        std::size_t result = 0;
+
+        // Too close to the start for the leading wildcards, or too close to the end for the trailing ones.
+        for ( std::size_t location = 0; location < first && location + length <= _size; ++location )
+            result += matches( location ) ? 1 : 0;
+
+        for ( auto location = _size - size + first + 1; location + length <= _size; ++location )
+            result += matches( location ) ? 1 : 0;
+
+        return result;
+    }
+
+    std::size_t image_index::count( const pattern_t& pattern, std::size_t limit ) const noexcept
+    {
+        const auto size = pattern.size;
+
+        if ( limit == 0 || size == 0 || size > _size )
+            return 0;
+
+        const compiled_pattern_t compiled( pattern );
+
+        std::size_t first = 0, last = size;
+
+        while ( first < last && trimmable( compiled, first ) )
+            ++first;
+
+        while ( last > first && trimmable( compiled, last - 1 ) )
+            --last;
+
+        if ( first == last )
+            return std::min( _size - size + 1, limit );
+
+        // The search finds the trimmed pattern, so the occurrences the full pattern doesn't fit around are subtracted.
+        const auto excess = overhanging( compiled, first, last );
+        std::size_t total = 0;
+
+        search( compiled,
+                first,
+                last,
+                [ & ]( std::size_t low, std::size_t high )
+                {
+                    total += high - low;
+                    return total < excess || total - excess < limit;
+                } );
+
+        return std::min( total - excess, limit );
+    }
+
+    std::vector< std::uintptr_t > image_index::locate( const pattern_t& pattern, std::size_t limit ) const noexcept
+    {
+        std::vector< std::uintptr_t > results;
+        const auto size = pattern.size;
+
+        if ( limit == 0 || size == 0 || size > _size )
+            return results;
+
+        const compiled_pattern_t compiled( pattern );
+
+        std::size_t first = 0, last = size;
+
+        while ( first < last && trimmable( compiled, first ) )
+            ++first;
+
+        while ( last > first && trimmable( compiled, last - 1 ) )
+            --last;
+
+        if ( first == last )
+        {
+            results.resize( std::min( _size - size + 1, limit ) );
+
+            for ( std::size_t i = 0; i < results.size(); ++i )
+                results[ i ] = i;
+
+            return results;
+        }
+
+        search( compiled,
+                first,
+                last,
+                [ & ]( std::size_t low, std::size_t high )
+                {
+                    for ( auto row = low; row < high; ++row )
+                    {
+                        const auto location = location_of( row );
+
+                        if ( location < first || location - first + size > _size )
+                            continue;
+
+                        results.push_back( location - first );
+
+                        if ( results.size() >= limit )
+                            return false;
+                    }
+
+                    return true;
+                } );
+
+        std::sort( results.begin(), results.end() );
+        return results;
+    }
+
+    bool image_index::save( const std::filesystem::path& path, const image_fingerprint_t& fingerprint ) const noexcept
+    {
+        try
+        {
+            auto temporary = path;
+            temporary += ".tmp";
+
+            {
+                std::ofstream out( temporary, std::ios::binary | std::ios::trunc );
+
+                if ( !out )
+                    return false;
+
+                write( out, magic );
+                write( out, version );
+                write( out, fingerprint.time_date_stamp );
+                write( out, fingerprint.size_of_image );
+                write( out, fingerprint.checksum );
+                write( out, fingerprint.code_hash );
+                write( out, static_cast< std::uint64_t >( _size ) );
+                write( out, static_cast< std::uint64_t >( _primary ) );
+                write( out, static_cast< std::uint64_t >( sample_rate ) );
+
+                for ( const auto& level : _levels )
+                    write( out, level.blocks );
+
+                write( out, _sampled.blocks );
+                write( out, _samples );
+                write( out, _head );
+                write( out, _tail );
+
+                if ( !out.flush() )
+                    return false;
+            }
+
+            std::error_code ec;
+            std::filesystem::rename( temporary, path, ec );
+
+            return !ec;
+        }
+        catch ( ... )
+        {
+            return false;
+        }
+    }
+
+    std::optional< image_index > image_index::load( const std::filesystem::path& path, const image_fingerprint_t& fingerprint ) noexcept
+    {
+        try
+        {
+            std::ifstream in( path, std::ios::binary );
+
+            if ( !in )
+                return std::nullopt;
+
+            std::uint32_t file_magic, file_version;
+            image_fingerprint_t file_fingerprint;
+            std::uint64_t size, primary, rate;
+
+            if ( !read( in, file_magic ) || !read( in, file_version ) || !read( in, file_fingerprint.time_date_stamp ) ||
+                 !read( in, file_fingerprint.size_of_image ) || !read( in, file_fingerprint.checksum ) || !read( in, file_fingerprint.code_hash ) ||
+                 !read( in, size ) || !read( in, primary ) || !read( in, rate ) )
+                return std::nullopt;
+
+            if ( file_magic != magic || file_version != version || file_fingerprint != fingerprint || rate != sample_rate || primary > size )
+                return std::nullopt;
+
+            // Every size follows from the size of the image, so check it against the file before allocating anything.
+            const auto blocks = ( size + 1 ) / bit_vector_t::block_bits + 1, samples = size / sample_rate + 1, edge = std::min< std::uint64_t >( edge_size, size );
+            const auto expected = sizeof( std::uint32_t ) * 5 + sizeof( std::uint64_t ) * 4 + blocks * sizeof( bit_vector_t::block_t ) * 9 +
+                                  samples * sizeof( std::uint32_t ) + edge * 2;
+
+            std::error_code ec;
+
+            if ( std::filesystem::file_size( path, ec ) != expected || ec )
+                return std::nullopt;
+
+            image_index result;
+            result._size = size;
+            result._primary = primary;
+
+            for ( auto& level : result._levels )
+            {
+                if ( !read( in, level.blocks, blocks ) )
+                    return std::nullopt;
+            }
+
+            if ( !read( in, result._sampled.blocks, blocks ) || !read( in, result._samples, samples ) || !read( in, result._head, edge ) ||
+                 !read( in, result._tail, edge ) )
+                return std::nullopt;
+
+            result.finish();
+
+            // A consistent transform has exactly one sampled row per sample, and the end marker at a sampled row.
+            if ( result._sampled.rank( size + 1 ) != samples || !result._sampled.get( primary ) || result._first[ 256 ] != size + 1 )
+                return std::nullopt;
+
+            return result;
+        }
+        catch ( ... )
+        {
+            return std::nullopt;
+        }
+    }
+}  // namespace wincpp::patterns
@@ -0,0 +1,369 @@
+#include "wincpp/patterns/lanes.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+#include "wincpp/core/cpu.hpp"
+
+#if defined( WINCPP_X86 )
+#include <immintrin.h>
+#endif
+
+namespace wincpp::patterns
+{
+    namespace
+    {
+        /// <summary>
+        /// The number of lanes compared per iteration, which is also the width of their mask.
+        /// </summary>
+        constexpr std::size_t block_lanes = 32;
+
+        /// <summary>
+        /// The index of the empty slots of a lane set.
+        /// </summary>
+        constexpr std::uint32_t empty = std::numeric_limits< std::uint32_t >::max();
+
+        /// <summary>
+        /// Gets whether the lane is in [low, low + span].
+        /// </summary>
+        bool inside( const std::uint8_t* data, std::size_t lane, std::uint64_t low, std::uint64_t span ) noexcept
+        {
+            std::uint64_t value;
+            std::memcpy( &value, data + lane * sizeof( std::uint64_t ), sizeof( value ) );
+            return value - low <= span;
+        }
+
+        /// <summary>
+        /// Calls the callback with the lanes at multiples of the step that are in [low, low + span], from the lane on, until it returns false.
+        /// </summary>
+        template< typename callback_t >
+        bool scan_scalar(
+            const std::uint8_t* data,
+            std::size_t lane,
+            std::size_t count,
+            std::size_t step,
+            std::uint64_t low,
+            std::uint64_t span,
+            callback_t& callback )
+        {
+            for ( lane = ( lane + step - 1 ) / step * step; lane < count; lane += step )
+            {
+                if ( inside( data, lane, low, span ) && !callback( lane ) )
+                    return false;
+            }
+
+            return true;
+        }
+
+        /// <summary>
+        /// Calls the callback with the lanes of a block whose bit is set in the mask, until it returns false.
+        /// </summary>
+        template< typename callback_t >
+        bool emit( std::uint32_t mask, std::size_t lane, callback_t& callback )
+        {
+            for ( ; mask; mask &= mask - 1 )
+            {
+                if ( !callback( lane + std::countr_zero( mask ) ) )
+                    return false;
+            }
+
+            return true;
+        }
+
+#if defined( WINCPP_X86 )
+        // A block of lanes is compared with a vector per 16 to 64 bytes and the results are merged into one mask only if any lane matched,
+        // which is rare. Before AVX-512 there is only a signed 64-bit compare, so both sides of the unsigned one are flipped by the sign bit,
+        // and SSE2 has no 64-bit compare at all, so it only finds a single value, as pairs of equal halves.
+
+        WINCPP_TARGET( "sse2" )
+        std::uint32_t equal_sse2( const std::uint8_t* data, __m128i value ) noexcept
+        {
+            __m128i equal[ block_lanes / 2 ], any = _mm_setzero_si128();
+
+            for ( std::size_t i = 0; i < block_lanes / 2; ++i )
+            {
+                const auto halves = _mm_cmpeq_epi32( _mm_loadu_si128( reinterpret_cast< const __m128i* >( data ) + i ), value );
+                equal[ i ] = _mm_and_si128( halves, _mm_shuffle_epi32( halves, _MM_SHUFFLE( 2, 3, 0, 1 ) ) );
+                any = _mm_or_si128( any, equal[ i ] );
+            }
+
+            if ( _mm_movemask_epi8( any ) == 0 )
+                return 0;
+
+            std::uint32_t mask = 0;
+
+            for ( std::size_t i = 0; i < block_lanes / 2; ++i )
+                mask |= static_cast< std::uint32_t >( _mm_movemask_pd( _mm_castsi128_pd( equal[ i ] ) ) ) << ( i * 2 );
+
+            return mask;
+        }
+
+        template< bool range >
+        WINCPP_TARGET( "avx2" )
+        std::uint32_t inside_avx2( const std::uint8_t* data, __m256i low, __m256i flip, __m256i span ) noexcept
+        {
+            __m256i matched[ block_lanes / 4 ], any = _mm256_setzero_si256();
+
+            for ( std::size_t i = 0; i < block_lanes / 4; ++i )
+            {
+                const auto value = _mm256_loadu_si256( reinterpret_cast< const __m256i* >( data ) + i );
+
+                if constexpr ( range )
+                    matched[ i ] = _mm256_andnot_si256( _mm256_cmpgt_epi64( _mm256_xor_si256( _mm256_sub_epi64( value, low ), flip ), span ), flip );
+                else
+                    matched[ i ] = _mm256_cmpeq_epi64( value, low );
+
+                any = _mm256_or_si256( any, matched[ i ] );
+            }
+
+            if ( _mm256_testz_si256( any, any ) )
+                return 0;
+
+            std::uint32_t mask = 0;
+
+            for ( std::size_t i = 0; i < block_lanes / 4; ++i )
+                mask |= static_cast< std::uint32_t >( _mm256_movemask_pd( _mm256_castsi256_pd( matched[ i ] ) ) ) << ( i * 4 );
+
+            return mask;
+        }
+
+        template< bool range >
+        WINCPP_TARGET( "avx512f" )
+        std::uint32_t inside_avx512( const std::uint8_t* data, __m512i low, __m512i span ) noexcept
+        {
+            std::uint32_t mask = 0;
+
+            for ( std::size_t i = 0; i < block_lanes / 8; ++i )
+            {
+                const auto value = _mm512_loadu_si512( data + i * 64 );
+
+                if constexpr ( range )
+                    mask |= static_cast< std::uint32_t >( _mm512_cmple_epu64_mask( _mm512_sub_epi64( value, low ), span ) ) << ( i * 8 );
+                else
+                    mask |= static_cast< std::uint32_t >( _mm512_cmpeq_epi64_mask( value, low ) ) << ( i * 8 );
+            }
+
+            return mask;
+        }
+
+        template< typename callback_t >
+        WINCPP_TARGET( "sse2" )
+        bool
+        scan_sse2( const std::uint8_t* data, std::size_t& lane, std::size_t count, std::uint32_t stride, std::uint64_t value, callback_t& callback )
+        {
+            const auto vector = _mm_set1_epi64x( static_cast< long long >( value ) );
+
+            for ( ; lane + block_lanes <= count; lane += block_lanes )
+            {
+                if ( !emit( equal_sse2( data + lane * sizeof( std::uint64_t ), vector ) & stride, lane, callback ) )
+                    return false;
+            }
+
+            return true;
+        }
+
+        template< bool range, typename callback_t >
+        WINCPP_TARGET( "avx2" )
+        bool scan_avx2(
+            const std::uint8_t* data,
+            std::size_t& lane,
+            std::size_t count,
+            std::uint32_t stride,
+            std::uint64_t low,
+            std::uint64_t span,
+            callback_t& callback )
+        {
+            const auto sign = std::uint64_t( 1 ) << 63;
+            const auto vector_low = _mm256_set1_epi64x( static_cast< long long >( low ) );
+            const auto flip = _mm256_set1_epi64x( static_cast< long long >( sign ) );
+            const auto vector_span = _mm256_set1_epi64x( static_cast< long long >( span ^ sign ) );
+
+            for ( ; lane + block_lanes <= count; lane += block_lanes )
+            {
+                if ( !emit( inside_avx2< range >( data + lane * sizeof( std::uint64_t ), vector_low, flip, vector_span ) & stride, lane, callback ) )
+                    return false;
+            }
+
+            return true;
+        }
+
+        template< bool range, typename callback_t >
+        WINCPP_TARGET( "avx512f" )
+        bool scan_avx512(
+            const std::uint8_t* data,
+            std::size_t& lane,
+            std::size_t count,
+            std::uint32_t stride,
+            std::uint64_t low,
+            std::uint64_t span,
+            callback_t& callback )
+        {
+            const auto vector_low = _mm512_set1_epi64( static_cast< long long >( low ) );
+            const auto vector_span = _mm512_set1_epi64( static_cast< long long >( span ) );
+
+            for ( ; lane + block_lanes <= count; lane += block_lanes )
+            {
+                if ( !emit( inside_avx512< range >( data + lane * sizeof( std::uint64_t ), vector_low, vector_span ) & stride, lane, callback ) )
+                    return false;
+            }
+
+            return true;
+        }
+#endif
+
+        /// <summary>
+        /// Finds the lanes in [low, high] that the predicate accepts.
+        /// </summary>
+        template< typename accept_t >
+        std::vector< std::uintptr_t > scan(
+            std::span< const std::uint8_t > buffer,
+            std::uint64_t low,
+            std::uint64_t high,
+            std::size_t stride,
+            std::size_t limit,
+            accept_t&& accept ) noexcept
+        {
+            std::vector< std::uintptr_t > results;
+
+            if ( !limit )
+                return results;
+
+            const auto step = std::bit_ceil( std::max( stride, sizeof( std::uint64_t ) ) ) / sizeof( std::uint64_t );
+            const auto count = buffer.size() / sizeof( std::uint64_t );
+            const auto span = high - low;
+
+            const auto callback = [ & ]( std::size_t lane )
+            {
+                std::uint64_t value;
+                std::memcpy( &value, buffer.data() + lane * sizeof( std::uint64_t ), sizeof( value ) );
+
+                if ( accept( value ) )
+                    results.push_back( lane * sizeof( std::uint64_t ) );
+
+                return results.size() < limit;
+            };
+
+            std::size_t lane = 0;
+
+#if defined( WINCPP_X86 )
+            // Strides beyond a block touch a lane per cache line at most, which the scalar loop does as well.
+            if ( step <= block_lanes )
+            {
+                std::uint32_t mask = 0;
+
+                for ( std::size_t bit = 0; bit < block_lanes; bit += step )
+                    mask |= std::uint32_t( 1 ) << bit;
+
+                bool done = true;
+
+                switch ( core::simd_level() )
+                {
+                    case core::simd_level_t::avx512_t:
+                        done = span ? scan_avx512< true >( buffer.data(), lane, count, mask, low, span, callback )
+                                    : scan_avx512< false >( buffer.data(), lane, count, mask, low, span, callback );
+                        break;
+                    case core::simd_level_t::avx2_t:
+                        done = span ? scan_avx2< true >( buffer.data(), lane, count, mask, low, span, callback )
+                                    : scan_avx2< false >( buffer.data(), lane, count, mask, low, span, callback );
+                        break;
+                    case core::simd_level_t::sse2_t:
+                        if ( !span )
+                            done = scan_sse2( buffer.data(), lane, count, mask, low, callback );
+                        break;
+                    default: break;
+                }
+
+                if ( !done )
+                    return results;
+            }
+#endif
+
+            scan_scalar( buffer.data(), lane, count, step, low, span, callback );
+            return results;
+        }
+    }  // namespace
+
+    lane_set::lane_set( std::span< const std::uint64_t > values )
+    {
+        // A table at most a quarter full keeps the runs of occupied slots short.
+        _bits = std::bit_width( std::max< std::size_t >( values.size(), 1 ) * 4 - 1 );
+        _slots.assign( std::size_t( 1 ) << _bits, { 0, empty } );
+
+        const auto mask = _slots.size() - 1;
+
+        for ( std::size_t i = 0; i < values.size(); ++i )
+        {
+            auto slot = home( values[ i ] );
+
+            while ( _slots[ slot ].index != empty && _slots[ slot ].value != values[ i ] )
+                slot = ( slot + 1 ) & mask;
+
+            if ( _slots[ slot ].index != empty )
+                continue;
+
+            _slots[ slot ] = { values[ i ], static_cast< std::uint32_t >( i ) };
+            ++_size;
+        }
+
+        if ( !values.empty() )
+        {
+            const auto [ low, high ] = std::ranges::minmax( values );
+            _low = low;
+            _high = high;
+        }
+    }
+
+    std::size_t lane_set::size() const noexcept
+    {
+        return _size;
+    }
+
+    std::uint64_t lane_set::low() const noexcept
+    {
+        return _low;
+    }
+
+    std::uint64_t lane_set::high() const noexcept
+    {
+        return _high;
+    }
+
+    std::optional< std::size_t > lane_set::find( std::uint64_t value ) const noexcept
+    {
+        const auto mask = _slots.size() - 1;
+
+        for ( auto slot = home( value ); _slots[ slot ].index != empty; slot = ( slot + 1 ) & mask )
+        {
+            if ( _slots[ slot ].value == value )
+                return _slots[ slot ].index;
+        }
+
+        return std::nullopt;
+    }
+
+    std::size_t lane_set::home( std::uint64_t value ) const noexcept
+    {
+        // Fibonacci hashing: the high bits of the product depend on every bit of the value, so aligned values still spread evenly.
+        return static_cast< std::size_t >( ( value * 0x9E3779B97F4A7C15 ) >> ( 64 - _bits ) );
+    }
+
+    std::vector< std::uintptr_t >
+    find_lanes( std::span< const std::uint8_t > buffer, std::uint64_t value, std::size_t stride, std::size_t limit ) noexcept
+    {
+        return scan( buffer, value, value, stride, limit, []( std::uint64_t ) { return true; } );
+    }
+
+    std::vector< std::uintptr_t >
+    find_lanes( std::span< const std::uint8_t > buffer, const lane_set& set, std::size_t stride, std::size_t limit ) noexcept
+    {
+        if ( !set.size() )
+            return {};
+
+        // A single value needs no lookup, since the bounds already match it exactly.
+        if ( set.size() == 1 )
+            return find_lanes( buffer, set.low(), stride, limit );
+
+        return scan( buffer, set.low(), set.high(), stride, limit, [ & ]( std::uint64_t value ) { return set.find( value ).has_value(); } );
+    }
+}  // namespace wincpp::patterns
@@ -0,0 +1,482 @@
+#include "wincpp/patterns/page_store.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstring>
+
+#include "wincpp/core/error.hpp"
+
+namespace wincpp::patterns
+{
+    namespace
+    {
+        /// <summary>
+        /// How a page is encoded, in the first byte of its compressed form.
+        /// </summary>
+        enum class encoding_t : std::uint8_t
+        {
+            zero_t,
+            raw_t,
+            lz_t
+        };
+
+        // A match is at least four bytes, and the last five bytes of a page are always literals, so copies never read past the end.
+        constexpr std::size_t min_match = 4, last_literals = 5, hash_bits = 12;
+
+        std::uint32_t read32( const std::uint8_t* data ) noexcept
+        {
+            std::uint32_t value;
+            std::memcpy( &value, data, sizeof( value ) );
+            return value;
+        }
+
+        std::uint32_t hash( std::uint32_t value ) noexcept
+        {
+            return ( value * 2654435761u ) >> ( 32 - hash_bits );
+        }
+
+        bool zero( std::span< const std::uint8_t > page ) noexcept
+        {
+            std::size_t i = 0;
+
+            for ( ; i + 8 <= page.size(); i += 8 )
+            {
+                std::uint64_t word;
+                std::memcpy( &word, page.data() + i, sizeof( word ) );
+
+                if ( word )
+                    return false;
+            }
+
+            for ( ; i < page.size(); ++i )
+            {
+                if ( page[ i ] )
+                    return false;
+            }
+
+            return true;
+        }
+
+        /// <summary>
+        /// Copies 16 bytes at a time, up to 15 bytes past the end, which is cheaper than calling `memcpy` for every short run of literals.
+        /// Both buffers must have room for the overrun.
+        /// </summary>
+        void wild_copy( std::uint8_t* to, const std::uint8_t* from, std::size_t count ) noexcept
+        {
+            const auto end = to + count;
+
+            do
+            {
+                std::memcpy( to, from, 16 );
+                to += 16, from += 16;
+            } while ( to < end );
+        }
+
+        /// <summary>
+        /// Copies a match 8 bytes at a time, up to 7 bytes past its end. The source must be at least 8 bytes behind.
+        /// </summary>
+        void copy_words( std::uint8_t* to, const std::uint8_t* from, std::size_t count ) noexcept
+        {
+            for ( const auto end = to + count; to < end; to += 8, from += 8 )
+                std::memcpy( to, from, 8 );
+        }
+
+        /// <summary>
+        /// Writes a length that didn't fit in its four bits of the token as a run of 255s and a remainder.
+        /// </summary>
+        std::uint8_t* write_length( std::uint8_t* out, std::size_t length ) noexcept
+        {
+            for ( ; length >= 255; length -= 255 )
+                *out++ = 255;
+
+            *out++ = static_cast< std::uint8_t >( length );
+            return out;
+        }
+
+        /// <summary>
+        /// Writes a sequence of literals followed by a match, or only literals if the match is empty. The literals may be read 16 bytes past
+        /// their end if `readable` says the page goes on that far.
+        /// </summary>
+        std::uint8_t* write_sequence(
+            std::uint8_t* out,
+            const std::uint8_t* literals,
+            std::size_t count,
+            std::size_t readable,
+            std::size_t offset,
+            std::size_t length ) noexcept
+        {
+            const auto extra = length ? length - min_match : 0;
+            auto& token = *out++;
+
+            token = static_cast< std::uint8_t >( std::min< std::size_t >( count, 15 ) << 4 | std::min< std::size_t >( extra, 15 ) );
+
+            if ( count >= 15 )
+                out = write_length( out, count - 15 );
+
+            if ( count + 16 <= readable )
+                wild_copy( out, literals, count );
+            else
+                std::memcpy( out, literals, count );
+
+            out += count;
+
+            if ( !length )
+                return out;
+
+            *out++ = static_cast< std::uint8_t >( offset );
+            *out++ = static_cast< std::uint8_t >( offset >> 8 );
+
+            if ( extra >= 15 )
+                out = write_length( out, extra - 15 );
+
+            return out;
+        }
+
+        /// <summary>
+        /// Compresses the page into the buffer, which must have room for the page and one more byte.
+        /// </summary>
+        /// <returns>The size of the compressed page.</returns>
+        std::size_t compress( std::span< const std::uint8_t > page, std::uint8_t* out ) noexcept
+        {
+            if ( zero( page ) )
+            {
+                out[ 0 ] = static_cast< std::uint8_t >( encoding_t::zero_t );
+                return 1;
+            }
+
+            const auto raw = [ & ]
+            {
+                out[ 0 ] = static_cast< std::uint8_t >( encoding_t::raw_t );
+                std::memcpy( out + 1, page.data(), page.size() );
+                return page.size() + 1;
+            };
+
+            const auto size = page.size();
+
+            if ( size < min_match + last_literals + 8 )
+                return raw();
+
+            // The worst case of the codec is a little over the page, so it writes to scratch space and gives up once it passes the page.
+            std::array< std::uint8_t, page_store::max_page_size + page_store::max_page_size / 128 + 64 > scratch;
+            std::array< std::uint16_t, 1 << hash_bits > table{};
+
+            const auto data = page.data();
+            auto output = scratch.data() + 1;
+
+            std::size_t position = 1, anchor = 0;
+            const auto limit = size - last_literals - min_match, stop = size - last_literals;
+
+            // Positions are kept one based so that zero means an empty entry.
+            table[ hash( read32( data ) ) ] = 1;
+
+            while ( position < limit )
+            {
+                const auto value = read32( data + position );
+                auto& entry = table[ hash( value ) ];
+                const std::size_t candidate = entry;
+
+                entry = static_cast< std::uint16_t >( position + 1 );
+
+                if ( !candidate || read32( data + candidate - 1 ) != value )
+                {
+                    // Skip ahead faster the longer nothing matches, so incompressible pages cost little.
+                    position += 1 + ( ( position - anchor ) >> 6 );
+                    continue;
+                }
+
+                const auto match = candidate - 1;
+                auto length = min_match;
+
+                // Extend the match a word at a time, and find the first differing byte of the last word from its lowest set bit.
+                for ( ; position + length + 8 <= stop; length += 8 )
+                {
+                    std::uint64_t a, b;
+                    std::memcpy( &a, data + match + length, sizeof( a ) );
+                    std::memcpy( &b, data + position + length, sizeof( b ) );
+
+                    if ( a != b )
+                    {
+                        length += std::countr_zero( a ^ b ) / 8;
+                        break;
+                    }
+                }
+
+                while ( position + length < stop && data[ match + length ] == data[ position + length ] )
+                    ++length;
+
+                output = write_sequence( output, data + anchor, position - anchor, size - anchor, position - match, length );
+                position += length;
+                anchor = position;
+
+                if ( static_cast< std::size_t >( output - scratch.data() ) > size )
+                    return raw();
+
+                // Remember a position near the end of the match, where the next one is likely to start over.
+                if ( position < limit )
+                    table[ hash( read32( data + position - 2 ) ) ] = static_cast< std::uint16_t >( position - 1 );
+            }
+
+            output = write_sequence( output, data + anchor, size - anchor, size - anchor, 0, 0 );
+
+            const auto compressed = static_cast< std::size_t >( output - scratch.data() );
+
+            if ( compressed > size )
+                return raw();
+
+            scratch[ 0 ] = static_cast< std::uint8_t >( encoding_t::lz_t );
+            std::memcpy( out, scratch.data(), compressed );
+            return compressed;
+        }
+
+        /// <summary>
+        /// Reads a length that continues past its four bits of the token.
+        /// </summary>
+        bool read_length( const std::uint8_t*& in, const std::uint8_t* end, std::size_t& length ) noexcept
+        {
+            for ( ;; )
+            {
+                if ( in == end )
+                    return false;
+
+                const auto byte = *in++;
+                length += byte;
+
+                if ( byte != 255 )
+                    return true;
+            }
+        }
+
+        /// <summary>
+        /// Decompresses a page, checking every length and offset so that a corrupt file can't write out of bounds.
+        /// </summary>
+        /// <returns>True if the page decompressed to exactly the size of the buffer.</returns>
+        bool decompress( std::span< const std::uint8_t > compressed, std::span< std::uint8_t > page ) noexcept
+        {
+            if ( compressed.empty() || page.size() > page_store::max_page_size )
+                return false;
+
+            auto in = compressed.data() + 1;
+            const auto end = compressed.data() + compressed.size();
+
+            switch ( static_cast< encoding_t >( compressed[ 0 ] ) )
+            {
+                case encoding_t::zero_t: std::memset( page.data(), 0, page.size() ); return compressed.size() == 1;
+                case encoding_t::raw_t:
+                    if ( compressed.size() != page.size() + 1 )
+                        return false;
+
+                    std::memcpy( page.data(), in, page.size() );
+                    return true;
+                case encoding_t::lz_t: break;
+                default: return false;
+            }
+
+            // Decompress into scratch space with room for the overrun of the copies, and copy the page out at the end.
+            std::array< std::uint8_t, page_store::max_page_size + 32 > scratch;
+
+            const auto out = scratch.data();
+            std::size_t position = 0;
+
+            while ( in < end )
+            {
+                const auto token = *in++;
+                std::size_t count = token >> 4;
+
+                if ( count == 15 && !read_length( in, end, count ) )
+                    return false;
+
+                if ( count > static_cast< std::size_t >( end - in ) || count > page.size() - position )
+                    return false;
+
+                if ( count + 16 <= static_cast< std::size_t >( end - in ) )
+                    wild_copy( out + position, in, count );
+                else
+                    std::memcpy( out + position, in, count );
+
+                in += count;
+                position += count;
+
+                // The last sequence has no match.
+                if ( in == end )
+                    break;
+
+                if ( end - in < 2 )
+                    return false;
+
+                const std::size_t offset = in[ 0 ] | in[ 1 ] << 8;
+                in += 2;
+
+                std::size_t length = token & 15;
+
+                if ( length == 15 && !read_length( in, end, length ) )
+                    return false;
+
+                length += min_match;
+
+                if ( !offset || offset > position || length > page.size() - position )
+                    return false;
+
+                const auto to = out + position;
+
+                // A match closer than a word reads what it writes, e.g. a run of one byte. Its first word is copied a byte at a time, and the
+                // rest from a whole number of periods back, which is at least a word away.
+                auto from = to - offset;
+
+                if ( offset < 8 )
+                {
+                    for ( std::size_t i = 0; i < 8; ++i )
+                        to[ i ] = from[ i ];
+
+                    from = to + 8 - ( 8 + offset - 1 ) / offset * offset;
+                    copy_words( to + 8, from, length > 8 ? length - 8 : 0 );
+                }
+                else
+                    copy_words( to, from, length );
+
+                position += length;
+            }
+
+            if ( position != page.size() )
+                return false;
+
+            std::memcpy( page.data(), out, position );
+            return true;
+        }
+    }  // namespace
+
+    page_store::page_store( const std::filesystem::path& path ) : _path( path )
+    {
+        _file.open( path, std::ios::binary | std::ios::in | std::ios::out | std::ios::trunc );
+
+        if ( !_file )
+            throw core::error::from_user( core::user_error_type_t::snapshot_file_t, "The snapshot file {} couldn't be created", path.string() );
+    }
+
+    page_store::~page_store()
+    {
+        if ( _path.empty() )
+            return;
+
+        _file.close();
+
+        std::error_code error;
+        std::filesystem::remove( _path, error );
+    }
+
+    void page_store::resize( std::size_t slots )
+    {
+        if ( _path.empty() )
+            _pages.resize( slots );
+        else
+            _extents.resize( slots );
+    }
+
+    bool page_store::store( std::size_t slot, std::span< const std::uint8_t > page ) noexcept
+    {
+        if ( page.size() > max_page_size )
+            return false;
+
+        std::array< std::uint8_t, max_page_size + 1 > buffer;
+        const auto size = compress( page, buffer.data() );
+
+        if ( _path.empty() )
+        {
+            try
+            {
+                _pages[ slot ].assign( buffer.data(), buffer.data() + size );
+            }
+            catch ( ... )
+            {
+                return false;
+            }
+
+            return true;
+        }
+
+        std::lock_guard lock( _mutex );
+        auto& extent = _extents[ slot ];
+
+        // A page that doesn't fit in the room of the slot moves to the end of the file.
+        if ( size > extent.capacity )
+            extent = { _end, 0, static_cast< std::uint32_t >( size ) }, _end += size;
+
+        _file.seekp( static_cast< std::streamoff >( extent.offset ) );
+        _file.write( reinterpret_cast< const char* >( buffer.data() ), static_cast< std::streamsize >( size ) );
+
+        if ( !_file )
+        {
+            _file.clear();
+            extent.size = 0;
+            return false;
+        }
+
+        extent.size = static_cast< std::uint32_t >( size );
+        return true;
+    }
+
+    bool page_store::load( std::size_t slot, std::span< std::uint8_t > page ) const noexcept
+    {
+        if ( _path.empty() )
+            return decompress( _pages[ slot ], page );
+
+        std::array< std::uint8_t, max_page_size + 1 > buffer;
+        std::size_t size;
+
+        {
+            std::lock_guard lock( _mutex );
+            const auto& extent = _extents[ slot ];
+
+            size = extent.size;
+
+            if ( !size || size > buffer.size() )
+                return false;
+
+            _file.seekg( static_cast< std::streamoff >( extent.offset ) );
+            _file.read( reinterpret_cast< char* >( buffer.data() ), static_cast< std::streamsize >( size ) );
+
+            if ( !_file )
+            {
+                _file.clear();
+                return false;
+            }
+        }
+
+        return decompress( { buffer.data(), size }, page );
+    }
+
+    void page_store::erase( std::size_t slot ) noexcept
+    {
+        if ( _path.empty() )
+        {
+            _pages[ slot ] = {};
+            return;
+        }
+
+        std::lock_guard lock( _mutex );
+        _extents[ slot ].size = 0;
+    }
+
+    std::size_t page_store::memory_usage() const noexcept
+    {
+        auto usage = sizeof( *this ) + _pages.capacity() * sizeof( std::vector< std::uint8_t > ) + _extents.capacity() * sizeof( extent_t );
+
+        for ( const auto& page : _pages )
+            usage += page.capacity();
+
+        return usage;
+    }
+
+    std::size_t page_store::compressed_size() const noexcept
+    {
+        std::size_t size = 0;
+
+        for ( const auto& page : _pages )
+            size += page.size();
+
+        for ( const auto& extent : _extents )
+            size += extent.size;
+
+        return size;
+    }
+}  // namespace wincpp::patterns
@@ -1,37 +1,91 @@
 #include "wincpp/patterns/pattern.hpp"
 
+#include <iomanip>
 #include <sstream>
 #include <string_view>
 #include <vector>
 
+#include "wincpp/core/error.hpp"
+
 namespace wincpp::patterns
 {
-    pattern_t::pattern_t( const char* const aob, const std::string_view smask ) noexcept : size( smask.size() )
+    pattern_t::pattern_t( const char* const aob, const std::string_view smask )
     {
-        bytes = std::shared_ptr< std::uint8_t[] >( new std::uint8_t[ size ] );
-        mask = std::shared_ptr< bool[] >( new bool[ size ] );
+        assign( reinterpret_cast< const std::uint8_t* >( aob ), smask.size() );
 
         for ( std::size_t i = 0; i < size; ++i )
         {
-            bytes[ i ] = aob[ i ];
-            mask[ i ] = smask[ i ] == 'x';
+            if ( smask[ i ] != 'x' )
+                atoms[ i ] = atom_t{};
         }
     }
 
+    pattern_t pattern_t::parse( std::string_view text )
+    {
+        pattern_t result;
+
+        if ( !parse( text, result ) )
+            throw core::error::from_user( core::user_error_type_t::invalid_pattern_t, "Failed to parse pattern \"{}\"", text );
+
+        return result;
+    }
+
+    void pattern_t::assign( const std::uint8_t* data, std::size_t size )
+    {
+        if ( size > max_size )
+            throw core::error::from_user(
+                core::user_error_type_t::pattern_too_large_t, "Failed to create a pattern of {} bytes (the maximum is {})", size, max_size );
+
+        for ( std::size_t i = 0; i < size; ++i )
+            atoms[ i ] = atom_t{ data[ i ], 0xFF };
+
+        this->size = size;
+    }
+
     std::string pattern_t::to_string() const noexcept
     {
         std::stringstream ss;
 
+        ss << std::uppercase << std::hex << std::setfill( '0' );
+
         for ( std::size_t i = 0; i < size; ++i )
         {
-            if ( mask[ i ] )
+            const auto set = class_of( i );
+
+            const auto [ value, mask ] = atoms[ i ];
+
+            if ( mask == 0xFF && !set )
             {
-                ss << std::hex << static_cast< int >( bytes[ i ] );
+                ss << std::setw( 2 ) << static_cast< int >( value );
             }
-            else
+            else if ( mask == 0x00 && !set )
             {
                 ss << "?";
             }
+            else if ( mask == 0xF0 && !set )
+            {
+                ss << static_cast< int >( value >> 4 ) << "?";
+            }
+            else if ( mask == 0x0F && !set )
+            {
+                ss << "?" << static_cast< int >( value & 0x0F );
+            }
+            else
+            {
+                // Anything else is written out as the list of accepted bytes.
+                const char* separator = "[";
+
+                for ( std::size_t byte = 0; byte < 256; ++byte )
+                {
+                    if ( accepts( i, static_cast< std::uint8_t >( byte ) ) )
+                    {
+                        ss << separator << std::setw( 2 ) << byte;
+                        separator = "|";
+                    }
+                }
+
+                ss << "]";
+            }
 
             if ( i + 1 < size )
             {
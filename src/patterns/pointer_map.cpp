@@ -0,0 +1,566 @@
+#include "wincpp/patterns/pointer_map.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstring>
+#include <execution>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <numeric>
+#include <system_error>
+#include <unordered_map>
+
+#include "wincpp/core/error.hpp"
+#include "wincpp/patterns/values.hpp"
+
+namespace wincpp::patterns
+{
+    namespace
+    {
+        // The first bytes of every map file, followed by the format version.
+        constexpr std::uint32_t magic = 0x4D504357;  // "WCPM"
+        constexpr std::uint32_t version = 1;
+
+        /// <summary>
+        /// The size of the pieces that the ranges are split into, at multiples of it, so a large range is spread across threads.
+        /// </summary>
+        constexpr std::size_t chunk_size = 1 << 20;
+
+        /// <summary>
+        /// The granularity at which a chunk that can't be read as a whole is read instead.
+        /// </summary>
+        constexpr std::size_t page_size = 4096;
+
+        /// <summary>
+        /// The number of high bits of the targets that the pointers are bucketed by before they are sorted.
+        /// </summary>
+        constexpr std::size_t bucket_bits = 16;
+
+        constexpr std::size_t pointer_size = sizeof( std::uintptr_t );
+
+        template< typename T >
+        void write( std::ofstream& out, const T& value )
+        {
+            out.write( reinterpret_cast< const char* >( &value ), sizeof( T ) );
+        }
+
+        template< typename T >
+        void write( std::ofstream& out, const std::vector< T >& values )
+        {
+            out.write( reinterpret_cast< const char* >( values.data() ), static_cast< std::streamsize >( values.size() * sizeof( T ) ) );
+        }
+
+        template< typename T >
+        bool read( std::ifstream& in, T& value )
+        {
+            return static_cast< bool >( in.read( reinterpret_cast< char* >( &value ), sizeof( T ) ) );
+        }
+
+        template< typename T >
+        bool read( std::ifstream& in, std::vector< T >& values, std::size_t count )
+        {
+            values.resize( count );
+            return static_cast< bool >( in.read( reinterpret_cast< char* >( values.data() ), static_cast< std::streamsize >( count * sizeof( T ) ) ) );
+        }
+    }  // namespace
+
+    pointer_map::pointer_map( const reader_t& reader, std::span< const range_t > ranges, std::vector< pointer_image_t > images, bool parallelize )
+        : _images( std::move( images ) )
+    {
+        std::ranges::sort( _images, {}, &pointer_image_t::address );
+
+        std::vector< range_t > targets;
+
+        for ( const auto& range : ranges )
+        {
+            if ( range.size )
+                targets.push_back( range );
+        }
+
+        if ( targets.empty() )
+            return;
+
+        std::vector< range_t > chunks;
+
+        for ( const auto& range : targets )
+        {
+            for ( auto address = range.address, end = range.address + range.size; address < end; )
+            {
+                const auto next = std::min( ( address / chunk_size + 1 ) * chunk_size, end );
+                chunks.push_back( { address, next - address } );
+                address = next;
+            }
+        }
+
+        // Most values are small integers, floats or zero, and fall outside the span of the ranges. The kernels drop those a vector at a time,
+        // and only the rest are looked up in the ranges.
+        const value_query_t query(
+            pointer_size == 8 ? value_type_t::u64_t : value_type_t::u32_t,
+            targets.front().address,
+            targets.back().address + targets.back().size - 1,
+            pointer_size );
+
+        const auto contains = [ & ]( std::uintptr_t value )
+        {
+            const auto it = std::ranges::upper_bound( targets, value, {}, &range_t::address );
+            return it != targets.begin() && value - std::prev( it )->address < std::prev( it )->size;
+        };
+
+        const auto collect = [ & ]( std::uintptr_t address, const std::uint8_t* bytes, std::size_t size, std::vector< entry_t >& found )
+        {
+            const auto skip = ( pointer_size - address % pointer_size ) % pointer_size;
+
+            if ( size < skip + pointer_size )
+                return;
+
+            const auto count = ( size - skip ) / pointer_size;
+            std::vector< std::uint64_t > candidates( ( count + 63 ) / 64, ~std::uint64_t( 0 ) );
+
+            filter_values( { bytes + skip, count * pointer_size }, query, candidates );
+
+            for ( std::size_t word = 0; word < candidates.size(); ++word )
+            {
+                for ( auto bits = candidates[ word ]; bits; bits &= bits - 1 )
+                {
+                    const auto offset = skip + ( word * 64 + std::countr_zero( bits ) ) * pointer_size;
+
+                    std::uintptr_t value;
+                    std::memcpy( &value, bytes + offset, pointer_size );
+
+                    if ( contains( value ) )
+                        found.push_back( { value, address + offset } );
+                }
+            }
+        };
+
+        std::vector< std::vector< entry_t > > found( chunks.size() );
+
+        const auto lambda = [ & ]( const range_t& chunk )
+        {
+            auto& out = found[ &chunk - chunks.data() ];
+            std::vector< std::uint8_t > buffer( chunk.size );
+
+            if ( reader( chunk.address, chunk.size, buffer.data() ) )
+                return collect( chunk.address, buffer.data(), chunk.size, out );
+
+            // Part of the chunk can't be read, so read it a page at a time and skip the pages that fail.
+            for ( auto address = chunk.address, end = chunk.address + chunk.size; address < end; )
+            {
+                const auto next = std::min( ( address / page_size + 1 ) * page_size, end );
+
+                if ( reader( address, next - address, buffer.data() ) )
+                    collect( address, buffer.data(), next - address, out );
+
+                address = next;
+            }
+        };
+
+        if ( parallelize )
+            std::for_each( std::execution::par, chunks.begin(), chunks.end(), lambda );
+        else
+            std::for_each( chunks.begin(), chunks.end(), lambda );
+
+        // The chunks are scattered into buckets by the high bits of their targets, which is also what joins them, and then each bucket is
+        // sorted on its own. The buckets fit in cache where one sort of the whole map wouldn't, and take no more memory than the join.
+        std::size_t total = 0;
+        auto low = std::numeric_limits< std::uintptr_t >::max(), high = std::uintptr_t( 0 );
+
+        for ( const auto& entries : found )
+        {
+            total += entries.size();
+
+            for ( const auto& entry : entries )
+                low = std::min( low, entry.target ), high = std::max( high, entry.target );
+        }
+
+        if ( !total )
+            return;
+
+        const auto shift = std::max( static_cast< std::size_t >( std::bit_width( high - low ) ), bucket_bits ) - bucket_bits;
+        std::vector< std::size_t > starts( ( std::size_t( 1 ) << bucket_bits ) + 1 );
+
+        for ( const auto& entries : found )
+        {
+            for ( const auto& entry : entries )
+                ++starts[ ( ( entry.target - low ) >> shift ) + 1 ];
+        }
+
+        std::partial_sum( starts.begin(), starts.end(), starts.begin() );
+
+        _entries.resize( total );
+
+        auto next = starts;
+
+        for ( auto& entries : found )
+        {
+            for ( const auto& entry : entries )
+                _entries[ next[ ( entry.target - low ) >> shift ]++ ] = entry;
+
+            std::vector< entry_t >().swap( entries );
+        }
+
+        const auto sort = [ & ]( const std::size_t& start )
+        {
+            const auto bucket = &start - starts.data();
+            std::sort( _entries.begin() + start, _entries.begin() + starts[ bucket + 1 ] );
+        };
+
+        if ( parallelize )
+            std::for_each( std::execution::par, starts.begin(), starts.end() - 1, sort );
+        else
+            std::for_each( starts.begin(), starts.end() - 1, sort );
+    }
+
+    std::size_t pointer_map::size() const noexcept
+    {
+        return _entries.size();
+    }
+
+    std::size_t pointer_map::memory_usage() const noexcept
+    {
+        auto usage = _entries.capacity() * sizeof( entry_t ) + _images.capacity() * sizeof( pointer_image_t );
+
+        for ( const auto& image : _images )
+            usage += image.name.capacity();
+
+        return usage;
+    }
+
+    std::span< const pointer_image_t > pointer_map::images() const noexcept
+    {
+        return _images;
+    }
+
+    std::vector< pointer_path_t > pointer_map::find_paths( std::uintptr_t target, const pointer_scan_options_t& options, bool parallelize ) const
+    {
+        if ( options.max_depth == 0 || options.max_depth > pointer_path_t::max_depth )
+            throw core::error::from_user(
+                core::user_error_type_t::invalid_pointer_scan_t, "The depth {} isn't between 1 and {}", options.max_depth, pointer_path_t::max_depth );
+
+        if ( options.max_offset > std::numeric_limits< std::uint32_t >::max() )
+            throw core::error::from_user( core::user_error_type_t::invalid_pointer_scan_t, "The offset {} doesn't fit in 32 bits", options.max_offset );
+
+        const auto max_offset = options.max_offset;
+
+        struct start_t
+        {
+            std::size_t level;
+            entry_t entry;
+        };
+
+        // The pointers of each level that aren't static, in ascending order of source, and the static ones that start a path. The pointers of
+        // the last level can't lead anywhere, so only the static ones are kept.
+        std::vector< std::vector< entry_t > > levels( options.max_depth );
+        std::vector< start_t > starts;
+        std::vector< std::uintptr_t > frontier{ target };
+
+        for ( std::size_t level = 0; level < options.max_depth && !frontier.empty(); ++level )
+        {
+            auto& next = levels[ level ];
+
+            // The frontier is sorted, so the ranges that point below its addresses are merged as they come, and every pointer is met once.
+            for ( std::size_t i = 0; i < frontier.size(); )
+            {
+                const auto low = frontier[ i ] - std::min( frontier[ i ], max_offset );
+                auto high = frontier[ i++ ];
+
+                while ( i < frontier.size() && frontier[ i ] - std::min( frontier[ i ], max_offset ) <= high )
+                    high = frontier[ i++ ];
+
+                for ( const auto& entry : pointing_into( low, high ) )
+                {
+                    if ( image_of( entry.source ) )
+                        starts.push_back( { level, entry } );
+                    else if ( level + 1 < options.max_depth )
+                        next.push_back( entry );
+                }
+            }
+
+            if ( parallelize )
+                std::sort( std::execution::par, next.begin(), next.end(), []( const entry_t& a, const entry_t& b ) { return a.source < b.source; } );
+            else
+                std::ranges::sort( next, {}, &entry_t::source );
+
+            frontier.resize( next.size() );
+            std::ranges::transform( next, frontier.begin(), &entry_t::source );
+        }
+
+        // Every pointer of a level points below one of the level before, so walking forward from a start always reaches the target.
+        std::atomic< std::size_t > count = 0;
+        std::vector< std::vector< pointer_path_t > > found( starts.size() );
+
+        const auto lambda = [ & ]( const start_t& start )
+        {
+            auto& out = found[ &start - starts.data() ];
+
+            if ( count.load( std::memory_order_relaxed ) >= options.limit )
+                return;
+
+            const auto image = *image_of( start.entry.source );
+
+            pointer_path_t path{ image, static_cast< std::uint32_t >( start.level + 1 ), start.entry.source - _images[ image ].address, {} };
+
+            // Each level fills in one offset and hands the pointers it reaches to the level after it.
+            struct walker_t
+            {
+                const std::vector< std::vector< entry_t > >& levels;
+                const pointer_scan_options_t& options;
+                std::uintptr_t target;
+                std::atomic< std::size_t >& count;
+                std::vector< pointer_path_t >& out;
+                pointer_path_t& path;
+
+                void operator()( std::size_t level, std::uintptr_t value, std::size_t position ) const
+                {
+                    if ( count.load( std::memory_order_relaxed ) >= options.limit )
+                        return;
+
+                    if ( level == 0 )
+                    {
+                        path.offsets[ position ] = static_cast< std::uint32_t >( target - value );
+                        out.push_back( path );
+                        count.fetch_add( 1, std::memory_order_relaxed );
+                        return;
+                    }
+
+                    const auto& nodes = levels[ level - 1 ];
+
+                    for ( auto it = std::ranges::lower_bound( nodes, value, {}, &entry_t::source );
+                          it != nodes.end() && it->source - value <= options.max_offset;
+                          ++it )
+                    {
+                        path.offsets[ position ] = static_cast< std::uint32_t >( it->source - value );
+                        ( *this )( level - 1, it->target, position + 1 );
+                    }
+                }
+            };
+
+            const walker_t walk{ levels, options, target, count, out, path };
+            walk( start.level, start.entry.target, 0 );
+        };
+
+        if ( parallelize )
+            std::for_each( std::execution::par, starts.begin(), starts.end(), lambda );
+        else
+            std::for_each( starts.begin(), starts.end(), lambda );
+
+        std::vector< pointer_path_t > paths;
+
+        for ( auto& out : found )
+            paths.insert( paths.end(), out.begin(), out.end() );
+
+        std::ranges::sort(
+            paths,
+            []( const pointer_path_t& a, const pointer_path_t& b )
+            {
+                return std::tie( a.depth, a.image, a.offset, a.offsets ) < std::tie( b.depth, b.image, b.offset, b.offsets );
+            } );
+
+        if ( paths.size() > options.limit )
+            paths.resize( options.limit );
+
+        return paths;
+    }
+
+    std::vector< pointer_path_t > pointer_map::intersect(
+        std::span< const pointer_path_t > paths,
+        std::span< const pointer_image_t > images,
+        std::uintptr_t target,
+        bool parallelize ) const
+    {
+        std::unordered_map< std::string_view, std::uint32_t > names;
+
+        for ( std::uint32_t i = 0; i < _images.size(); ++i )
+            names.try_emplace( _images[ i ].name, i );
+
+        const auto leads = [ & ]( const pointer_path_t& path ) -> bool
+        {
+            if ( path.image >= images.size() || path.depth == 0 || path.depth > pointer_path_t::max_depth )
+                return false;
+
+            const auto it = names.find( images[ path.image ].name );
+
+            if ( it == names.end() || path.offset >= _images[ it->second ].size )
+                return false;
+
+            const auto start = _images[ it->second ].address + path.offset;
+
+            // Walk back from the target: each step keeps the sources of the pointers that point exactly where the offset says. The last step
+            // only has to find the pointer at the start.
+            std::vector< std::uintptr_t > addresses{ target }, sources;
+
+            for ( auto i = path.depth - 1; i > 0; --i )
+            {
+                sources.clear();
+
+                for ( const auto address : addresses )
+                {
+                    if ( address < path.offsets[ i ] )
+                        continue;
+
+                    for ( const auto& entry : pointing_into( address - path.offsets[ i ], address - path.offsets[ i ] ) )
+                        sources.push_back( entry.source );
+                }
+
+                std::ranges::sort( sources );
+                sources.erase( std::unique( sources.begin(), sources.end() ), sources.end() );
+                std::swap( addresses, sources );
+
+                if ( addresses.empty() )
+                    return false;
+            }
+
+            return std::ranges::any_of(
+                addresses,
+                [ & ]( std::uintptr_t address )
+                { return address >= path.offsets[ 0 ] && std::ranges::binary_search( _entries, entry_t{ address - path.offsets[ 0 ], start } ); } );
+        };
+
+        std::vector< std::uint8_t > kept( paths.size() );
+
+        const auto lambda = [ & ]( const pointer_path_t& path ) { kept[ &path - paths.data() ] = leads( path ); };
+
+        if ( parallelize )
+            std::for_each( std::execution::par, paths.begin(), paths.end(), lambda );
+        else
+            std::for_each( paths.begin(), paths.end(), lambda );
+
+        std::vector< pointer_path_t > result;
+
+        for ( std::size_t i = 0; i < paths.size(); ++i )
+        {
+            if ( kept[ i ] )
+                result.push_back( paths[ i ] );
+        }
+
+        return result;
+    }
+
+    bool pointer_map::save( const std::filesystem::path& path ) const noexcept
+    {
+        try
+        {
+            auto temporary = path;
+            temporary += ".tmp";
+
+            {
+                std::ofstream out( temporary, std::ios::binary | std::ios::trunc );
+
+                if ( !out )
+                    return false;
+
+                write( out, magic );
+                write( out, version );
+                write( out, static_cast< std::uint32_t >( pointer_size ) );
+                write( out, static_cast< std::uint32_t >( _images.size() ) );
+                write( out, static_cast< std::uint64_t >( _entries.size() ) );
+
+                for ( const auto& image : _images )
+                {
+                    write( out, static_cast< std::uint32_t >( image.name.size() ) );
+                    out.write( image.name.data(), static_cast< std::streamsize >( image.name.size() ) );
+                    write( out, static_cast< std::uint64_t >( image.address ) );
+                    write( out, static_cast< std::uint64_t >( image.size ) );
+                }
+
+                write( out, _entries );
+
+                if ( !out.flush() )
+                    return false;
+            }
+
+            std::error_code ec;
+            std::filesystem::rename( temporary, path, ec );
+
+            return !ec;
+        }
+        catch ( ... )
+        {
+            return false;
+        }
+    }
+
+    std::optional< pointer_map > pointer_map::load( const std::filesystem::path& path ) noexcept
+    {
+        try
+        {
+            std::ifstream in( path, std::ios::binary );
+
+            if ( !in )
+                return std::nullopt;
+
+            std::uint32_t file_magic, file_version, file_pointer_size, images;
+            std::uint64_t entries;
+
+            if ( !read( in, file_magic ) || !read( in, file_version ) || !read( in, file_pointer_size ) || !read( in, images ) ||
+                 !read( in, entries ) )
+                return std::nullopt;
+
+            if ( file_magic != magic || file_version != version || file_pointer_size != pointer_size )
+                return std::nullopt;
+
+            std::error_code ec;
+            const auto file_size = std::filesystem::file_size( path, ec );
+
+            if ( ec )
+                return std::nullopt;
+
+            pointer_map result;
+
+            for ( std::uint32_t i = 0; i < images; ++i )
+            {
+                std::uint32_t length;
+                std::uint64_t address, size;
+
+                if ( !read( in, length ) || length > file_size )
+                    return std::nullopt;
+
+                std::string name( length, '\0' );
+
+                if ( !in.read( name.data(), length ) || !read( in, address ) || !read( in, size ) )
+                    return std::nullopt;
+
+                result._images.push_back( { std::move( name ), static_cast< std::uintptr_t >( address ), static_cast< std::size_t >( size ) } );
+            }
+
+            // The entries make up the rest of the file, so check their count against it before allocating anything.
+            const auto position = static_cast< std::uint64_t >( in.tellg() );
+
+            if ( position > file_size || ( file_size - position ) / sizeof( entry_t ) != entries || ( file_size - position ) % sizeof( entry_t ) )
+                return std::nullopt;
+
+            if ( !read( in, result._entries, entries ) )
+                return std::nullopt;
+
+            // The searches rely on the order, so a file that breaks it is corrupt.
+            if ( !std::ranges::is_sorted( result._images, {}, &pointer_image_t::address ) || !std::ranges::is_sorted( result._entries ) )
+                return std::nullopt;
+
+            return result;
+        }
+        catch ( ... )
+        {
+            return std::nullopt;
+        }
+    }
+
+    std::span< const pointer_map::entry_t > pointer_map::pointing_into( std::uintptr_t low, std::uintptr_t high ) const noexcept
+    {
+        const auto first = std::ranges::lower_bound( _entries, low, {}, &entry_t::target );
+        const auto last = std::ranges::upper_bound( first, _entries.end(), high, {}, &entry_t::target );
+
+        return { first, last };
+    }
+
+    std::optional< std::uint32_t > pointer_map::image_of( std::uintptr_t address ) const noexcept
+    {
+        const auto it = std::ranges::upper_bound( _images, address, {}, &pointer_image_t::address );
+
+        if ( it == _images.begin() || address - std::prev( it )->address >= std::prev( it )->size )
+            return std::nullopt;
+
+        return static_cast< std::uint32_t >( std::prev( it ) - _images.begin() );
+    }
+}  // namespace wincpp::patterns
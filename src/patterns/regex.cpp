@@ -0,0 +1,767 @@
+#include "wincpp/patterns/regex.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <map>
+#include <tuple>
+
+#include "wincpp/core/error.hpp"
+
+namespace wincpp::patterns
+{
+    namespace
+    {
+        constexpr auto none = std::numeric_limits< std::uint32_t >::max();
+
+        /// <summary>
+        /// A node of the parsed expression.
+        /// </summary>
+        struct node_t
+        {
+            enum class type_t
+            {
+                set_t,
+                concat_t,
+                alternate_t,
+                repeat_t
+            };
+
+            type_t type;
+            std::size_t set = 0, min = 0, max = 0;
+            std::vector< std::size_t > children;
+        };
+
+        /// <summary>
+        /// A recursive descent parser for the expression syntax. Atoms are handed to `pattern_t::parse`, so they accept exactly what a
+        /// pattern position accepts.
+        /// </summary>
+        class parser_t
+        {
+           public:
+            parser_t( std::string_view text, std::vector< byte_class_t >& sets ) noexcept : text( text ), sets( sets )
+            {
+            }
+
+            std::size_t parse()
+            {
+                const auto root = alternation();
+
+                skip();
+
+                if ( position != text.size() )
+                    fail();
+
+                return root;
+            }
+
+            std::vector< node_t > nodes;
+
+           private:
+            [[noreturn]] void fail() const
+            {
+                throw core::error::from_user(
+                    core::user_error_type_t::invalid_pattern_t, "Failed to parse regex \"{}\" at offset {}", text, position );
+            }
+
+            void skip() noexcept
+            {
+                while ( position < text.size() &&
+                        ( text[ position ] == ' ' || text[ position ] == '\t' || text[ position ] == '\n' || text[ position ] == '\r' ) )
+                    ++position;
+            }
+
+            bool peek( char c ) noexcept
+            {
+                skip();
+                return position < text.size() && text[ position ] == c;
+            }
+
+            std::size_t add( node_t node )
+            {
+                nodes.push_back( std::move( node ) );
+                return nodes.size() - 1;
+            }
+
+            std::size_t alternation()
+            {
+                std::vector< std::size_t > children{ sequence() };
+
+                while ( peek( '|' ) )
+                {
+                    ++position;
+                    children.push_back( sequence() );
+                }
+
+                if ( children.size() == 1 )
+                    return children.front();
+
+                return add( { node_t::type_t::alternate_t, 0, 0, 0, std::move( children ) } );
+            }
+
+            std::size_t sequence()
+            {
+                std::vector< std::size_t > children;
+
+                while ( !peek( '|' ) && !peek( ')' ) && position < text.size() )
+                    children.push_back( repeat() );
+
+                return add( { node_t::type_t::concat_t, 0, 0, 0, std::move( children ) } );
+            }
+
+            std::size_t repeat()
+            {
+                auto result = atom();
+
+                while ( peek( '{' ) )
+                {
+                    ++position;
+
+                    if ( !peek( ',' ) && ( position == text.size() || text[ position ] < '0' || text[ position ] > '9' ) )
+                        fail();
+
+                    const auto min = number( 0 );
+                    auto max = min;
+
+                    if ( peek( ',' ) )
+                    {
+                        ++position;
+                        skip();
+
+                        // An upper bound is required, so that every match has a bounded length.
+                        if ( position == text.size() || text[ position ] < '0' || text[ position ] > '9' )
+                            fail();
+
+                        max = number( 0 );
+                    }
+
+                    if ( !peek( '}' ) || min > max || max > regex_t::max_repeat )
+                        fail();
+
+                    ++position;
+                    result = add( { node_t::type_t::repeat_t, 0, min, max, { result } } );
+                }
+
+                return result;
+            }
+
+            std::size_t number( std::size_t fallback ) noexcept
+            {
+                skip();
+
+                if ( position == text.size() || text[ position ] < '0' || text[ position ] > '9' )
+                    return fallback;
+
+                std::size_t result = 0;
+
+                while ( position < text.size() && text[ position ] >= '0' && text[ position ] <= '9' && result <= regex_t::max_repeat )
+                    result = result * 10 + static_cast< std::size_t >( text[ position++ ] - '0' );
+
+                return result;
+            }
+
+            std::size_t atom()
+            {
+                if ( peek( '(' ) )
+                {
+                    ++position;
+
+                    const auto result = alternation();
+
+                    if ( !peek( ')' ) )
+                        fail();
+
+                    ++position;
+                    return result;
+                }
+
+                // The token is either a bracketed class or a run of hex digits, `?` and `|`.
+                const auto begin = position;
+
+                if ( text[ position ] == '[' )
+                {
+                    while ( position < text.size() && text[ position ] != ']' )
+                        ++position;
+
+                    if ( position == text.size() )
+                        fail();
+
+                    ++position;
+                }
+                else
+                {
+                    const auto token = []( char c )
+                    { return ( c >= '0' && c <= '9' ) || ( c >= 'a' && c <= 'f' ) || ( c >= 'A' && c <= 'F' ) || c == '?' || c == '|'; };
+
+                    while ( position < text.size() && token( text[ position ] ) )
+                        ++position;
+                }
+
+                pattern_t pattern;
+
+                if ( position == begin || !pattern_t::parse( text.substr( begin, position - begin ), pattern ) || pattern.size != 1 )
+                {
+                    position = begin;
+                    fail();
+                }
+
+                byte_class_t set{};
+
+                for ( std::size_t byte = 0; byte < 256; ++byte )
+                {
+                    if ( pattern.accepts( 0, static_cast< std::uint8_t >( byte ) ) )
+                        set.insert( static_cast< std::uint8_t >( byte ) );
+                }
+
+                // Share identical sets, which keeps the byte classes few.
+                auto index = std::find_if(
+                    sets.begin(), sets.end(), [ & ]( const byte_class_t& other ) { return std::equal( set.bits, set.bits + 4, other.bits ); } );
+
+                if ( index == sets.end() )
+                    index = sets.insert( sets.end(), set );
+
+                return add( { node_t::type_t::set_t, static_cast< std::size_t >( index - sets.begin() ), 0, 0, {} } );
+            }
+
+            std::string_view text;
+            std::vector< byte_class_t >& sets;
+            std::size_t position = 0;
+        };
+
+        /// <summary>
+        /// Turns the parsed expression into an automaton. Every fragment ends in an empty state whose `out` is linked to what follows.
+        /// </summary>
+        class builder_t
+        {
+           public:
+            builder_t( std::string_view text, const std::vector< node_t >& nodes, regex_t::program_t& program, bool reverse ) noexcept
+                : text( text ),
+                  nodes( nodes ),
+                  program( program ),
+                  reverse( reverse )
+            {
+            }
+
+            void build( std::size_t root )
+            {
+                const auto [ start, end ] = emit( root );
+
+                program.states[ end ].out = add( regex_t::state_t::type_t::match_t );
+                program.start = start;
+            }
+
+           private:
+            std::uint32_t add( regex_t::state_t::type_t type, std::uint32_t set = 0, std::uint32_t out = none, std::uint32_t alternate = none )
+            {
+                if ( program.states.size() == regex_t::max_states )
+                    throw core::error::from_user(
+                        core::user_error_type_t::pattern_too_large_t,
+                        "The regex \"{}\" expands to more than {} states",
+                        text,
+                        regex_t::max_states );
+
+                program.states.push_back( { type, set, out, alternate } );
+                return static_cast< std::uint32_t >( program.states.size() - 1 );
+            }
+
+            std::pair< std::uint32_t, std::uint32_t > emit( std::size_t index )
+            {
+                using type_t = regex_t::state_t::type_t;
+
+                const auto& node = nodes[ index ];
+
+                switch ( node.type )
+                {
+                    case node_t::type_t::set_t:
+                    {
+                        const auto end = add( type_t::empty_t );
+                        return { add( type_t::byte_t, static_cast< std::uint32_t >( node.set ), end ), end };
+                    }
+                    case node_t::type_t::concat_t:
+                    {
+                        auto start = none, end = none;
+
+                        for ( std::size_t i = 0; i < node.children.size(); ++i )
+                        {
+                            const auto [ s, e ] = emit( node.children[ reverse ? node.children.size() - 1 - i : i ] );
+
+                            if ( start == none )
+                                start = s;
+                            else
+                                program.states[ end ].out = s;
+
+                            end = e;
+                        }
+
+                        if ( start == none )
+                            start = end = add( type_t::empty_t );
+
+                        return { start, end };
+                    }
+                    case node_t::type_t::alternate_t:
+                    {
+                        const auto end = add( type_t::empty_t );
+                        auto start = none;
+
+                        for ( auto i = node.children.size(); i-- > 0; )
+                        {
+                            const auto [ s, e ] = emit( node.children[ i ] );
+
+                            program.states[ e ].out = end;
+                            start = start == none ? s : add( type_t::split_t, 0, s, start );
+                        }
+
+                        return { start, end };
+                    }
+                    case node_t::type_t::repeat_t:
+                    {
+                        // Expand x{n,m} into n copies of x followed by m - n nested optional copies: x x (x (x)?)?
+                        const auto end = add( type_t::empty_t );
+                        auto start = none, last = none;
+
+                        const auto link = [ & ]( std::uint32_t next )
+                        {
+                            if ( start == none )
+                                start = next;
+                            else
+                                program.states[ last ].out = next;
+                        };
+
+                        for ( std::size_t i = 0; i < node.min; ++i )
+                        {
+                            const auto [ s, e ] = emit( node.children.front() );
+
+                            link( s );
+                            last = e;
+                        }
+
+                        for ( auto i = node.min; i < node.max; ++i )
+                        {
+                            const auto split = add( type_t::split_t, 0, none, end );
+
+                            link( split );
+
+                            const auto [ s, e ] = emit( node.children.front() );
+
+                            program.states[ split ].out = s;
+                            last = e;
+                        }
+
+                        link( end );
+                        return { start, end };
+                    }
+                }
+
+                return {};
+            }
+
+            std::string_view text;
+            const std::vector< node_t >& nodes;
+            regex_t::program_t& program;
+            bool reverse;
+        };
+
+        std::pair< std::size_t, std::size_t > bounds( const std::vector< node_t >& nodes, std::size_t index ) noexcept
+        {
+            const auto& node = nodes[ index ];
+
+            switch ( node.type )
+            {
+                case node_t::type_t::set_t: return { 1, 1 };
+                case node_t::type_t::concat_t:
+                {
+                    std::pair< std::size_t, std::size_t > result{ 0, 0 };
+
+                    for ( const auto child : node.children )
+                    {
+                        const auto [ min, max ] = bounds( nodes, child );
+
+                        result.first += min;
+                        result.second += max;
+                    }
+
+                    return result;
+                }
+                case node_t::type_t::alternate_t:
+                {
+                    std::pair< std::size_t, std::size_t > result{ std::numeric_limits< std::size_t >::max(), 0 };
+
+                    for ( const auto child : node.children )
+                    {
+                        const auto [ min, max ] = bounds( nodes, child );
+
+                        result.first = std::min( result.first, min );
+                        result.second = std::max( result.second, max );
+                    }
+
+                    return result;
+                }
+                case node_t::type_t::repeat_t:
+                {
+                    const auto [ min, max ] = bounds( nodes, node.children.front() );
+                    return { min * node.min, max * node.max };
+                }
+            }
+
+            return {};
+        }
+
+        /// <summary>
+        /// A DFA that is built from the automaton one transition at a time, as the scan reaches it. Each DFA state is the set of automaton
+        /// states that consume a byte or accept.
+        /// </summary>
+        class dfa_t
+        {
+           public:
+            dfa_t(
+                const regex_t::program_t& program,
+                const std::vector< byte_class_t >& sets,
+                const std::array< std::uint8_t, 256 >& classes,
+                std::size_t class_count,
+                bool unanchored )
+                : program( program ),
+                  sets( sets ),
+                  classes( classes ),
+                  class_count( class_count ),
+                  unanchored( unanchored ),
+                  marks( program.states.size(), 0 )
+            {
+                closure( program.start, initial );
+                std::sort( initial.begin(), initial.end() );
+
+                flush();
+            }
+
+            std::uint32_t start() const noexcept
+            {
+                return _start;
+            }
+
+            bool accepting( std::uint32_t state ) const noexcept
+            {
+                return flags[ state ] & accepting_flag;
+            }
+
+            bool dead( std::uint32_t state ) const noexcept
+            {
+                return flags[ state ] & dead_flag;
+            }
+
+            std::uint32_t next( std::uint32_t state, std::uint8_t byte )
+            {
+                const auto target = table[ state * class_count + classes[ byte ] ];
+                return target != none ? target : compute( state, byte );
+            }
+
+           private:
+            static constexpr std::uint8_t accepting_flag = 1, dead_flag = 2;
+
+            void closure( std::uint32_t state, std::vector< std::uint32_t >& out )
+            {
+                using type_t = regex_t::state_t::type_t;
+
+                stack.push_back( state );
+
+                while ( !stack.empty() )
+                {
+                    const auto current = stack.back();
+                    stack.pop_back();
+
+                    if ( current == none || marks[ current ] == generation )
+                        continue;
+
+                    marks[ current ] = generation;
+
+                    const auto& s = program.states[ current ];
+
+                    switch ( s.type )
+                    {
+                        case type_t::byte_t:
+                        case type_t::match_t: out.push_back( current ); break;
+                        case type_t::split_t: stack.push_back( s.alternate ); [[fallthrough]];
+                        case type_t::empty_t: stack.push_back( s.out ); break;
+                    }
+                }
+            }
+
+            std::uint32_t compute( std::uint32_t state, std::uint8_t byte )
+            {
+                std::vector< std::uint32_t > target;
+
+                ++generation;
+
+                for ( const auto member : members[ state ] )
+                {
+                    const auto& s = program.states[ member ];
+
+                    if ( s.type == regex_t::state_t::type_t::byte_t && sets[ s.set ].contains( byte ) )
+                        closure( s.out, target );
+                }
+
+                // An unanchored DFA can start a match at every byte, so the start states are part of every state.
+                if ( unanchored )
+                {
+                    for ( const auto member : initial )
+                    {
+                        if ( marks[ member ] != generation )
+                            target.push_back( member );
+                    }
+                }
+
+                std::sort( target.begin(), target.end() );
+
+                // Start over once the cache is full, keeping only the state the scan is in.
+                if ( members.size() >= regex_t::max_cached_states )
+                {
+                    const auto current = members[ state ];
+
+                    flush();
+                    state = intern( current );
+                }
+
+                const auto result = intern( target );
+
+                table[ state * class_count + classes[ byte ] ] = result;
+                return result;
+            }
+
+            std::uint32_t intern( const std::vector< std::uint32_t >& set )
+            {
+                const auto [ it, inserted ] = ids.try_emplace( set, static_cast< std::uint32_t >( members.size() ) );
+
+                if ( !inserted )
+                    return it->second;
+
+                std::uint8_t flag = set.empty() ? dead_flag : 0;
+
+                for ( const auto member : set )
+                {
+                    if ( program.states[ member ].type == regex_t::state_t::type_t::match_t )
+                        flag |= accepting_flag;
+                }
+
+                members.push_back( set );
+                flags.push_back( flag );
+                table.resize( table.size() + class_count, none );
+
+                return it->second;
+            }
+
+            void flush()
+            {
+                ids.clear();
+                members.clear();
+                flags.clear();
+                table.clear();
+
+                _start = intern( initial );
+            }
+
+            const regex_t::program_t& program;
+            const std::vector< byte_class_t >& sets;
+            const std::array< std::uint8_t, 256 >& classes;
+            std::size_t class_count;
+
+            bool unanchored;
+
+            std::vector< std::uint32_t > initial;
+            std::uint32_t _start = 0;
+
+            std::map< std::vector< std::uint32_t >, std::uint32_t > ids;
+            std::vector< std::vector< std::uint32_t > > members;
+            std::vector< std::uint8_t > flags;
+            std::vector< std::uint32_t > table;
+
+            std::vector< std::uint32_t > marks, stack;
+            std::uint32_t generation = 1;
+        };
+    }  // namespace
+
+    regex_t::regex_t( std::string_view text )
+    {
+        parser_t parser( text, sets );
+
+        const auto root = parser.parse();
+
+        std::tie( _min_size, _max_size ) = bounds( parser.nodes, root );
+
+        if ( _min_size == 0 )
+            throw core::error::from_user( core::user_error_type_t::invalid_pattern_t, "The regex \"{}\" matches an empty sequence", text );
+
+        builder_t( text, parser.nodes, forward, false ).build( root );
+        builder_t( text, parser.nodes, backward, true ).build( root );
+
+        // Split the bytes into the coarsest classes that every set either fully contains or excludes.
+        class_count = 1;
+
+        for ( const auto& set : sets )
+        {
+            std::array< std::int16_t, 512 > ids;
+            std::size_t next = 0;
+
+            ids.fill( -1 );
+
+            for ( std::size_t byte = 0; byte < 256; ++byte )
+            {
+                auto& id = ids[ classes[ byte ] * 2 + set.contains( static_cast< std::uint8_t >( byte ) ) ];
+
+                if ( id == -1 )
+                    id = static_cast< std::int16_t >( next++ );
+
+                classes[ byte ] = static_cast< std::uint8_t >( id );
+            }
+
+            class_count = next;
+        }
+
+        // The bytes that can begin a match are those consumed by the states the forward automaton starts in.
+        std::vector< std::uint32_t > pending{ forward.start }, seen( forward.states.size(), 0 );
+
+        while ( !pending.empty() )
+        {
+            const auto index = pending.back();
+            pending.pop_back();
+
+            if ( index == none || seen[ index ] )
+                continue;
+
+            seen[ index ] = 1;
+
+            const auto& state = forward.states[ index ];
+
+            switch ( state.type )
+            {
+                case state_t::type_t::byte_t:
+                    for ( std::size_t i = 0; i < 4; ++i )
+                        first.bits[ i ] |= sets[ state.set ].bits[ i ];
+                    break;
+                case state_t::type_t::split_t: pending.push_back( state.alternate ); [[fallthrough]];
+                case state_t::type_t::empty_t: pending.push_back( state.out ); break;
+                case state_t::type_t::match_t: break;
+            }
+        }
+    }
+
+    std::size_t regex_t::min_size() const noexcept
+    {
+        return _min_size;
+    }
+
+    std::size_t regex_t::max_size() const noexcept
+    {
+        return _max_size;
+    }
+
+    template< typename callback_t >
+    void regex_t::scan( std::span< std::uint8_t > buffer, callback_t&& callback ) const noexcept
+    {
+        if ( forward.states.empty() )
+            return;
+
+        dfa_t forward_dfa( forward, sets, classes, class_count, true );
+        dfa_t backward_dfa( backward, sets, classes, class_count, false );
+
+        const auto data = buffer.data();
+        const auto size = buffer.size();
+
+        // When every match begins with the same byte, skip to it with memchr instead of testing the set byte by byte.
+        std::optional< std::uint8_t > lead;
+
+        if ( first.count() == 1 )
+        {
+            for ( std::size_t byte = 0; byte < 256 && !lead; ++byte )
+            {
+                if ( first.contains( static_cast< std::uint8_t >( byte ) ) )
+                    lead = static_cast< std::uint8_t >( byte );
+            }
+        }
+
+        for ( std::size_t from = 0; from < size; )
+        {
+            // Scan forward for the earliest end of a match that starts at or after `from`.
+            auto state = forward_dfa.start();
+            auto end = size + 1;
+
+            for ( auto i = from; i < size; )
+            {
+                if ( state == forward_dfa.start() )
+                {
+                    if ( lead )
+                    {
+                        const auto next = static_cast< const std::uint8_t* >( std::memchr( data + i, *lead, size - i ) );
+                        i = next ? static_cast< std::size_t >( next - data ) : size;
+                    }
+                    else
+                    {
+                        while ( i < size && !first.contains( data[ i ] ) )
+                            ++i;
+                    }
+
+                    if ( i == size )
+                        break;
+                }
+
+                state = forward_dfa.next( state, data[ i++ ] );
+
+                if ( forward_dfa.accepting( state ) )
+                {
+                    end = i;
+                    break;
+                }
+            }
+
+            if ( end > size )
+                return;
+
+            // Scan backward with the reversed expression for the earliest start of a match that ends there.
+            auto start = end;
+            state = backward_dfa.start();
+
+            for ( auto j = end; j > from && end - j < _max_size; )
+            {
+                state = backward_dfa.next( state, data[ --j ] );
+
+                if ( backward_dfa.dead( state ) )
+                    break;
+
+                if ( backward_dfa.accepting( state ) )
+                    start = j;
+            }
+
+            if ( !callback( match_t{ start, end - start } ) )
+                return;
+
+            from = end;
+        }
+    }
+
+    std::optional< regex_t::match_t > regex_t::find( std::span< std::uint8_t > buffer ) const noexcept
+    {
+        std::optional< match_t > result;
+
+        scan(
+            buffer,
+            [ & ]( const match_t& match )
+            {
+                result = match;
+                return false;
+            } );
+
+        return result;
+    }
+
+    std::vector< regex_t::match_t > regex_t::find_all( std::span< std::uint8_t > buffer ) const noexcept
+    {
+        std::vector< match_t > results;
+
+        scan(
+            buffer,
+            [ & ]( const match_t& match )
+            {
+                results.push_back( match );
+                return true;
+            } );
+
+        return results;
+    }
+}  // namespace wincpp::patterns
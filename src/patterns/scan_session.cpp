@@ -0,0 +1,542 @@
+#include "wincpp/patterns/scan_session.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstring>
+#include <execution>
+#include <memory>
+
+#include "wincpp/core/error.hpp"
+
+namespace wincpp::patterns
+{
+    namespace
+    {
+        /// <summary>
+        /// The maximum number of adjacent blocks that are read at once.
+        /// </summary>
+        constexpr std::size_t run_blocks = 256;
+
+        /// <summary>
+        /// Gets whether the candidates take less room as offsets and values than as bits and a copy of the block. Sparse blocks gather their
+        /// values one by one, so they only pay off well below the break-even point.
+        /// </summary>
+        constexpr bool fits_sparse( std::size_t count, std::size_t value_size, std::size_t block_size ) noexcept
+        {
+            return count * ( sizeof( std::uint16_t ) + value_size ) * 4 <= block_size;
+        }
+
+        /// <summary>
+        /// Releases the storage of a vector that has shrunk to less than half of it.
+        /// </summary>
+        template< typename T >
+        void trim( std::vector< T >& vector )
+        {
+            if ( vector.capacity() > vector.size() * 2 )
+                vector.shrink_to_fit();
+        }
+    }  // namespace
+
+    scan_session::scan_session( reader_t reader, std::span< const range_t > ranges, const value_query_t& query, bool parallelize )
+        : _reader( std::move( reader ) ),
+          _type( query.type ),
+          _alignment( query.alignment )
+    {
+        if ( _alignment > block_size )
+            throw core::error::from_user(
+                core::user_error_type_t::invalid_value_query_t, "The alignment {} is larger than a block of {} bytes", _alignment, block_size );
+
+        split( ranges );
+
+        // Every value the alignment allows starts out as a candidate and the query narrows them like in any later pass, so the first scan runs
+        // the same kernels over whole words instead of collecting offsets.
+        pass(
+            parallelize,
+            [ & ]( block_t& block, const std::uint8_t* bytes )
+            {
+                narrow(
+                    block,
+                    bytes,
+                    [ & ]( std::span< const std::uint8_t > values, std::span< const std::uint8_t >, std::span< std::uint64_t > candidates )
+                    { return filter_values( values, query, candidates ); } );
+            } );
+    }
+
+    scan_session::scan_session(
+        reader_t reader,
+        std::span< const range_t > ranges,
+        value_type_t type,
+        std::size_t alignment,
+        const std::filesystem::path& spill,
+        bool parallelize )
+        : _reader( std::move( reader ) ),
+          _type( type ),
+          _alignment( alignment )
+    {
+        if ( !std::has_single_bit( _alignment ) || _alignment > block_size )
+            throw core::error::from_user(
+                core::user_error_type_t::invalid_value_query_t, "The alignment {} isn't a power of two up to {}", _alignment, block_size );
+
+        split( ranges );
+
+        // The store is attached once every block is in it, so that the first pass doesn't look for pages that aren't there yet.
+        auto store = spill.empty() ? std::make_unique< page_store >() : std::make_unique< page_store >( spill );
+        store->resize( _blocks.size() );
+
+        pass(
+            parallelize,
+            [ & ]( block_t& block, const std::uint8_t* bytes )
+            {
+                if ( !store->store( block.slot, { bytes, std::size_t( block.size ) + block.tail } ) )
+                    drop( block );
+            } );
+
+        _store = std::move( store );
+    }
+
+    std::size_t scan_session::next( const value_query_t& query, bool parallelize )
+    {
+        if ( query.type != _type )
+            throw core::error::from_user( core::user_error_type_t::invalid_value_query_t, "The query is for another type than the session" );
+
+        return pass(
+            parallelize,
+            [ & ]( block_t& block, const std::uint8_t* bytes )
+            {
+                narrow(
+                    block,
+                    bytes,
+                    [ & ]( std::span< const std::uint8_t > values, std::span< const std::uint8_t >, std::span< std::uint64_t > candidates )
+                    { return filter_values( values, query, candidates ); } );
+            } );
+    }
+
+    std::size_t scan_session::next( value_change_t change, bool parallelize )
+    {
+        return pass(
+            parallelize,
+            [ & ]( block_t& block, const std::uint8_t* bytes )
+            {
+                narrow(
+                    block,
+                    bytes,
+                    [ & ]( std::span< const std::uint8_t > values, std::span< const std::uint8_t > previous, std::span< std::uint64_t > candidates )
+                    { return filter_values( values, previous, _type, change, candidates ); } );
+            } );
+    }
+
+    std::size_t scan_session::count() const noexcept
+    {
+        return _count;
+    }
+
+    value_type_t scan_session::type() const noexcept
+    {
+        return _type;
+    }
+
+    std::vector< std::uintptr_t > scan_session::addresses( std::size_t limit ) const
+    {
+        std::vector< std::uintptr_t > addresses;
+        addresses.reserve( std::min( limit, _count ) );
+
+        const auto size = size_of( _type );
+        std::vector< std::uintptr_t > offsets;
+
+        for ( const auto& block : _blocks )
+        {
+            if ( addresses.size() >= limit )
+                break;
+
+            offsets.clear();
+
+            if ( block.dense() )
+                offsets = offsets_of( block );
+            else if ( !block.offsets.empty() )
+                offsets.assign( block.offsets.begin(), block.offsets.end() );
+            else
+            {
+                for ( std::size_t offset = 0; offset < block.size && offset + size <= std::size_t( block.size ) + block.tail; offset += _alignment )
+                    offsets.push_back( offset );
+            }
+
+            for ( const auto offset : offsets )
+            {
+                if ( addresses.size() >= limit )
+                    break;
+
+                addresses.push_back( block.address + offset );
+            }
+        }
+
+        return addresses;
+    }
+
+    std::size_t scan_session::memory_usage() const noexcept
+    {
+        auto usage = sizeof( *this ) + _blocks.capacity() * sizeof( block_t );
+
+        for ( const auto& block : _blocks )
+        {
+            usage += block.bits.capacity() * sizeof( std::uint64_t ) + block.offsets.capacity() * sizeof( std::uint16_t ) +
+                     block.values.capacity() * sizeof( std::uint8_t );
+        }
+
+        if ( _store )
+            usage += _store->memory_usage();
+
+        return usage;
+    }
+
+    std::size_t scan_session::step() const noexcept
+    {
+        return std::min( _alignment, size_of( _type ) );
+    }
+
+    std::size_t scan_session::shifts() const noexcept
+    {
+        return size_of( _type ) / step();
+    }
+
+    std::size_t scan_session::words() const noexcept
+    {
+        const auto size = size_of( _type );
+        return ( ( block_size + size - 1 ) / size + 63 ) / 64;
+    }
+
+    void scan_session::split( std::span< const range_t > ranges )
+    {
+        const auto size = size_of( _type );
+
+        for ( const auto& range : ranges )
+        {
+            for ( std::size_t offset = 0; offset < range.size; offset += block_size )
+            {
+                const auto length = std::min( block_size, range.size - offset );
+                const auto tail = std::min( size - 1, range.size - offset - length );
+
+                auto& block = _blocks.emplace_back( block_t{ range.address + offset,
+                                                             static_cast< std::uint16_t >( length ),
+                                                             static_cast< std::uint16_t >( tail ),
+                                                             0,
+                                                             static_cast< std::uint32_t >( _blocks.size() ),
+                                                             {},
+                                                             {},
+                                                             {} } );
+
+                block.count = static_cast< std::uint32_t >( unknown_count( block ) );
+            }
+        }
+    }
+
+    std::size_t scan_session::unknown_count( const block_t& block ) const noexcept
+    {
+        const auto size = size_of( _type );
+        const std::size_t end = std::size_t( block.size ) + block.tail;
+
+        if ( end < size )
+            return 0;
+
+        return std::min( ( block.size + _alignment - 1 ) / _alignment, ( end - size ) / _alignment + 1 );
+    }
+
+    void scan_session::seed( block_t& block ) const
+    {
+        // Alignments larger than a value leave every `alignment / size`-th bit of the only set.
+        std::uint64_t pattern = ~std::uint64_t( 0 );
+        std::size_t every = 1;
+
+        if ( const auto spacing = _alignment / size_of( _type ); spacing >= 64 )
+            pattern = 1, every = spacing / 64;
+        else if ( spacing > 1 )
+        {
+            pattern = 0;
+
+            for ( std::size_t lane = 0; lane < 64; lane += spacing )
+                pattern |= std::uint64_t( 1 ) << lane;
+        }
+
+        block.bits.assign( shifts() * words(), 0 );
+
+        for ( std::size_t word = 0; word < block.bits.size(); word += every )
+            block.bits[ word ] = pattern;
+    }
+
+    std::vector< std::uintptr_t > scan_session::offsets_of( const block_t& block ) const
+    {
+        const auto size = size_of( _type );
+
+        std::vector< std::uintptr_t > offsets;
+        offsets.reserve( block.count );
+
+        // The bit sets interleave, so the offsets are sorted once they are all collected.
+        for ( std::size_t shift = 0; shift < shifts(); ++shift )
+        {
+            for ( std::size_t word = 0; word < words(); ++word )
+            {
+                for ( auto bits = block.bits[ shift * words() + word ]; bits; bits &= bits - 1 )
+                    offsets.push_back( ( word * 64 + std::countr_zero( bits ) ) * size + shift * step() );
+            }
+        }
+
+        std::sort( offsets.begin(), offsets.end() );
+        return offsets;
+    }
+
+    void scan_session::sparsify( block_t& block, const std::uint8_t* bytes ) const
+    {
+        const auto size = size_of( _type );
+        const auto offsets = offsets_of( block );
+
+        block.bits = {};
+        block.offsets.assign( offsets.begin(), offsets.end() );
+        block.values.resize( offsets.size() * size );
+
+        for ( std::size_t i = 0; i < offsets.size(); ++i )
+            std::memcpy( block.values.data() + i * size, bytes + offsets[ i ], size );
+
+        trim( block.values );
+    }
+
+    void scan_session::drop( block_t& block ) const noexcept
+    {
+        block.count = 0;
+        block.bits = {};
+        block.offsets = {};
+        block.values = {};
+    }
+
+    void scan_session::drop_tail( block_t& block ) const
+    {
+        const auto value_size = size_of( _type );
+        const std::size_t end = std::size_t( block.size ) + block.tail;
+
+        block.tail = 0;
+
+        if ( block.offsets.empty() )
+        {
+            // Dense and unknown blocks count their values from the end of the bytes, so only the copy is cut.
+            std::array< std::uint8_t, block_size + sizeof( std::uint64_t ) > page;
+
+            if ( !_store )
+            {
+                if ( !block.values.empty() )
+                    block.values.resize( block.size );
+            }
+            else if ( !_store->load( block.slot, { page.data(), end } ) || !_store->store( block.slot, { page.data(), block.size } ) )
+            {
+                drop( block );
+                return;
+            }
+
+            if ( !block.dense() )
+                block.count = static_cast< std::uint32_t >( unknown_count( block ) );
+
+            return;
+        }
+
+        std::size_t kept = 0;
+
+        for ( std::size_t i = 0; i < block.offsets.size(); ++i )
+        {
+            if ( block.offsets[ i ] + value_size > block.size )
+                continue;
+
+            block.offsets[ kept ] = block.offsets[ i ];
+            std::memmove( block.values.data() + kept * value_size, block.values.data() + i * value_size, value_size );
+            ++kept;
+        }
+
+        block.offsets.resize( kept );
+        block.values.resize( kept * value_size );
+        block.count = static_cast< std::uint32_t >( kept );
+    }
+
+    template< typename filter_t >
+    void scan_session::narrow( block_t& block, const std::uint8_t* bytes, filter_t&& filter ) const
+    {
+        const auto value_size = size_of( _type );
+        const std::size_t size = block.size, end = std::size_t( block.size ) + block.tail;
+
+        if ( block.offsets.empty() )
+        {
+            const auto unknown = !block.dense();
+
+            if ( unknown )
+                seed( block );
+
+            // The previous bytes are in the store, or in the block. The first scan of a known value has none, and doesn't need them.
+            std::array< std::uint8_t, block_size + sizeof( std::uint64_t ) > page;
+            auto previous = unknown ? bytes : block.values.data();
+
+            if ( _store )
+            {
+                if ( !_store->load( block.slot, { page.data(), end } ) )
+                {
+                    drop( block );
+                    return;
+                }
+
+                previous = page.data();
+            }
+
+            std::size_t count = 0;
+
+            for ( std::size_t shift = 0; shift < shifts(); ++shift )
+            {
+                // The values of the set that start in the block and end before the end of the bytes.
+                const auto start = shift * step();
+                const auto lanes = start < size ? std::min( ( size - start + value_size - 1 ) / value_size, ( end - start ) / value_size ) : 0;
+                const auto length = lanes * value_size;
+
+                count += filter( { bytes + start, length }, { previous + start, length }, { block.bits.data() + shift * words(), words() } );
+            }
+
+            block.count = static_cast< std::uint32_t >( count );
+
+            if ( !count )
+            {
+                drop( block );
+                return;
+            }
+
+            if ( fits_sparse( count, value_size, size ) )
+            {
+                sparsify( block, bytes );
+
+                if ( _store )
+                    _store->erase( block.slot );
+            }
+            else if ( _store )
+            {
+                if ( !_store->store( block.slot, { bytes, end } ) )
+                    drop( block );
+            }
+            else
+                block.values.assign( bytes, bytes + end );
+
+            return;
+        }
+
+        // Gather the current values next to the previous ones, so the sparse candidates are filtered like a dense run.
+        std::array< std::uint8_t, block_size > current;
+        std::array< std::uint64_t, block_size / 64 > candidates;
+
+        const auto total = block.offsets.size();
+
+        for ( std::size_t i = 0; i < total; ++i )
+            std::memcpy( current.data() + i * value_size, bytes + block.offsets[ i ], value_size );
+
+        std::fill_n( candidates.data(), ( total + 63 ) / 64, ~std::uint64_t( 0 ) );
+
+        block.count = static_cast< std::uint32_t >(
+            filter( { current.data(), total * value_size }, block.values, { candidates.data(), ( total + 63 ) / 64 } ) );
+
+        std::size_t kept = 0;
+
+        for ( std::size_t i = 0; i < total; ++i )
+        {
+            if ( !( ( candidates[ i / 64 ] >> ( i % 64 ) ) & 1 ) )
+                continue;
+
+            block.offsets[ kept ] = block.offsets[ i ];
+            std::memcpy( block.values.data() + kept * value_size, current.data() + i * value_size, value_size );
+            ++kept;
+        }
+
+        block.offsets.resize( kept );
+        block.values.resize( kept * value_size );
+
+        trim( block.offsets );
+        trim( block.values );
+    }
+
+    template< typename callback_t >
+    std::size_t scan_session::pass( bool parallelize, callback_t&& callback )
+    {
+        struct run_t
+        {
+            std::size_t first, last;
+        };
+
+        std::vector< run_t > runs;
+
+        for ( std::size_t first = 0; first < _blocks.size(); )
+        {
+            auto last = first + 1;
+
+            while ( last < _blocks.size() && last - first < run_blocks && _blocks[ last ].address == _blocks[ last - 1 ].address + _blocks[ last - 1 ].size )
+                ++last;
+
+            runs.push_back( { first, last } );
+            first = last;
+        }
+
+        const auto lambda = [ & ]( const run_t& run )
+        {
+            const auto& first = _blocks[ run.first ];
+            const auto& last = _blocks[ run.last - 1 ];
+            const auto address = first.address;
+
+            std::vector< std::uint8_t > buffer( last.address + last.size + last.tail - address );
+
+            if ( _reader( address, buffer.size(), buffer.data() ) )
+            {
+                for ( auto i = run.first; i < run.last; ++i )
+                {
+                    if ( _blocks[ i ].count )
+                        callback( _blocks[ i ], buffer.data() + ( _blocks[ i ].address - address ) );
+                }
+
+                return;
+            }
+
+            // Part of the run can't be read, so read its blocks one by one and drop the candidates of those that fail. A block whose tail
+            // fails loses the tail for good, and with it the values that end in it.
+            for ( auto i = run.first; i < run.last; ++i )
+            {
+                auto& block = _blocks[ i ];
+
+                if ( !block.count )
+                    continue;
+
+                if ( _reader( block.address, std::size_t( block.size ) + block.tail, buffer.data() ) )
+                    callback( block, buffer.data() );
+                else if ( block.tail && _reader( block.address, block.size, buffer.data() ) )
+                {
+                    drop_tail( block );
+
+                    if ( block.count )
+                        callback( block, buffer.data() );
+                }
+                else
+                    drop( block );
+            }
+        };
+
+        if ( parallelize )
+            std::for_each( std::execution::par, runs.begin(), runs.end(), lambda );
+        else
+            std::for_each( runs.begin(), runs.end(), lambda );
+
+        // The pages of the blocks that are dropped are freed with them.
+        if ( _store )
+        {
+            for ( const auto& block : _blocks )
+            {
+                if ( !block.count )
+                    _store->erase( block.slot );
+            }
+        }
+
+        std::erase_if( _blocks, []( const block_t& block ) { return block.count == 0; } );
+
+        _count = 0;
+
+        for ( const auto& block : _blocks )
+            _count += block.count;
+
+        return _count;
+    }
+}  // namespace wincpp::patterns
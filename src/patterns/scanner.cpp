@@ -1,26 +1,507 @@
 #include "wincpp/patterns/scanner.hpp"
 
-#include "wincpp/memory/memory.hpp"
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <random>
+#include <string>
 
-#undef max
-#undef min
+#include "wincpp/core/cpu.hpp"
+
+#if defined( WINCPP_X86 )
+#include <immintrin.h>
+#endif
 
 namespace wincpp::patterns
 {
+    namespace
+    {
+        /// <summary>
+        /// Scalar fallback for the vectorized kernels. Scans the positions starting at `start`.
+        /// </summary>
+        std::int64_t scan_scalar( const compiled_pattern_t& pattern, const std::span< std::uint8_t >& buffer, std::size_t start ) noexcept
+        {
+            const auto data = buffer.data();
+            const auto [ a0, a1 ] = pattern.anchors;
+
+            for ( std::size_t i = start; i + pattern.size() <= buffer.size(); ++i )
+            {
+                if ( ( data[ i + a0 ] & pattern.mask[ a0 ] ) == pattern.value[ a0 ] && ( data[ i + a1 ] & pattern.mask[ a1 ] ) == pattern.value[ a1 ] &&
+                     pattern.matches( data + i ) )
+                    return static_cast< std::int64_t >( i );
+            }
+
+            return -1;
+        }
+
+#if defined( WINCPP_X86 )
+        /// <summary>
+        /// Verifies every candidate in the bit mask, lowest position first. Returns the first position that matches.
+        /// </summary>
+        template< typename mask_t >
+        inline std::int64_t
+        verify_candidates( const compiled_pattern_t& pattern, const std::span< std::uint8_t >& buffer, std::size_t base, mask_t mask ) noexcept
+        {
+            while ( mask )
+            {
+                const auto i = base + std::countr_zero( mask );
+
+                if ( i + pattern.size() <= buffer.size() && pattern.matches( buffer.data() + i ) )
+                    return static_cast< std::int64_t >( i );
+
+                mask &= mask - 1;
+            }
+
+            return -1;
+        }
+
+        WINCPP_TARGET( "sse2" )
+        std::int64_t scan_sse2( const compiled_pattern_t& pattern, const std::span< std::uint8_t >& buffer ) noexcept
+        {
+            const auto data = buffer.data();
+            const auto [ a0, a1 ] = pattern.anchors;
+            const auto first = _mm_set1_epi8( static_cast< char >( pattern.value[ a0 ] ) );
+            const auto last = _mm_set1_epi8( static_cast< char >( pattern.value[ a1 ] ) );
+            const auto first_mask = _mm_set1_epi8( static_cast< char >( pattern.mask[ a0 ] ) );
+            const auto last_mask = _mm_set1_epi8( static_cast< char >( pattern.mask[ a1 ] ) );
+
+            std::size_t i = 0;
+
+            for ( ; i + a1 + 16 <= buffer.size(); i += 16 )
+            {
+                const auto a = _mm_and_si128( _mm_loadu_si128( reinterpret_cast< const __m128i* >( data + i + a0 ) ), first_mask );
+                const auto b = _mm_and_si128( _mm_loadu_si128( reinterpret_cast< const __m128i* >( data + i + a1 ) ), last_mask );
+                const auto mask = static_cast< std::uint32_t >( _mm_movemask_epi8( _mm_and_si128( _mm_cmpeq_epi8( a, first ), _mm_cmpeq_epi8( b, last ) ) ) );
+
+                if ( const auto result = verify_candidates( pattern, buffer, i, mask ); result != -1 )
+                    return result;
+            }
+
+            return scan_scalar( pattern, buffer, i );
+        }
+
+        WINCPP_TARGET( "avx2" )
+        std::int64_t scan_avx2( const compiled_pattern_t& pattern, const std::span< std::uint8_t >& buffer ) noexcept
+        {
+            const auto data = buffer.data();
+            const auto [ a0, a1 ] = pattern.anchors;
+            const auto first = _mm256_set1_epi8( static_cast< char >( pattern.value[ a0 ] ) );
+            const auto last = _mm256_set1_epi8( static_cast< char >( pattern.value[ a1 ] ) );
+            const auto first_mask = _mm256_set1_epi8( static_cast< char >( pattern.mask[ a0 ] ) );
+            const auto last_mask = _mm256_set1_epi8( static_cast< char >( pattern.mask[ a1 ] ) );
+
+            std::size_t i = 0;
+
+            for ( ; i + a1 + 32 <= buffer.size(); i += 32 )
+            {
+                const auto a = _mm256_and_si256( _mm256_loadu_si256( reinterpret_cast< const __m256i* >( data + i + a0 ) ), first_mask );
+                const auto b = _mm256_and_si256( _mm256_loadu_si256( reinterpret_cast< const __m256i* >( data + i + a1 ) ), last_mask );
+                const auto mask =
+                    static_cast< std::uint32_t >( _mm256_movemask_epi8( _mm256_and_si256( _mm256_cmpeq_epi8( a, first ), _mm256_cmpeq_epi8( b, last ) ) ) );
+
+                if ( const auto result = verify_candidates( pattern, buffer, i, mask ); result != -1 )
+                    return result;
+            }
+
+            return scan_scalar( pattern, buffer, i );
+        }
+
+        WINCPP_TARGET( "avx512f,avx512bw" )
+        std::int64_t scan_avx512( const compiled_pattern_t& pattern, const std::span< std::uint8_t >& buffer ) noexcept
+        {
+            const auto data = buffer.data();
+            const auto [ a0, a1 ] = pattern.anchors;
+            const auto first = _mm512_set1_epi8( static_cast< char >( pattern.value[ a0 ] ) );
+            const auto last = _mm512_set1_epi8( static_cast< char >( pattern.value[ a1 ] ) );
+            const auto first_mask = _mm512_set1_epi8( static_cast< char >( pattern.mask[ a0 ] ) );
+            const auto last_mask = _mm512_set1_epi8( static_cast< char >( pattern.mask[ a1 ] ) );
+
+            std::size_t i = 0;
+
+            for ( ; i + a1 + 64 <= buffer.size(); i += 64 )
+            {
+                const auto a = _mm512_and_si512( _mm512_loadu_si512( data + i + a0 ), first_mask );
+                const auto b = _mm512_and_si512( _mm512_loadu_si512( data + i + a1 ), last_mask );
+                const auto mask = static_cast< std::uint64_t >( _mm512_cmpeq_epi8_mask( a, first ) & _mm512_cmpeq_epi8_mask( b, last ) );
+
+                if ( const auto result = verify_candidates( pattern, buffer, i, mask ); result != -1 )
+                    return result;
+            }
+
+            return scan_scalar( pattern, buffer, i );
+        }
+#endif
+
+        /// <summary>
+        /// Folds an ASCII letter to lower case and leaves every other byte as it is.
+        /// </summary>
+        constexpr std::uint8_t fold( std::uint8_t byte ) noexcept
+        {
+            return byte >= 'A' && byte <= 'Z' ? byte | 0x20 : byte;
+        }
+
+        /// <summary>
+        /// A string prepared for `find_string`. The first and last characters are the anchors the vectorized kernels compare against:
+        /// OR-ing a byte with the fold bit of a letter maps both cases onto the lower case, and the fold bit is zero for every other byte.
+        /// </summary>
+        struct string_needle_t
+        {
+            string_needle_t( std::string_view text, string_encoding_t encoding ) : folded( text.size(), '\0' )
+            {
+                std::transform( text.begin(), text.end(), folded.begin(), []( char c ) { return static_cast< char >( fold( c ) ); } );
+
+                first = static_cast< std::uint8_t >( folded.front() );
+                last = static_cast< std::uint8_t >( folded.back() );
+                first_fold = first >= 'a' && first <= 'z' ? 0x20 : 0x00;
+                last_fold = last >= 'a' && last <= 'z' ? 0x20 : 0x00;
+                ascii = ( static_cast< std::uint8_t >( encoding ) & static_cast< std::uint8_t >( string_encoding_t::ascii_nocase_t ) ) != 0;
+                wide = ( static_cast< std::uint8_t >( encoding ) & static_cast< std::uint8_t >( string_encoding_t::utf16le_t ) ) != 0;
+            }
+
+            /// <summary>
+            /// The number of bytes past a candidate the kernels load from.
+            /// </summary>
+            std::size_t reach() const noexcept
+            {
+                return wide ? std::max< std::size_t >( 2 * ( folded.size() - 1 ), 1 ) : folded.size() - 1;
+            }
+
+            bool matches_ascii( const std::span< std::uint8_t >& buffer, std::size_t offset ) const noexcept
+            {
+                if ( offset + folded.size() > buffer.size() )
+                    return false;
+
+                for ( std::size_t i = 0; i < folded.size(); ++i )
+                {
+                    if ( fold( buffer[ offset + i ] ) != static_cast< std::uint8_t >( folded[ i ] ) )
+                        return false;
+                }
+
+                return true;
+            }
+
+            bool matches_wide( const std::span< std::uint8_t >& buffer, std::size_t offset ) const noexcept
+            {
+                if ( offset + folded.size() * 2 > buffer.size() )
+                    return false;
+
+                for ( std::size_t i = 0; i < folded.size(); ++i )
+                {
+                    if ( fold( buffer[ offset + i * 2 ] ) != static_cast< std::uint8_t >( folded[ i ] ) || buffer[ offset + i * 2 + 1 ] != 0 )
+                        return false;
+                }
+
+                return true;
+            }
+
+            /// <summary>
+            /// Verifies the candidates at the offset and adds the matches. Returns false once the results are full.
+            /// </summary>
+            bool verify( const std::span< std::uint8_t >& buffer, std::size_t offset, bool try_ascii, bool try_wide, std::vector< string_match_t >& results,
+                         std::size_t limit ) const
+            {
+                if ( try_ascii && matches_ascii( buffer, offset ) )
+                {
+                    results.push_back( { offset, string_encoding_t::ascii_nocase_t } );
+
+                    if ( results.size() >= limit )
+                        return false;
+                }
+
+                if ( try_wide && matches_wide( buffer, offset ) )
+                {
+                    results.push_back( { offset, string_encoding_t::utf16le_t } );
+
+                    if ( results.size() >= limit )
+                        return false;
+                }
+
+                return true;
+            }
+
+            std::string folded;
+            std::uint8_t first, last, first_fold, last_fold;
+            bool ascii, wide;
+        };
+
+        /// <summary>
+        /// Scalar fallback for the vectorized string kernels, and the reference they are checked against. Scans the positions starting at
+        /// `start`.
+        /// </summary>
+        void find_strings_scalar(
+            const string_needle_t& needle,
+            const std::span< std::uint8_t >& buffer,
+            std::size_t start,
+            std::vector< string_match_t >& results,
+            std::size_t limit )
+        {
+            for ( auto i = start; i < buffer.size(); ++i )
+            {
+                if ( ( buffer[ i ] | needle.first_fold ) != needle.first )
+                    continue;
+
+                if ( !needle.verify( buffer, i, needle.ascii, needle.wide, results, limit ) )
+                    return;
+            }
+        }
+
+        /// <summary>
+        /// Verifies every candidate in the bit masks, lowest position first. Returns false once the results are full.
+        /// </summary>
+        template< typename mask_t >
+        inline bool verify_strings(
+            const string_needle_t& needle,
+            const std::span< std::uint8_t >& buffer,
+            std::size_t base,
+            mask_t ascii,
+            mask_t wide,
+            std::vector< string_match_t >& results,
+            std::size_t limit )
+        {
+            for ( auto mask = ascii | wide; mask; mask &= mask - 1 )
+            {
+                const auto bit = mask & ( ~mask + 1 );
+
+                if ( !needle.verify( buffer, base + std::countr_zero( mask ), ( ascii & bit ) != 0, ( wide & bit ) != 0, results, limit ) )
+                    return false;
+            }
+
+            return true;
+        }
+
+#if defined( WINCPP_X86 )
+        // The kernels compare the first character at every position, and in the same pass the last character one and two bytes per character
+        // later, plus the zero high byte of the first UTF-16 character. A candidate passes for an encoding when all of its anchors do.
+
+        WINCPP_TARGET( "sse2" )
+        void find_strings_sse2( const string_needle_t& needle, const std::span< std::uint8_t >& buffer, std::vector< string_match_t >& results, std::size_t limit )
+        {
+            const auto data = buffer.data();
+            const auto size = needle.folded.size(), reach = needle.reach();
+            const auto first = _mm_set1_epi8( static_cast< char >( needle.first ) ), first_fold = _mm_set1_epi8( static_cast< char >( needle.first_fold ) );
+            const auto last = _mm_set1_epi8( static_cast< char >( needle.last ) ), last_fold = _mm_set1_epi8( static_cast< char >( needle.last_fold ) );
+            const auto zero = _mm_setzero_si128();
+
+            std::size_t i = 0;
+
+            for ( ; i + reach + 16 <= buffer.size(); i += 16 )
+            {
+                const auto head =
+                    _mm_cmpeq_epi8( _mm_or_si128( _mm_loadu_si128( reinterpret_cast< const __m128i* >( data + i ) ), first_fold ), first );
+
+                std::uint32_t ascii = 0, wide = 0;
+
+                if ( needle.ascii )
+                {
+                    const auto tail = _mm_or_si128( _mm_loadu_si128( reinterpret_cast< const __m128i* >( data + i + size - 1 ) ), last_fold );
+                    ascii = static_cast< std::uint32_t >( _mm_movemask_epi8( _mm_and_si128( head, _mm_cmpeq_epi8( tail, last ) ) ) );
+                }
+
+                if ( needle.wide )
+                {
+                    const auto high = _mm_cmpeq_epi8( _mm_loadu_si128( reinterpret_cast< const __m128i* >( data + i + 1 ) ), zero );
+                    const auto tail = _mm_or_si128( _mm_loadu_si128( reinterpret_cast< const __m128i* >( data + i + 2 * ( size - 1 ) ) ), last_fold );
+                    wide = static_cast< std::uint32_t >( _mm_movemask_epi8( _mm_and_si128( _mm_and_si128( head, high ), _mm_cmpeq_epi8( tail, last ) ) ) );
+                }
+
+                if ( !verify_strings( needle, buffer, i, ascii, wide, results, limit ) )
+                    return;
+            }
+
+            find_strings_scalar( needle, buffer, i, results, limit );
+        }
+
+        WINCPP_TARGET( "avx2" )
+        void find_strings_avx2( const string_needle_t& needle, const std::span< std::uint8_t >& buffer, std::vector< string_match_t >& results, std::size_t limit )
+        {
+            const auto data = buffer.data();
+            const auto size = needle.folded.size(), reach = needle.reach();
+            const auto first = _mm256_set1_epi8( static_cast< char >( needle.first ) ), first_fold = _mm256_set1_epi8( static_cast< char >( needle.first_fold ) );
+            const auto last = _mm256_set1_epi8( static_cast< char >( needle.last ) ), last_fold = _mm256_set1_epi8( static_cast< char >( needle.last_fold ) );
+            const auto zero = _mm256_setzero_si256();
+
+            std::size_t i = 0;
+
+            for ( ; i + reach + 32 <= buffer.size(); i += 32 )
+            {
+                const auto head =
+                    _mm256_cmpeq_epi8( _mm256_or_si256( _mm256_loadu_si256( reinterpret_cast< const __m256i* >( data + i ) ), first_fold ), first );
+
+                std::uint32_t ascii = 0, wide = 0;
+
+                if ( needle.ascii )
+                {
+                    const auto tail = _mm256_or_si256( _mm256_loadu_si256( reinterpret_cast< const __m256i* >( data + i + size - 1 ) ), last_fold );
+                    ascii = static_cast< std::uint32_t >( _mm256_movemask_epi8( _mm256_and_si256( head, _mm256_cmpeq_epi8( tail, last ) ) ) );
+                }
+
+                if ( needle.wide )
+                {
+                    const auto high = _mm256_cmpeq_epi8( _mm256_loadu_si256( reinterpret_cast< const __m256i* >( data + i + 1 ) ), zero );
+                    const auto tail =
+                        _mm256_or_si256( _mm256_loadu_si256( reinterpret_cast< const __m256i* >( data + i + 2 * ( size - 1 ) ) ), last_fold );
+                    wide = static_cast< std::uint32_t >(
+                        _mm256_movemask_epi8( _mm256_and_si256( _mm256_and_si256( head, high ), _mm256_cmpeq_epi8( tail, last ) ) ) );
+                }
+
+                if ( !verify_strings( needle, buffer, i, ascii, wide, results, limit ) )
+                    return;
+            }
+
+            find_strings_scalar( needle, buffer, i, results, limit );
+        }
+
+        WINCPP_TARGET( "avx512f,avx512bw" )
+        void find_strings_avx512( const string_needle_t& needle, const std::span< std::uint8_t >& buffer, std::vector< string_match_t >& results, std::size_t limit )
+        {
+            const auto data = buffer.data();
+            const auto size = needle.folded.size(), reach = needle.reach();
+            const auto first = _mm512_set1_epi8( static_cast< char >( needle.first ) ), first_fold = _mm512_set1_epi8( static_cast< char >( needle.first_fold ) );
+            const auto last = _mm512_set1_epi8( static_cast< char >( needle.last ) ), last_fold = _mm512_set1_epi8( static_cast< char >( needle.last_fold ) );
+            const auto zero = _mm512_setzero_si512();
+
+            std::size_t i = 0;
+
+            for ( ; i + reach + 64 <= buffer.size(); i += 64 )
+            {
+                const auto head = _mm512_cmpeq_epi8_mask( _mm512_or_si512( _mm512_loadu_si512( data + i ), first_fold ), first );
+
+                std::uint64_t ascii = 0, wide = 0;
+
+                if ( needle.ascii )
+                    ascii = head & _mm512_cmpeq_epi8_mask( _mm512_or_si512( _mm512_loadu_si512( data + i + size - 1 ), last_fold ), last );
+
+                if ( needle.wide )
+                    wide = head & _mm512_cmpeq_epi8_mask( _mm512_loadu_si512( data + i + 1 ), zero ) &
+                           _mm512_cmpeq_epi8_mask( _mm512_or_si512( _mm512_loadu_si512( data + i + 2 * ( size - 1 ) ), last_fold ), last );
+
+                if ( !verify_strings( needle, buffer, i, ascii, wide, results, limit ) )
+                    return;
+            }
+
+            find_strings_scalar( needle, buffer, i, results, limit );
+        }
+#endif
+
+        /// <summary>
+        /// The thresholds used by `auto_t`. Each is atomic so that `tune` can run while other threads scan.
+        /// </summary>
+        std::atomic< std::size_t > small_buffer_size = 16;
+        std::atomic< std::size_t > min_bndm_size = 5;
+        std::atomic< std::uint8_t > max_bndm_wildcards = 68;
+
+        /// <summary>
+        /// Gets the percentage of the positions of the pattern that aren't strict bytes.
+        /// </summary>
+        std::uint8_t wildcard_share( const compiled_pattern_t& pattern ) noexcept
+        {
+            if ( pattern.size() == 0 )
+                return 100;
+
+            const auto wildcards =
+                std::count_if( pattern.mask.begin(), pattern.mask.begin() + pattern.size(), []( std::uint8_t mask ) { return mask != 0xFF; } );
+
+            return static_cast< std::uint8_t >( wildcards * 100 / pattern.size() );
+        }
+
+        /// <summary>
+        /// Picks the algorithm for a pattern in a buffer that isn't small, under the thresholds.
+        /// </summary>
+        scanner::algorithm_t choose( const compiled_pattern_t& pattern, const scanner::tuning_t& tuning, bool vectorized ) noexcept
+        {
+            // The vectorized search only stops at anchor hits, and even with common anchors it compares a whole vector per step.
+            if ( vectorized )
+                return scanner::algorithm_t::simd_t;
+
+            // Otherwise every byte is looked at by Shift-Or, while BNDM skips further the longer the pattern is and the fewer wildcards it has.
+            if ( pattern.size() >= tuning.min_bndm_size && wildcard_share( pattern ) <= tuning.max_bndm_wildcards )
+                return scanner::algorithm_t::bndm_t;
+
+            return scanner::algorithm_t::shift_or_t;
+        }
+
+        /// <summary>
+        /// Gets the best of three runs of counting every match of the pattern, in nanoseconds.
+        /// </summary>
+        /// <param name="buffer">The buffer to scan.</param>
+        /// <param name="pattern">The compiled pattern to count.</param>
+        /// <param name="repeat">The number of scans per run.</param>
+        template< scanner::algorithm_t algorithm >
+        double measure( std::span< std::uint8_t > buffer, const compiled_pattern_t& pattern, std::size_t repeat ) noexcept
+        {
+            volatile std::size_t found = 0;  // Keeps the scans from being optimized away
+            auto best = std::numeric_limits< double >::max();
+
+            for ( std::size_t run = 0; run < 3; ++run )
+            {
+                const auto start = std::chrono::steady_clock::now();
+
+                for ( std::size_t i = 0; i < repeat; ++i )
+                    found = found + scanner::count< algorithm >( buffer, pattern );
+
+                best = std::min( best, std::chrono::duration< double, std::nano >( std::chrono::steady_clock::now() - start ).count() );
+            }
+
+            return best;
+        }
+
+        /// <summary>
+        /// A measurement for fitting a threshold: the key of the sample (e.g. the pattern size) and the time of the algorithm used below the
+        /// threshold and of the one used at or above it.
+        /// </summary>
+        struct sample_t
+        {
+            std::size_t key;
+            double below;
+            double above;
+        };
+
+        /// <summary>
+        /// Picks the threshold that minimizes the total time of the samples. Ties go to the earliest candidate, so the current threshold should
+        /// come first to keep it when the samples can't tell the candidates apart.
+        /// </summary>
+        /// <param name="samples">The measurements.</param>
+        /// <param name="candidates">The thresholds to try.</param>
+        /// <returns>The best threshold.</returns>
+        std::size_t fit( const std::vector< sample_t >& samples, const std::vector< std::size_t >& candidates ) noexcept
+        {
+            auto best = candidates.front();
+            auto best_time = std::numeric_limits< double >::max();
+
+            for ( const auto candidate : candidates )
+            {
+                double time = 0;
+
+                for ( const auto& sample : samples )
+                    time += sample.key < candidate ? sample.below : sample.above;
+
+                if ( time < best_time )
+                {
+                    best = candidate;
+                    best_time = time;
+                }
+            }
+
+            return best;
+        }
+    }  // namespace
+
     template<>
-    static std::int64_t scanner::index_of< scanner::algorithm_t::naive_t >(
-        const pattern_t& pattern,
-        const std::span< std::uint8_t >& buffer ) noexcept
+    std::int64_t scanner::index_of< scanner::algorithm_t::naive_t >( const compiled_pattern_t& pattern, const std::span< std::uint8_t >& buffer ) noexcept
     {
-        for ( auto it = buffer.cbegin(); it != buffer.cend(); ++it )
+        if ( pattern.size() == 0 || pattern.size() > buffer.size() )
+            return -1;
+
+        for ( auto it = buffer.begin(); it != buffer.end() - ( pattern.size() - 1 ); ++it )
         {
-            for ( auto i = 0; i < pattern.size; ++i )
+            for ( std::size_t i = 0; i < pattern.size(); ++i )
             {
-                if ( pattern.mask[ i ] && pattern.bytes[ i ] != it[ i ] )
+                if ( ( it[ i ] & pattern.mask[ i ] ) != pattern.value[ i ] )
                     break;
 
-                if ( i == pattern.size - 1 )
-                    return static_cast< std::int64_t >( it - buffer.cbegin() );
+                if ( i == pattern.size() - 1 && pattern.matches_classes( &*it ) )
+                    return static_cast< std::int64_t >( it - buffer.begin() );
             }
         }
 
@@ -28,172 +509,151 @@ namespace wincpp::patterns
     }
 
     template<>
-    static std::int64_t scanner::index_of< scanner::algorithm_t::bmh_t >( const pattern_t& pattern, const std::span< std::uint8_t >& buffer ) noexcept
+    std::int64_t scanner::index_of< scanner::algorithm_t::bmh_t >( const compiled_pattern_t& pattern, const std::span< std::uint8_t >& buffer ) noexcept
     {
-        if ( pattern.size == 0 || buffer.size() == 0 || pattern.size > buffer.size() )
+        if ( pattern.size() == 0 || buffer.size() == 0 || pattern.size() > buffer.size() )
         {
             return -1;
         }
 
-        // Build the skip table for the Boyer-Moore-Horspool algorithm
-        std::size_t skip_table[ 256 ];  // Assume byte values range from 0 to 255
-
-        std::fill( std::begin( skip_table ), std::end( skip_table ), pattern.size );
-
-        for ( std::size_t i = 0; i < pattern.size - 1; ++i )
-        {
-            if ( pattern.mask[ i ] )
-            {
-                // Only build the table for strict bytes
-                skip_table[ pattern.bytes[ i ] ] = pattern.size - 1 - i;
-            }
-        }
+        const auto size = static_cast< std::int64_t >( pattern.size() );
 
         // Perform the search
         std::int64_t buffer_idx = 0;
 
-        while ( buffer_idx <= static_cast< std::int64_t >( buffer.size() - pattern.size ) )
+        while ( buffer_idx <= static_cast< std::int64_t >( buffer.size() ) - size )
         {
-            std::int64_t pattern_idx = pattern.size - 1;
+            std::int64_t pattern_idx = size - 1;
 
             // Match from the end of the pattern
             while ( pattern_idx >= 0 )
             {
-                if ( pattern.mask[ pattern_idx ] && pattern.bytes[ pattern_idx ] != buffer[ buffer_idx + pattern_idx ] )
+                if ( ( buffer[ buffer_idx + pattern_idx ] & pattern.mask[ pattern_idx ] ) != pattern.value[ pattern_idx ] )
                 {
                     break;  // Strict match failed, exit loop
                 }
                 --pattern_idx;
             }
 
-            if ( pattern_idx < 0 )
+            if ( pattern_idx < 0 && pattern.matches_classes( buffer.data() + buffer_idx ) )
             {
                 return buffer_idx;  // Pattern found
             }
 
             // Use the skip table to jump forward
-            std::uint8_t last_byte = buffer[ buffer_idx + pattern.size - 1 ];
-            buffer_idx += skip_table[ last_byte ];
+            std::uint8_t last_byte = buffer[ buffer_idx + size - 1 ];
+            buffer_idx += pattern.skip_table[ last_byte ];
         }
 
         return -1;  // No match found
     }
 
     template<>
-    static std::int64_t scanner::index_of< scanner::algorithm_t::tbm_t >( const pattern_t& pattern, const std::span< std::uint8_t >& buffer ) noexcept
+    std::int64_t scanner::index_of< scanner::algorithm_t::tbm_t >( const compiled_pattern_t& pattern, const std::span< std::uint8_t >& buffer ) noexcept
     {
-        if ( pattern.size == 0 || buffer.size() == 0 || pattern.size > buffer.size() )
+        if ( pattern.size() == 0 || buffer.size() == 0 || pattern.size() > buffer.size() )
         {
             return -1;
         }
 
-        // Build the skip table for the Turbo Boyer-Moore algorithm
-        std::size_t skip_table[ 256 ];
-        std::fill( std::begin( skip_table ), std::end( skip_table ), pattern.size );
+        const auto size = static_cast< std::int64_t >( pattern.size() );
+        const auto& skip_table = pattern.skip_table;
+        const auto& good_suffix = pattern.good_suffix;
 
-        for ( std::size_t i = 0; i < pattern.size - 1; ++i )
-        {
-            if ( pattern.mask[ i ] )
-            {
-                skip_table[ pattern.bytes[ i ] ] = pattern.size - 1 - i;
-            }
-        }
+        // The turbo shift remembers the factor of the text matched by the previous attempt. That only holds for exact patterns, because a
+        // wildcard tells us nothing about the byte it matched.
+        const bool turbo = pattern.exact;
 
-        // Variables for turbo shift optimization
-        std::int64_t turbo_shift = 0;
-        std::int64_t shift = 0;
+        std::int64_t memory = 0;  // The length of the remembered factor
+        std::int64_t shift = size;
         std::int64_t j = 0;  // j is the index in the buffer
 
         // Perform the search
-        while ( j <= static_cast< std::int64_t >( buffer.size() - pattern.size ) )
+        while ( j <= static_cast< std::int64_t >( buffer.size() ) - size )
         {
             // Match from the end of the pattern
-            std::int64_t i = pattern.size - 1;
+            std::int64_t i = size - 1;
 
-            // Compare the pattern from the end towards the beginning
-            while ( i >= 0 && pattern.bytes[ i ] == buffer[ j + i ] )
+            // Compare the pattern from the end towards the beginning, jumping over the remembered factor
+            while ( i >= 0 && ( buffer[ j + i ] & pattern.mask[ i ] ) == pattern.value[ i ] )
             {
                 --i;
+
+                if ( memory != 0 && i == size - 1 - shift )
+                    i -= memory;
             }
 
             if ( i < 0 )
             {
-                return j;  // Pattern found
+                if ( pattern.matches_classes( buffer.data() + j ) )
+                    return j;  // Pattern found
+
+                // A byte class rejected the window, so shift by the period of the pattern.
+                j += good_suffix[ 0 ];
+                continue;
             }
 
-            // Check if we can apply the turbo shift
-            if ( turbo_shift > 0 )
+            const auto matched = size - 1 - i;
+            const auto turbo_shift = memory - matched;
+            const auto bc_shift = static_cast< std::int64_t >( skip_table[ buffer[ j + size - 1 ] ] ) - matched;
+            const auto gs_shift = static_cast< std::int64_t >( good_suffix[ i ] );
+
+            shift = std::max( { turbo_shift, bc_shift, gs_shift } );
+
+            if ( turbo && shift == gs_shift )
             {
-                shift = std::max( std::int64_t( 1 ), static_cast< std::int64_t >( skip_table[ buffer[ j + pattern.size - 1 ] ] ) );
-                turbo_shift = 0;  // Reset turbo shift after using it
+                memory = std::min( size - shift, matched );
             }
             else
             {
-                // Otherwise, shift based on the skip table
-                std::uint8_t last_byte = buffer[ j + pattern.size - 1 ];
-                shift = skip_table[ last_byte ];
+                if ( turbo_shift < bc_shift )
+                    shift = std::max( shift, memory + 1 );
 
-                // Apply turbo shift if applicable
-                if ( i < pattern.size - 1 )
-                {
-                    turbo_shift = pattern.size - 1 - i;
-                }
+                memory = 0;
             }
 
-            j += std::max( shift, turbo_shift );  // Move forward by the calculated shift or turbo shift
+            j += shift;  // Move forward by the calculated shift
         }
 
         return -1;  // No match found
     }
 
     template<>
-    static std::int64_t scanner::index_of< scanner::algorithm_t::raita_t >(
-        const pattern_t& pattern,
-        const std::span< std::uint8_t >& buffer ) noexcept
+    std::int64_t scanner::index_of< scanner::algorithm_t::raita_t >( const compiled_pattern_t& pattern, const std::span< std::uint8_t >& buffer ) noexcept
     {
-        if ( pattern.size == 0 || buffer.size() == 0 || pattern.size > buffer.size() )
+        if ( pattern.size() == 0 || buffer.size() == 0 || pattern.size() > buffer.size() )
         {
             return -1;
         }
 
-        // Raita uses a combination of the first, middle, and last bytes for an efficient search
-        std::size_t last_idx = pattern.size - 1;
-        std::size_t mid_idx = pattern.size / 2;
-
-        // Build the skip table for the Raita algorithm
-        std::size_t skip_table[ 256 ];
-        std::fill( std::begin( skip_table ), std::end( skip_table ), pattern.size );
+        const auto& value = pattern.value;
+        const auto& mask = pattern.mask;
 
-        for ( std::size_t i = 0; i < last_idx; ++i )
-        {
-            if ( pattern.mask[ i ] )
-            {
-                skip_table[ pattern.bytes[ i ] ] = last_idx - i;
-            }
-        }
+        // Raita uses a combination of the first, middle, and last bytes for an efficient search
+        std::size_t last_idx = pattern.size() - 1;
+        std::size_t mid_idx = pattern.size() / 2;
 
         std::int64_t buffer_idx = 0;
 
-        while ( buffer_idx <= static_cast< std::int64_t >( buffer.size() - pattern.size ) )
+        while ( buffer_idx <= static_cast< std::int64_t >( buffer.size() - pattern.size() ) )
         {
             // Check the last byte first
-            if ( !pattern.mask[ last_idx ] || pattern.bytes[ last_idx ] == buffer[ buffer_idx + last_idx ] )
+            if ( ( buffer[ buffer_idx + last_idx ] & mask[ last_idx ] ) == value[ last_idx ] )
             {
                 // Check the first byte
-                if ( !pattern.mask[ 0 ] || pattern.bytes[ 0 ] == buffer[ buffer_idx ] )
+                if ( ( buffer[ buffer_idx ] & mask[ 0 ] ) == value[ 0 ] )
                 {
                     // Check the middle byte
-                    if ( !pattern.mask[ mid_idx ] || pattern.bytes[ mid_idx ] == buffer[ buffer_idx + mid_idx ] )
+                    if ( ( buffer[ buffer_idx + mid_idx ] & mask[ mid_idx ] ) == value[ mid_idx ] )
                     {
                         // Now verify the rest of the pattern
                         std::size_t pattern_idx = 1;
-                        while ( pattern_idx < last_idx &&
-                                ( !pattern.mask[ pattern_idx ] || pattern.bytes[ pattern_idx ] == buffer[ buffer_idx + pattern_idx ] ) )
+                        while ( pattern_idx < last_idx && ( buffer[ buffer_idx + pattern_idx ] & mask[ pattern_idx ] ) == value[ pattern_idx ] )
                         {
                             ++pattern_idx;
                         }
 
-                        if ( pattern_idx == last_idx )
+                        if ( pattern_idx >= last_idx && pattern.matches_classes( buffer.data() + buffer_idx ) )
                         {
                             return buffer_idx;  // Full pattern match
                         }
@@ -203,10 +663,399 @@ namespace wincpp::patterns
 
             // Skip using the skip table
             std::uint8_t last_byte = buffer[ buffer_idx + last_idx ];
-            buffer_idx += skip_table[ last_byte ];
+            buffer_idx += pattern.skip_table[ last_byte ];
+        }
+
+        return -1;  // No match found
+    }
+
+    template<>
+    std::int64_t scanner::index_of< scanner::algorithm_t::simd_t >( const compiled_pattern_t& pattern, const std::span< std::uint8_t >& buffer ) noexcept
+    {
+        if ( pattern.size() == 0 || buffer.size() == 0 || pattern.size() > buffer.size() )
+        {
+            return -1;
+        }
+
+        // A pattern made up of wildcards matches at the very first position.
+        if ( pattern.strict == 0 )
+            return 0;
+
+#if defined( WINCPP_X86 )
+        switch ( core::simd_level() )
+        {
+            case core::simd_level_t::avx512_t: return scan_avx512( pattern, buffer );
+            case core::simd_level_t::avx2_t: return scan_avx2( pattern, buffer );
+            case core::simd_level_t::sse2_t: return scan_sse2( pattern, buffer );
+            default: break;
+        }
+#endif
+
+        return scan_scalar( pattern, buffer, 0 );
+    }
+
+    template<>
+    std::int64_t scanner::index_of< scanner::algorithm_t::bndm_t >( const compiled_pattern_t& pattern, const std::span< std::uint8_t >& buffer ) noexcept
+    {
+        if ( pattern.size() == 0 || buffer.size() == 0 || pattern.size() > buffer.size() )
+        {
+            return -1;
+        }
+
+        const auto window = pattern.size();
+        const auto full = window == compiled_pattern_t::word_size ? ~std::uint64_t( 0 ) : ( std::uint64_t( 1 ) << window ) - 1;
+        const auto& masks = pattern.position_masks;
+        const auto data = buffer.data();
+
+        std::size_t pos = 0;
+
+        while ( pos + pattern.size() <= buffer.size() )
+        {
+            // Read the window backwards. Bit `k` of `state` is set while the bytes read so far can start at pattern position `k`.
+            std::size_t j = window, last = window;
+            std::uint64_t state = full;
+
+            while ( state != 0 )
+            {
+                state &= masks[ data[ pos + j - 1 ] ];
+                --j;
+
+                if ( state & 1 )
+                {
+                    if ( j > 0 )
+                    {
+                        last = j;  // A prefix of the pattern starts here
+                    }
+                    else
+                    {
+                        return static_cast< std::int64_t >( pos );  // Pattern found
+                    }
+                }
+
+                state >>= 1;
+            }
+
+            pos += last;
         }
 
         return -1;  // No match found
     }
 
-}  // namespace wincpp::patterns
\ No newline at end of file
+    template<>
+    std::int64_t scanner::index_of< scanner::algorithm_t::shift_or_t >( const compiled_pattern_t& pattern, const std::span< std::uint8_t >& buffer ) noexcept
+    {
+        if ( pattern.size() == 0 || buffer.size() == 0 || pattern.size() > buffer.size() )
+        {
+            return -1;
+        }
+
+        const auto found = std::uint64_t( 1 ) << ( pattern.size() - 1 );
+        const auto& masks = pattern.position_masks;
+        const auto data = buffer.data();
+
+        // A cleared bit `k` means the last k + 1 bytes match the first k + 1 positions of the pattern.
+        std::uint64_t state = ~std::uint64_t( 0 );
+
+        for ( std::size_t i = 0; i < buffer.size(); ++i )
+        {
+            state = ( state << 1 ) | ~masks[ data[ i ] ];
+
+            if ( !( state & found ) )
+                return static_cast< std::int64_t >( i + 1 - pattern.size() );  // Pattern found
+        }
+
+        return -1;  // No match found
+    }
+
+    template<>
+    std::int64_t scanner::index_of< scanner::algorithm_t::auto_t >( const compiled_pattern_t& pattern, const std::span< std::uint8_t >& buffer ) noexcept
+    {
+        switch ( select( pattern, buffer.size() ) )
+        {
+            case algorithm_t::naive_t: return index_of< algorithm_t::naive_t >( pattern, buffer );
+            case algorithm_t::simd_t: return index_of< algorithm_t::simd_t >( pattern, buffer );
+            case algorithm_t::bndm_t: return index_of< algorithm_t::bndm_t >( pattern, buffer );
+            default: return index_of< algorithm_t::shift_or_t >( pattern, buffer );
+        }
+    }
+
+    scanner::algorithm_t scanner::select( const compiled_pattern_t& pattern, std::size_t size ) noexcept
+    {
+        // Small buffers are over before the setup of any other algorithm pays off.
+        if ( size <= small_buffer_size.load( std::memory_order_relaxed ) )
+            return algorithm_t::naive_t;
+
+        return choose( pattern, tuning(), core::simd_level() != core::simd_level_t::scalar_t );
+    }
+
+    scanner::tuning_t scanner::tuning() noexcept
+    {
+        return { small_buffer_size.load(), min_bndm_size.load(), max_bndm_wildcards.load() };
+    }
+
+    void scanner::tune( const tuning_t& tuning ) noexcept
+    {
+        small_buffer_size = tuning.small_buffer_size;
+        min_bndm_size = tuning.min_bndm_size;
+        max_bndm_wildcards = tuning.max_bndm_wildcards;
+    }
+
+    scanner::tuning_t scanner::calibrate( std::span< std::uint8_t > sample ) noexcept
+    {
+        auto result = tuning();
+
+        if ( sample.size() < 64 * 1024 )
+            return result;
+
+        // Larger samples don't change the ranking, they only make the calibration slower.
+        sample = sample.first( std::min< std::size_t >( sample.size(), 1024 * 1024 ) );
+
+        std::mt19937_64 random( sample.size() );
+
+        // Takes a pattern from a random place in the sample, with about the percentage of its inner positions wildcarded.
+        const auto make_pattern = [ & ]( std::size_t size, std::size_t wildcards = 25 )
+        {
+            const auto offset = random() % ( sample.size() - size );
+            auto pattern = pattern_t( sample.data() + offset, size );
+
+            for ( std::size_t i = 1; i + 1 < size; ++i )
+            {
+                if ( random() % 100 < wildcards )
+                    pattern.atoms[ i ] = atom_t{};
+            }
+
+            return compiled_pattern_t( pattern );
+        };
+
+        const bool simd = core::simd_level() != core::simd_level_t::scalar_t;
+
+        // Times the algorithm that the thresholds fitted so far pick for the pattern.
+        const auto measure_choice = [ & ]( std::span< std::uint8_t > buffer, const compiled_pattern_t& pattern, std::size_t repeat )
+        {
+            switch ( choose( pattern, result, simd ) )
+            {
+                case algorithm_t::simd_t: return measure< algorithm_t::simd_t >( buffer, pattern, repeat );
+                case algorithm_t::bndm_t: return measure< algorithm_t::bndm_t >( buffer, pattern, repeat );
+                default: return measure< algorithm_t::shift_or_t >( buffer, pattern, repeat );
+            }
+        };
+
+        // The BNDM size threshold: time Shift-Or against BNDM on every pattern size, with few enough wildcards for BNDM to be picked.
+        {
+            std::vector< sample_t > samples;
+            std::vector< std::size_t > candidates{ result.min_bndm_size, pattern_t::max_size + 1 };
+
+            for ( std::size_t size = 2; size <= pattern_t::max_size; size += ( size + 1 ) / 2 )
+            {
+                for ( std::size_t i = 0; i < 4; ++i )
+                {
+                    const auto pattern = make_pattern( size, 15 );
+
+                    samples.push_back(
+                        { size, measure< algorithm_t::shift_or_t >( sample, pattern, 1 ), measure< algorithm_t::bndm_t >( sample, pattern, 1 ) } );
+                }
+
+                candidates.push_back( size );
+            }
+
+            result.min_bndm_size = fit( samples, candidates );
+        }
+
+        // The BNDM wildcard threshold: time BNDM against Shift-Or on patterns long enough for BNDM, with up to three quarters of their
+        // positions wildcarded. A pattern uses BNDM if its share is below the fitted threshold, so the threshold is one above
+        // `max_bndm_wildcards`.
+        if ( result.min_bndm_size <= pattern_t::max_size )
+        {
+            std::vector< sample_t > samples;
+            std::vector< std::size_t > candidates{ result.max_bndm_wildcards + std::size_t( 1 ) };
+
+            for ( std::size_t i = 0; i < 48; ++i )
+            {
+                const auto size = std::max< std::size_t >( result.min_bndm_size, 8 );
+                const auto pattern = make_pattern( size + random() % ( pattern_t::max_size - size + 1 ), i % 8 * 10 );
+                const auto key = wildcard_share( pattern );
+
+                samples.push_back(
+                    { key, measure< algorithm_t::bndm_t >( sample, pattern, 1 ), measure< algorithm_t::shift_or_t >( sample, pattern, 1 ) } );
+                candidates.push_back( key + 1 );
+            }
+
+            result.max_bndm_wildcards = static_cast< std::uint8_t >( fit( samples, candidates ) - 1 );
+        }
+
+        // The small buffer threshold: time the naive search against the algorithm that would be picked otherwise on growing buffers. The
+        // naive search is used if the size is below the fitted threshold, so the threshold is one above `small_buffer_size`.
+        {
+            std::vector< sample_t > samples;
+            std::vector< std::size_t > candidates{ result.small_buffer_size + 1, 1 };
+
+            for ( std::size_t size = 16; size <= 4096; size *= 2 )
+            {
+                for ( std::size_t i = 0; i < 8; ++i )
+                {
+                    const auto pattern = make_pattern( 8 + random() % 9 );
+                    const auto buffer = sample.subspan( random() % ( sample.size() - size ), size );
+
+                    samples.push_back( { size, measure< algorithm_t::naive_t >( buffer, pattern, 64 ), measure_choice( buffer, pattern, 64 ) } );
+                }
+
+                candidates.push_back( size + 1 );
+            }
+
+            result.small_buffer_size = fit( samples, candidates ) - 1;
+        }
+
+        return result;
+    }
+
+    std::vector< approx_match_t >
+    scanner::find_approx( std::span< std::uint8_t > buffer, const pattern_t& pattern, std::size_t k, std::size_t limit ) noexcept
+    {
+        const compiled_pattern_t compiled( pattern );
+        const auto size = pattern.size;
+
+        if ( size == 0 || buffer.size() < size || limit == 0 )
+            return {};
+
+        std::vector< std::size_t > strict;
+
+        for ( std::size_t i = 0; i < size; ++i )
+        {
+            if ( compiled.mask[ i ] != 0 || pattern.class_of( i ) )
+                strict.push_back( i );
+        }
+
+        // A budget of every strict position would accept every location, so at least one of them must be right.
+        if ( strict.empty() )
+            return {};
+
+        k = std::min( k, strict.size() - 1 );
+
+        // Split the strict positions into k + 1 runs. A location with at most k wrong positions matches at least one run exactly. The
+        // bounds are indices into the strict positions.
+        const auto pieces = k + 1;
+        std::vector< std::size_t > bounds( pieces + 1 );
+
+        for ( std::size_t piece = 0; piece <= pieces; ++piece )
+            bounds[ piece ] = piece * strict.size() / pieces;
+
+        // Counts the wrong positions at the offset, giving up once there are more than the budget. A location is found by every piece that
+        // matches it, so it is only counted for the first of them, and nothing is returned for the other pieces.
+        const auto distance = [ & ]( std::size_t offset, std::size_t piece, std::size_t budget ) -> std::optional< std::size_t >
+        {
+            const auto data = buffer.data() + offset;
+            std::size_t result = 0;
+
+            for ( std::size_t current = 0; current < pieces; ++current )
+            {
+                // The piece that found the location matches it exactly.
+                if ( current == piece )
+                    continue;
+
+                const auto before = result;
+
+                for ( auto i = bounds[ current ]; i < bounds[ current + 1 ]; ++i )
+                {
+                    if ( !pattern.accepts( strict[ i ], data[ strict[ i ] ] ) )
+                        ++result;
+                }
+
+                if ( ( current < piece && result == before ) || result > budget )
+                    return std::nullopt;
+            }
+
+            return result;
+        };
+
+        const auto better = []( const approx_match_t& a, const approx_match_t& b )
+        { return a.distance != b.distance ? a.distance < b.distance : a.offset < b.offset; };
+
+        // The best matches so far, as a max-heap of at most `limit` entries, so the worst one is replaced first.
+        std::vector< approx_match_t > results;
+
+        for ( std::size_t piece = 0; piece < pieces; ++piece )
+        {
+            const auto first = strict[ bounds[ piece ] ];
+            const auto last = strict[ bounds[ piece + 1 ] - 1 ];
+
+            pattern_t run;
+
+            for ( auto i = first; i <= last; ++i )
+            {
+                run.atoms[ run.size++ ] = pattern.atoms[ i ];
+
+                if ( const auto set = pattern.class_of( i ) )
+                {
+                    run.classes[ run.class_count ] = *set;
+                    run.classes[ run.class_count++ ].position = i - first;
+                }
+            }
+
+            const compiled_pattern_t compiled_run( run );
+
+            for ( const auto hit : matches< algorithm_t::auto_t >( buffer, compiled_run ) )
+            {
+                if ( hit < first || hit - first + size > buffer.size() )
+                    continue;
+
+                const auto full = results.size() == limit;
+                const auto d = distance( hit - first, piece, full ? results.front().distance : k );
+
+                if ( !d )
+                    continue;
+
+                const approx_match_t match{ hit - first, *d };
+
+                if ( !full )
+                {
+                    results.push_back( match );
+                    std::push_heap( results.begin(), results.end(), better );
+                }
+                else if ( better( match, results.front() ) )
+                {
+                    std::pop_heap( results.begin(), results.end(), better );
+                    results.back() = match;
+                    std::push_heap( results.begin(), results.end(), better );
+                }
+            }
+        }
+
+        std::sort_heap( results.begin(), results.end(), better );
+
+        return results;
+    }
+
+    std::optional< string_match_t > scanner::find_string( std::span< std::uint8_t > buffer, std::string_view text, string_encoding_t encoding ) noexcept
+    {
+        const auto results = find_all_strings( buffer, text, encoding, 1 );
+
+        if ( results.empty() )
+            return std::nullopt;
+
+        return results.front();
+    }
+
+    std::vector< string_match_t >
+    scanner::find_all_strings( std::span< std::uint8_t > buffer, std::string_view text, string_encoding_t encoding, std::size_t limit ) noexcept
+    {
+        std::vector< string_match_t > results;
+
+        if ( text.empty() || buffer.size() < text.size() || limit == 0 || static_cast< std::uint8_t >( encoding ) == 0 )
+            return results;
+
+        const string_needle_t needle( text, encoding );
+
+#if defined( WINCPP_X86 )
+        switch ( core::simd_level() )
+        {
+            case core::simd_level_t::avx512_t: find_strings_avx512( needle, buffer, results, limit ); return results;
+            case core::simd_level_t::avx2_t: find_strings_avx2( needle, buffer, results, limit ); return results;
+            case core::simd_level_t::sse2_t: find_strings_sse2( needle, buffer, results, limit ); return results;
+            default: break;
+        }
+#endif
+
+        find_strings_scalar( needle, buffer, 0, results, limit );
+        return results;
+    }
+}  // namespace wincpp::patterns
@@ -0,0 +1,74 @@
+#include "wincpp/patterns/signature.hpp"
+
+#include <cstring>
+
+namespace wincpp::patterns
+{
+    std::optional< std::uintptr_t > signature_t::resolve( std::uintptr_t match, const reader_t& read ) const
+    {
+        auto cursor = match + static_cast< std::uintptr_t >( offset );
+
+        for ( std::size_t i = 0; i < step_count; ++i )
+        {
+            const auto [ type, value ] = steps[ i ];
+
+            switch ( type )
+            {
+                case step_t::type_t::rel32_t:
+                {
+                    std::int32_t displacement;
+
+                    if ( !read || !read( cursor, { reinterpret_cast< std::uint8_t* >( &displacement ), sizeof( displacement ) } ) )
+                        return std::nullopt;
+
+                    cursor += sizeof( displacement ) + static_cast< std::uintptr_t >( value ) + static_cast< std::uintptr_t >( displacement );
+                    break;
+                }
+                case step_t::type_t::rel8_t:
+                {
+                    std::int8_t displacement;
+
+                    if ( !read || !read( cursor, { reinterpret_cast< std::uint8_t* >( &displacement ), sizeof( displacement ) } ) )
+                        return std::nullopt;
+
+                    cursor += sizeof( displacement ) + static_cast< std::uintptr_t >( value ) + static_cast< std::uintptr_t >( displacement );
+                    break;
+                }
+                case step_t::type_t::deref_t:
+                {
+                    std::uintptr_t pointer;
+
+                    if ( !read || !read( cursor, { reinterpret_cast< std::uint8_t* >( &pointer ), sizeof( pointer ) } ) )
+                        return std::nullopt;
+
+                    cursor = pointer;
+                    break;
+                }
+                case step_t::type_t::add_t: cursor += static_cast< std::uintptr_t >( value ); break;
+            }
+        }
+
+        return cursor;
+    }
+
+    std::optional< std::uintptr_t > signature_t::resolve(
+        std::span< const std::uint8_t > buffer,
+        std::uintptr_t base,
+        std::uintptr_t location,
+        const reader_t& fallback ) const
+    {
+        // Operands almost always sit inside the match itself, so serve reads from the buffer and only go out for pointers that leave it.
+        return resolve(
+            base + location,
+            [ & ]( std::uintptr_t address, std::span< std::uint8_t > out )
+            {
+                if ( address >= base && address - base <= buffer.size() && out.size() <= buffer.size() - ( address - base ) )
+                {
+                    std::memcpy( out.data(), buffer.data() + ( address - base ), out.size() );
+                    return true;
+                }
+
+                return fallback && fallback( address, out );
+            } );
+    }
+}  // namespace wincpp::patterns
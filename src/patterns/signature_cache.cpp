@@ -0,0 +1,245 @@
+#include "wincpp/patterns/signature_cache.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <system_error>
+
+namespace wincpp::patterns
+{
+    namespace
+    {
+        // The first bytes of every cache file, followed by the format version.
+        constexpr std::uint32_t magic = 0x43534357;  // "WCSC"
+        constexpr std::uint32_t version = 1;
+
+        constexpr std::uint64_t multiplier = 0x9E3779B97F4A7C15;
+
+        constexpr std::uint64_t mix( std::uint64_t h, std::uint64_t word ) noexcept
+        {
+            h = ( h ^ word ) * multiplier;
+            return h ^ ( h >> 29 );
+        }
+
+        template< typename T >
+        void write( std::ofstream& out, const T& value )
+        {
+            out.write( reinterpret_cast< const char* >( &value ), sizeof( T ) );
+        }
+
+        template< typename T >
+        bool read( std::ifstream& in, T& value )
+        {
+            return static_cast< bool >( in.read( reinterpret_cast< char* >( &value ), sizeof( T ) ) );
+        }
+    }  // namespace
+
+    signature_cache::signature_cache( std::filesystem::path path, bool hash_code ) : _path( std::move( path ) ), _hash_code( hash_code )
+    {
+        load();
+    }
+
+    std::optional< std::uintptr_t >
+    signature_cache::lookup( std::string_view image, const image_fingerprint_t& fingerprint, const pattern_t& pattern ) const
+    {
+        const auto entry = images.find( std::string( image ) );
+
+        if ( entry == images.end() || entry->second.fingerprint != fingerprint )
+            return std::nullopt;
+
+        const auto offset = entry->second.offsets.find( key_of( pattern ) );
+
+        if ( offset == entry->second.offsets.end() )
+            return std::nullopt;
+
+        return static_cast< std::uintptr_t >( offset->second );
+    }
+
+    void signature_cache::store( std::string_view image, const image_fingerprint_t& fingerprint, const pattern_t& pattern, std::uintptr_t offset )
+    {
+        auto& entry = images[ std::string( image ) ];
+
+        if ( entry.fingerprint != fingerprint )
+        {
+            entry.fingerprint = fingerprint;
+            entry.offsets.clear();
+        }
+
+        entry.offsets[ key_of( pattern ) ] = offset;
+    }
+
+    bool signature_cache::load() noexcept
+    {
+        images.clear();
+
+        if ( _path.empty() )
+            return false;
+
+        try
+        {
+            std::ifstream in( _path, std::ios::binary );
+
+            if ( !in )
+                return false;
+
+            std::uint32_t file_magic, file_version, count;
+
+            if ( !read( in, file_magic ) || !read( in, file_version ) || !read( in, count ) || file_magic != magic || file_version != version )
+                return false;
+
+            // Bound every count by what is left of the file, so a corrupt count can't trigger a huge allocation.
+            std::error_code ec;
+            const auto file_size = std::filesystem::file_size( _path, ec );
+
+            if ( ec )
+                return false;
+
+            decltype( images ) loaded;
+
+            for ( std::uint32_t i = 0; i < count; ++i )
+            {
+                std::uint32_t name_size, offset_count;
+                image_t image;
+
+                if ( !read( in, name_size ) || name_size > file_size )
+                    return false;
+
+                std::string name( name_size, '\0' );
+
+                if ( !in.read( name.data(), name_size ) || !read( in, image.fingerprint.time_date_stamp ) ||
+                     !read( in, image.fingerprint.size_of_image ) || !read( in, image.fingerprint.checksum ) ||
+                     !read( in, image.fingerprint.code_hash ) || !read( in, offset_count ) ||
+                     offset_count > file_size / ( sizeof( std::uint64_t ) * 2 ) )
+                    return false;
+
+                image.offsets.reserve( offset_count );
+
+                for ( std::uint32_t j = 0; j < offset_count; ++j )
+                {
+                    std::uint64_t key, offset;
+
+                    if ( !read( in, key ) || !read( in, offset ) )
+                        return false;
+
+                    image.offsets.emplace( key, offset );
+                }
+
+                loaded.emplace( std::move( name ), std::move( image ) );
+            }
+
+            images = std::move( loaded );
+            return true;
+        }
+        catch ( ... )
+        {
+            return false;
+        }
+    }
+
+    bool signature_cache::save() const noexcept
+    {
+        if ( _path.empty() )
+            return false;
+
+        try
+        {
+            auto temporary = _path;
+            temporary += ".tmp";
+
+            {
+                std::ofstream out( temporary, std::ios::binary | std::ios::trunc );
+
+                if ( !out )
+                    return false;
+
+                write( out, magic );
+                write( out, version );
+                write( out, static_cast< std::uint32_t >( images.size() ) );
+
+                for ( const auto& [ name, image ] : images )
+                {
+                    write( out, static_cast< std::uint32_t >( name.size() ) );
+                    out.write( name.data(), static_cast< std::streamsize >( name.size() ) );
+
+                    write( out, image.fingerprint.time_date_stamp );
+                    write( out, image.fingerprint.size_of_image );
+                    write( out, image.fingerprint.checksum );
+                    write( out, image.fingerprint.code_hash );
+                    write( out, static_cast< std::uint32_t >( image.offsets.size() ) );
+
+                    for ( const auto& [ key, offset ] : image.offsets )
+                    {
+                        write( out, key );
+                        write( out, offset );
+                    }
+                }
+
+                if ( !out.flush() )
+                    return false;
+            }
+
+            std::error_code ec;
+            std::filesystem::rename( temporary, _path, ec );
+
+            return !ec;
+        }
+        catch ( ... )
+        {
+            return false;
+        }
+    }
+
+    void signature_cache::clear() noexcept
+    {
+        images.clear();
+    }
+
+    const std::filesystem::path& signature_cache::path() const noexcept
+    {
+        return _path;
+    }
+
+    bool signature_cache::hash_code() const noexcept
+    {
+        return _hash_code;
+    }
+
+    std::uint64_t signature_cache::hash( std::span< const std::uint8_t > data, std::uint64_t seed ) noexcept
+    {
+        auto h = mix( seed, data.size() );
+        std::size_t i = 0;
+
+        for ( ; i + sizeof( std::uint64_t ) <= data.size(); i += sizeof( std::uint64_t ) )
+        {
+            std::uint64_t word;
+            std::memcpy( &word, data.data() + i, sizeof( word ) );
+            h = mix( h, word );
+        }
+
+        if ( i < data.size() )
+        {
+            std::uint64_t word = 0;
+            std::memcpy( &word, data.data() + i, data.size() - i );
+            h = mix( h, word );
+        }
+
+        return h;
+    }
+
+    std::uint64_t signature_cache::key_of( const pattern_t& pattern ) noexcept
+    {
+        auto h = mix( 0, pattern.size );
+
+        for ( std::size_t i = 0; i < pattern.size; ++i )
+            h = mix( h, ( std::uint64_t( pattern.atoms[ i ].value ) << 8 ) | pattern.atoms[ i ].mask );
+
+        for ( std::size_t i = 0; i < pattern.class_count; ++i )
+        {
+            const auto& set = pattern.classes[ i ];
+
+            h = mix( h, set.position );
+            h = hash( { reinterpret_cast< const std::uint8_t* >( set.bits ), sizeof( set.bits ) }, h );
+        }
+
+        return h;
+    }
+}  // namespace wincpp::patterns
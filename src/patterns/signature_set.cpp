@@ -0,0 +1,271 @@
+#include "wincpp/patterns/signature_set.hpp"
+
+#include <algorithm>
+#include <queue>
+
+#include "wincpp/patterns/scanner.hpp"
+
+namespace wincpp::patterns
+{
+    signature_set::signature_set( std::initializer_list< pattern_t > patterns )
+        : signature_set( std::span< const pattern_t >( patterns.begin(), patterns.size() ) )
+    {
+    }
+
+    signature_set::signature_set( std::span< const pattern_t > patterns )
+        : signature_set( std::vector< signature_t >( patterns.begin(), patterns.end() ) )
+    {
+    }
+
+    signature_set::signature_set( std::initializer_list< signature_t > signatures )
+        : signature_set( std::span< const signature_t >( signatures.begin(), signatures.size() ) )
+    {
+    }
+
+    signature_set::signature_set( std::span< const signature_t > source ) : signatures( source.begin(), source.end() )
+    {
+        patterns.reserve( source.size() );
+        keys.reserve( source.size() );
+
+        for ( const auto& signature : source )
+        {
+            const auto& pattern = signature.pattern;
+
+            // Use the longest run of strict bytes as the key of the pattern. Nibbles and byte classes are left for the verification.
+            key_t key{ 0, 0 };
+
+            for ( std::size_t i = 0; i < pattern.size; )
+            {
+                if ( !pattern.literal( i ) )
+                {
+                    ++i;
+                    continue;
+                }
+
+                std::size_t j = i;
+
+                while ( j < pattern.size && pattern.literal( j ) )
+                    ++j;
+
+                if ( j - i > key.size )
+                    key = { i, j - i };
+
+                i = j;
+            }
+
+            key.size = std::min( key.size, max_key_size );
+
+            if ( key.size == 0 && pattern.size != 0 )
+                unkeyed.push_back( patterns.size() );
+
+            patterns.emplace_back( pattern );
+            keys.push_back( key );
+        }
+
+        // Build the trie. State 0 is the root, and a transition of 0 away from the root means there is no edge yet.
+        std::vector< std::vector< std::uint32_t > > terminals( 1 );
+        transitions.assign( 256, 0 );
+
+        for ( std::size_t id = 0; id < patterns.size(); ++id )
+        {
+            if ( keys[ id ].size == 0 )
+                continue;
+
+            std::uint32_t state = 0;
+
+            for ( std::size_t i = 0; i < keys[ id ].size; ++i )
+            {
+                const auto edge = state * 256 + patterns[ id ].value[ keys[ id ].offset + i ];
+
+                if ( !transitions[ edge ] )
+                {
+                    transitions[ edge ] = static_cast< std::uint32_t >( terminals.size() );
+                    terminals.emplace_back();
+                    transitions.resize( transitions.size() + 256, 0 );
+                }
+
+                state = transitions[ edge ];
+            }
+
+            terminals[ state ].push_back( static_cast< std::uint32_t >( id ) );
+        }
+
+        // Resolve the failure links breadth first, turning the trie into a complete DFA and merging the outputs of each failure state.
+        const auto states = terminals.size();
+
+        std::vector< std::uint32_t > failure( states, 0 );
+        std::vector< std::uint32_t > order;
+        std::queue< std::uint32_t > queue;
+
+        order.reserve( states );
+
+        for ( std::size_t byte = 0; byte < 256; ++byte )
+        {
+            if ( const auto next = transitions[ byte ] )
+                queue.push( next );
+        }
+
+        while ( !queue.empty() )
+        {
+            const auto state = queue.front();
+            queue.pop();
+            order.push_back( state );
+
+            for ( std::size_t byte = 0; byte < 256; ++byte )
+            {
+                auto& next = transitions[ state * 256 + byte ];
+                const auto fallback = transitions[ failure[ state ] * 256 + byte ];
+
+                if ( next )
+                {
+                    failure[ next ] = fallback;
+                    queue.push( next );
+                }
+                else
+                {
+                    next = fallback;
+                }
+            }
+        }
+
+        for ( const auto state : order )
+        {
+            const auto& inherited = terminals[ failure[ state ] ];
+            terminals[ state ].insert( terminals[ state ].end(), inherited.begin(), inherited.end() );
+        }
+
+        // Flatten the outputs so the scan loop only touches two arrays.
+        output_offsets.resize( states + 1 );
+
+        for ( std::size_t state = 0; state < states; ++state )
+        {
+            output_offsets[ state ] = static_cast< std::uint32_t >( outputs.size() );
+            outputs.insert( outputs.end(), terminals[ state ].begin(), terminals[ state ].end() );
+        }
+
+        output_offsets[ states ] = static_cast< std::uint32_t >( outputs.size() );
+    }
+
+    std::size_t signature_set::size() const noexcept
+    {
+        return patterns.size();
+    }
+
+    const compiled_pattern_t& signature_set::operator[]( std::size_t id ) const noexcept
+    {
+        return patterns[ id ];
+    }
+
+    const signature_t& signature_set::signature( std::size_t id ) const noexcept
+    {
+        return signatures[ id ];
+    }
+
+    template< typename callback_t >
+    void signature_set::scan( std::span< std::uint8_t > buffer, callback_t&& callback ) const noexcept
+    {
+        const auto data = buffer.data();
+        const auto size = buffer.size();
+
+        if ( transitions.empty() )
+            return;
+
+        std::uint32_t state = 0;
+
+        for ( std::size_t i = 0; i < size; ++i )
+        {
+            state = transitions[ state * 256 + data[ i ] ];
+
+            for ( auto o = output_offsets[ state ]; o < output_offsets[ state + 1 ]; ++o )
+            {
+                const auto id = outputs[ o ];
+                const auto& key = keys[ id ];
+                const auto& pattern = patterns[ id ];
+
+                // The key ends at i, so work out where the whole pattern would start.
+                const auto end = i + 1;
+
+                if ( end < key.offset + key.size )
+                    continue;
+
+                const auto start = end - key.size - key.offset;
+
+                if ( start + pattern.size() > size || !pattern.matches( data + start ) )
+                    continue;
+
+                if ( !callback( id, start ) )
+                    return;
+            }
+        }
+    }
+
+    std::vector< std::optional< std::uintptr_t > > signature_set::find( std::span< std::uint8_t > buffer ) const noexcept
+    {
+        std::vector< std::optional< std::uintptr_t > > results( patterns.size() );
+
+        // Only keyed patterns are found by the scan. Empty patterns never match, so counting them would keep the scan from stopping early.
+        auto remaining = static_cast< std::size_t >( std::ranges::count_if( keys, []( const key_t& key ) { return key.size != 0; } ) );
+
+        for ( const auto id : unkeyed )
+            results[ id ] = scanner::find< scanner::algorithm_t::auto_t >( buffer, patterns[ id ] );
+
+        if ( remaining == 0 )
+            return results;
+
+        // Every pattern has a single key, so the first verified hit of a pattern is also its lowest location.
+        scan(
+            buffer,
+            [ & ]( std::size_t id, std::uintptr_t offset )
+            {
+                if ( !results[ id ] )
+                {
+                    results[ id ] = offset;
+                    --remaining;
+                }
+
+                return remaining != 0;
+            } );
+
+        return results;
+    }
+
+    std::vector< signature_set::match_t > signature_set::find_all( std::span< std::uint8_t > buffer ) const noexcept
+    {
+        std::vector< match_t > results;
+
+        for ( const auto id : unkeyed )
+        {
+            for ( const auto offset : scanner::find_all< scanner::algorithm_t::auto_t >( buffer, patterns[ id ] ) )
+                results.push_back( { id, offset } );
+        }
+
+        scan(
+            buffer,
+            [ & ]( std::size_t id, std::uintptr_t offset )
+            {
+                results.push_back( { id, offset } );
+                return true;
+            } );
+
+        std::sort(
+            results.begin(),
+            results.end(),
+            []( const match_t& a, const match_t& b ) { return a.offset != b.offset ? a.offset < b.offset : a.id < b.id; } );
+
+        return results;
+    }
+
+    std::vector< std::optional< std::uintptr_t > >
+    signature_set::resolve( std::span< std::uint8_t > buffer, std::uintptr_t base, const signature_t::reader_t& fallback ) const
+    {
+        auto results = find( buffer );
+
+        for ( std::size_t id = 0; id < results.size(); ++id )
+        {
+            if ( results[ id ] )
+                results[ id ] = signatures[ id ].resolve( buffer, base, *results[ id ], fallback );
+        }
+
+        return results;
+    }
+}  // namespace wincpp::patterns
\ No newline at end of file
@@ -0,0 +1,299 @@
+#include "wincpp/patterns/strings.hpp"
+
+#include <algorithm>
+#include <bit>
+
+#include "wincpp/core/cpu.hpp"
+
+#if defined( WINCPP_X86 )
+#include <immintrin.h>
+#endif
+
+namespace wincpp::patterns
+{
+    namespace
+    {
+        /// <summary>
+        /// The masks of one 64-byte block. Bit `i` of `printable` is set if byte `i` is printable, and bit `i` of `wide` if it is also
+        /// followed by a zero, i.e. if it is a printable UTF-16LE character.
+        /// </summary>
+        struct block_t
+        {
+            std::uint64_t printable;
+            std::uint64_t wide;
+        };
+
+        constexpr bool printable( std::uint8_t byte ) noexcept
+        {
+            return ( byte >= 0x20 && byte <= 0x7E ) || byte == '\t';
+        }
+
+        /// <summary>
+        /// Classifies the block at the offset one byte at a time. Bytes past the end of the buffer are not printable.
+        /// </summary>
+        block_t classify_scalar( std::span< const std::uint8_t > buffer, std::size_t offset ) noexcept
+        {
+            block_t block{};
+
+            for ( std::size_t i = 0; i < 64 && offset + i < buffer.size(); ++i )
+            {
+                if ( !printable( buffer[ offset + i ] ) )
+                    continue;
+
+                block.printable |= std::uint64_t( 1 ) << i;
+
+                if ( offset + i + 1 < buffer.size() && buffer[ offset + i + 1 ] == 0 )
+                    block.wide |= std::uint64_t( 1 ) << i;
+            }
+
+            return block;
+        }
+
+#if defined( WINCPP_X86 )
+        // The kernels classify the `count` blocks from the start of the buffer, each of which must be followed by at least one more byte.
+        // Adding 0x60 maps [0x20, 0x7E] onto [-128, -34] as signed bytes and everything else above it, so one signed compare finds the
+        // printable range.
+
+        WINCPP_TARGET( "sse2" )
+        void classify_sse2( const std::uint8_t* data, std::size_t count, block_t* blocks ) noexcept
+        {
+            const auto bias = _mm_set1_epi8( 0x60 ), bound = _mm_set1_epi8( -33 ), tab = _mm_set1_epi8( '\t' ), zero = _mm_setzero_si128();
+
+            for ( std::size_t b = 0; b < count; ++b )
+            {
+                block_t block{};
+
+                for ( std::size_t k = 0; k < 64; k += 16 )
+                {
+                    const auto bytes = _mm_loadu_si128( reinterpret_cast< const __m128i* >( data + b * 64 + k ) );
+                    const auto next = _mm_loadu_si128( reinterpret_cast< const __m128i* >( data + b * 64 + k + 1 ) );
+                    const auto text = _mm_or_si128( _mm_cmpgt_epi8( bound, _mm_add_epi8( bytes, bias ) ), _mm_cmpeq_epi8( bytes, tab ) );
+
+                    block.printable |= static_cast< std::uint64_t >( static_cast< std::uint16_t >( _mm_movemask_epi8( text ) ) ) << k;
+                    block.wide |= static_cast< std::uint64_t >( static_cast< std::uint16_t >( _mm_movemask_epi8( _mm_and_si128( text, _mm_cmpeq_epi8( next, zero ) ) ) ) )
+                                  << k;
+                }
+
+                blocks[ b ] = block;
+            }
+        }
+
+        WINCPP_TARGET( "avx2" )
+        void classify_avx2( const std::uint8_t* data, std::size_t count, block_t* blocks ) noexcept
+        {
+            const auto bias = _mm256_set1_epi8( 0x60 ), bound = _mm256_set1_epi8( -33 ), tab = _mm256_set1_epi8( '\t' ), zero = _mm256_setzero_si256();
+
+            for ( std::size_t b = 0; b < count; ++b )
+            {
+                block_t block{};
+
+                for ( std::size_t k = 0; k < 64; k += 32 )
+                {
+                    const auto bytes = _mm256_loadu_si256( reinterpret_cast< const __m256i* >( data + b * 64 + k ) );
+                    const auto next = _mm256_loadu_si256( reinterpret_cast< const __m256i* >( data + b * 64 + k + 1 ) );
+                    const auto text = _mm256_or_si256( _mm256_cmpgt_epi8( bound, _mm256_add_epi8( bytes, bias ) ), _mm256_cmpeq_epi8( bytes, tab ) );
+
+                    block.printable |= static_cast< std::uint64_t >( static_cast< std::uint32_t >( _mm256_movemask_epi8( text ) ) ) << k;
+                    block.wide |=
+                        static_cast< std::uint64_t >( static_cast< std::uint32_t >( _mm256_movemask_epi8( _mm256_and_si256( text, _mm256_cmpeq_epi8( next, zero ) ) ) ) )
+                        << k;
+                }
+
+                blocks[ b ] = block;
+            }
+        }
+
+        WINCPP_TARGET( "avx512f,avx512bw" )
+        void classify_avx512( const std::uint8_t* data, std::size_t count, block_t* blocks ) noexcept
+        {
+            const auto bias = _mm512_set1_epi8( 0x60 ), bound = _mm512_set1_epi8( -33 ), tab = _mm512_set1_epi8( '\t' ), zero = _mm512_setzero_si512();
+
+            for ( std::size_t b = 0; b < count; ++b )
+            {
+                const auto bytes = _mm512_loadu_si512( data + b * 64 );
+                const auto next = _mm512_loadu_si512( data + b * 64 + 1 );
+                const auto text = _mm512_cmpgt_epi8_mask( bound, _mm512_add_epi8( bytes, bias ) ) | _mm512_cmpeq_epi8_mask( bytes, tab );
+
+                blocks[ b ] = { text, text & _mm512_cmpeq_epi8_mask( next, zero ) };
+            }
+        }
+#endif
+
+        /// <summary>
+        /// Classifies the blocks of the buffer from `first` on, with the widest kernel the CPU supports for the blocks it can load in full.
+        /// </summary>
+        void classify( std::span< const std::uint8_t > buffer, std::size_t first, std::size_t count, block_t* blocks ) noexcept
+        {
+            std::size_t done = 0;
+
+#if defined( WINCPP_X86 )
+            // A block can be loaded in full if the byte after it is in the buffer too.
+            const auto loadable = buffer.size() > first * 64 ? std::min( count, ( buffer.size() - first * 64 - 1 ) / 64 ) : 0;
+            const auto data = buffer.data() + first * 64;
+
+            switch ( core::simd_level() )
+            {
+                case core::simd_level_t::avx512_t: classify_avx512( data, loadable, blocks ), done = loadable; break;
+                case core::simd_level_t::avx2_t: classify_avx2( data, loadable, blocks ), done = loadable; break;
+                case core::simd_level_t::sse2_t: classify_sse2( data, loadable, blocks ), done = loadable; break;
+                default: break;
+            }
+#endif
+
+            for ( ; done < count; ++done )
+                blocks[ done ] = classify_scalar( buffer, ( first + done ) * 64 );
+        }
+
+        /// <summary>
+        /// Follows the runs of set bits in a lane of the masks across blocks. The lane is every bit for ASCII, and every other bit for
+        /// UTF-16LE, where a character takes two positions.
+        /// </summary>
+        struct run_tracker_t
+        {
+            std::uint64_t lane;
+            std::size_t stride;
+            std::size_t min_length;
+            bool open = false;
+            std::size_t start = 0;
+
+            /// <summary>
+            /// Consumes the bits of the lane in the block at `base`, and calls the callback with the start and end of every run that ends in
+            /// it and may be long enough.
+            /// </summary>
+            template< typename callback_t >
+            void consume( std::uint64_t mask, std::size_t base, callback_t&& callback )
+            {
+                mask &= lane;
+
+                // Nothing changes in a block that is entirely inside or entirely outside of a run.
+                if ( mask == ( open ? lane : 0 ) )
+                    return;
+
+                std::size_t position = 0;
+
+                if ( open )
+                {
+                    position = std::countr_zero( ~mask & lane );
+                    callback( start, base + position );
+                    open = false;
+                }
+
+                // Erode the mask so that only the starts of runs of at least `min_length` characters survive, counting the bits past the
+                // block as set so that runs which may continue into the next block survive too. Code is full of short printable runs, and
+                // this skips them without visiting each. The window doubles each step, so it takes a handful of shifts at most.
+                auto starts = mask;
+
+                for ( std::size_t covered = 1, target = std::min( min_length, 64 / stride ); covered < target; )
+                {
+                    const auto step = std::min( covered, target - covered );
+                    const auto shift = step * stride;
+
+                    starts &= ( starts >> shift ) | ~( ~std::uint64_t( 0 ) >> shift );
+                    covered += step;
+                }
+
+                starts &= ~std::uint64_t( 0 ) << position;
+
+                while ( starts )
+                {
+                    const auto first = static_cast< std::size_t >( std::countr_zero( starts ) );
+                    const auto rest = ( ~mask & lane ) >> first;
+
+                    if ( rest == 0 )
+                    {
+                        start = base + first;
+                        open = true;
+                        return;
+                    }
+
+                    const auto last = first + std::countr_zero( rest );
+                    callback( base + first, base + last );
+
+                    starts &= ~std::uint64_t( 0 ) << last;
+                }
+            }
+
+            /// <summary>
+            /// Closes a run that reaches the end of the buffer.
+            /// </summary>
+            template< typename callback_t >
+            void finish( std::size_t size, callback_t&& callback )
+            {
+                if ( open )
+                    callback( start, size + ( ( size - start ) % stride ) );
+
+                open = false;
+            }
+        };
+    }  // namespace
+
+    std::vector< extracted_string_t >
+    extract_strings( std::span< const std::uint8_t > buffer, std::size_t min_length, string_encoding_t encoding ) noexcept
+    {
+        std::vector< extracted_string_t > results;
+
+        const auto want_ascii = ( static_cast< std::uint8_t >( encoding ) & static_cast< std::uint8_t >( string_encoding_t::ascii_nocase_t ) ) != 0;
+        const auto want_wide = ( static_cast< std::uint8_t >( encoding ) & static_cast< std::uint8_t >( string_encoding_t::utf16le_t ) ) != 0;
+
+        min_length = std::max< std::size_t >( min_length, 1 );
+
+        run_tracker_t ascii{ ~std::uint64_t( 0 ), 1, min_length }, even{ 0x5555555555555555, 2, min_length }, odd{ 0xAAAAAAAAAAAAAAAA, 2, min_length };
+
+        // The runs of each lane end in ascending order, but runs of different lanes interleave, so they are sorted once at the end.
+        const auto emit_ascii = [ & ]( std::size_t start, std::size_t end )
+        {
+            if ( end - start >= min_length )
+                results.push_back( { start, string_encoding_t::ascii_nocase_t, std::string( buffer.begin() + start, buffer.begin() + end ) } );
+        };
+
+        const auto emit_wide = [ & ]( std::size_t start, std::size_t end )
+        {
+            const auto length = ( end - start ) / 2;
+
+            if ( length < min_length )
+                return;
+
+            std::string text( length, '\0' );
+
+            for ( std::size_t i = 0; i < length; ++i )
+                text[ i ] = static_cast< char >( buffer[ start + i * 2 ] );
+
+            results.push_back( { start, string_encoding_t::utf16le_t, std::move( text ) } );
+        };
+
+        // Classify a batch of blocks at a time, so the kernels run over a few KiB without branching into the run tracking.
+        constexpr std::size_t batch = 64;
+        block_t blocks[ batch ];
+
+        const auto total = ( buffer.size() + 63 ) / 64;
+
+        for ( std::size_t first = 0; first < total; first += batch )
+        {
+            const auto count = std::min( batch, total - first );
+            classify( buffer, first, count, blocks );
+
+            for ( std::size_t b = 0; b < count; ++b )
+            {
+                const auto base = ( first + b ) * 64;
+
+                if ( want_ascii )
+                    ascii.consume( blocks[ b ].printable, base, emit_ascii );
+
+                if ( want_wide )
+                {
+                    even.consume( blocks[ b ].wide, base, emit_wide );
+                    odd.consume( blocks[ b ].wide, base, emit_wide );
+                }
+            }
+        }
+
+        ascii.finish( buffer.size(), emit_ascii );
+        even.finish( buffer.size(), emit_wide );
+        odd.finish( buffer.size(), emit_wide );
+
+        std::stable_sort(
+            results.begin(), results.end(), []( const extracted_string_t& a, const extracted_string_t& b ) { return a.offset < b.offset; } );
+
+        return results;
+    }
+}  // namespace wincpp::patterns
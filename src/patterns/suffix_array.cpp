@@ -0,0 +1,317 @@
+#include "wincpp/patterns/suffix_array.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#include "wincpp/core/error.hpp"
+#include "wincpp/patterns/scanner.hpp"
+
+namespace wincpp::patterns
+{
+    namespace
+    {
+        /// <summary>
+        /// Sorts the suffixes of a string over the alphabet [0, upper] by induced sorting (Nong, Zhang and Chan). The LMS substrings are
+        /// sorted by one induction pass, named, and sorted recursively if their names aren't unique; a second pass then induces the rest.
+        /// </summary>
+        template< typename char_t >
+        std::vector< std::int32_t > sa_is( const char_t* s, std::int32_t n, std::int32_t upper )
+        {
+            if ( n == 0 )
+                return {};
+
+            // Small inputs aren't worth the bookkeeping.
+            if ( n < 16 )
+            {
+                std::vector< std::int32_t > sa( n );
+
+                for ( std::int32_t i = 0; i < n; ++i )
+                    sa[ i ] = i;
+
+                std::sort(
+                    sa.begin(),
+                    sa.end(),
+                    [ & ]( std::int32_t a, std::int32_t b )
+                    {
+                        while ( a < n && b < n && s[ a ] == s[ b ] )
+                            ++a, ++b;
+
+                        return b < n && ( a == n || s[ a ] < s[ b ] );
+                    } );
+
+                return sa;
+            }
+
+            std::vector< std::int32_t > sa( n );
+            std::vector< bool > ls( n );
+
+            // ls[ i ] is true if the suffix at i is an S-type suffix, i.e. smaller than the suffix after it.
+            for ( auto i = n - 2; i >= 0; --i )
+                ls[ i ] = s[ i ] == s[ i + 1 ] ? ls[ i + 1 ] : s[ i ] < s[ i + 1 ];
+
+            // The start of the L-type and S-type parts of every bucket.
+            std::vector< std::int32_t > sum_l( upper + 1 ), sum_s( upper + 1 );
+
+            for ( std::int32_t i = 0; i < n; ++i )
+            {
+                if ( !ls[ i ] )
+                    ++sum_s[ s[ i ] ];
+                else
+                    ++sum_l[ s[ i ] + 1 ];
+            }
+
+            for ( std::int32_t i = 0; i <= upper; ++i )
+            {
+                sum_s[ i ] += sum_l[ i ];
+
+                if ( i < upper )
+                    sum_l[ i + 1 ] += sum_s[ i ];
+            }
+
+            const auto induce = [ & ]( const std::vector< std::int32_t >& lms )
+            {
+                std::fill( sa.begin(), sa.end(), -1 );
+                std::vector< std::int32_t > buf( sum_s );
+
+                for ( const auto d : lms )
+                {
+                    if ( d != n )
+                        sa[ buf[ s[ d ] ]++ ] = d;
+                }
+
+                buf = sum_l;
+                sa[ buf[ s[ n - 1 ] ]++ ] = n - 1;
+
+                for ( std::int32_t i = 0; i < n; ++i )
+                {
+                    const auto v = sa[ i ];
+
+                    if ( v >= 1 && !ls[ v - 1 ] )
+                        sa[ buf[ s[ v - 1 ] ]++ ] = v - 1;
+                }
+
+                buf = sum_l;
+
+                for ( auto i = n - 1; i >= 0; --i )
+                {
+                    const auto v = sa[ i ];
+
+                    if ( v >= 1 && ls[ v - 1 ] )
+                        sa[ --buf[ s[ v - 1 ] + 1 ] ] = v - 1;
+                }
+            };
+
+            std::vector< std::int32_t > lms_map( n + 1, -1 ), lms;
+            std::int32_t m = 0;
+
+            for ( std::int32_t i = 1; i < n; ++i )
+            {
+                if ( !ls[ i - 1 ] && ls[ i ] )
+                    lms_map[ i ] = m++;
+            }
+
+            lms.reserve( m );
+
+            for ( std::int32_t i = 1; i < n; ++i )
+            {
+                if ( !ls[ i - 1 ] && ls[ i ] )
+                    lms.push_back( i );
+            }
+
+            induce( lms );
+
+            if ( m )
+            {
+                std::vector< std::int32_t > sorted_lms;
+                sorted_lms.reserve( m );
+
+                for ( const auto v : sa )
+                {
+                    if ( lms_map[ v ] != -1 )
+                        sorted_lms.push_back( v );
+                }
+
+                // Name the LMS substrings in sorted order; equal substrings share a name.
+                std::vector< std::int32_t > rec_s( m );
+                std::int32_t rec_upper = 0;
+
+                rec_s[ lms_map[ sorted_lms[ 0 ] ] ] = 0;
+
+                for ( std::int32_t i = 1; i < m; ++i )
+                {
+                    auto l = sorted_lms[ i - 1 ], r = sorted_lms[ i ];
+
+                    const auto end_l = lms_map[ l ] + 1 < m ? lms[ lms_map[ l ] + 1 ] : n;
+                    const auto end_r = lms_map[ r ] + 1 < m ? lms[ lms_map[ r ] + 1 ] : n;
+
+                    bool same = true;
+
+                    if ( end_l - l != end_r - r )
+                    {
+                        same = false;
+                    }
+                    else
+                    {
+                        while ( l < end_l && s[ l ] == s[ r ] )
+                            ++l, ++r;
+
+                        if ( l == n || r == n || s[ l ] != s[ r ] )
+                            same = false;
+                    }
+
+                    if ( !same )
+                        ++rec_upper;
+
+                    rec_s[ lms_map[ sorted_lms[ i ] ] ] = rec_upper;
+                }
+
+                lms_map = {};
+
+                const auto rec_sa = sa_is( rec_s.data(), m, rec_upper );
+
+                for ( std::int32_t i = 0; i < m; ++i )
+                    sorted_lms[ i ] = lms[ rec_sa[ i ] ];
+
+                induce( sorted_lms );
+            }
+
+            return sa;
+        }
+    }  // namespace
+
+    suffix_array_t::suffix_array_t( std::vector< std::uint8_t > text ) : _text( std::move( text ) ), _suffixes( build( _text ) )
+    {
+    }
+
+    std::span< const std::uint8_t > suffix_array_t::text() const noexcept
+    {
+        return _text;
+    }
+
+    std::span< const std::uint32_t > suffix_array_t::suffixes() const noexcept
+    {
+        return _suffixes;
+    }
+
+    std::vector< std::uint32_t > suffix_array_t::build( std::span< const std::uint8_t > text )
+    {
+        // SA-IS works on 32-bit positions, so a larger buffer would be sorted as a truncated prefix of itself.
+        if ( text.size() > static_cast< std::size_t >( std::numeric_limits< std::int32_t >::max() ) )
+            throw core::error::from_user( core::user_error_type_t::buffer_too_large_t, "The buffer of {} bytes is too large to index", text.size() );
+
+        const auto sa = sa_is( text.data(), static_cast< std::int32_t >( text.size() ), 255 );
+        return std::vector< std::uint32_t >( sa.begin(), sa.end() );
+    }
+
+    std::pair< std::size_t, std::size_t > suffix_array_t::range( std::span< const std::uint8_t > needle ) const noexcept
+    {
+        // Compares the suffix against the needle, treating a suffix that begins with the needle as equal.
+        const auto compare = [ & ]( std::uint32_t suffix ) -> int
+        {
+            const auto available = _text.size() - suffix;
+            const auto length = std::min( available, needle.size() );
+
+            if ( const auto result = std::memcmp( _text.data() + suffix, needle.data(), length ) )
+                return result;
+
+            return available < needle.size() ? -1 : 0;
+        };
+
+        const auto first = std::partition_point( _suffixes.begin(), _suffixes.end(), [ & ]( std::uint32_t s ) { return compare( s ) < 0; } );
+        const auto last = std::partition_point( first, _suffixes.end(), [ & ]( std::uint32_t s ) { return compare( s ) == 0; } );
+
+        return { static_cast< std::size_t >( first - _suffixes.begin() ), static_cast< std::size_t >( last - _suffixes.begin() ) };
+    }
+
+    template< typename callback_t >
+    void suffix_array_t::visit( const compiled_pattern_t& pattern, callback_t&& callback ) const noexcept
+    {
+        const auto size = pattern.size();
+
+        if ( size == 0 || size > _text.size() )
+            return;
+
+        // Look up the longest run of strict bytes, and verify the rest of the pattern around each of its occurrences.
+        std::size_t offset = 0, length = 0;
+
+        for ( std::size_t i = 0; i < size; )
+        {
+            if ( !pattern.pattern.literal( i ) )
+            {
+                ++i;
+                continue;
+            }
+
+            auto j = i;
+
+            while ( j < size && pattern.pattern.literal( j ) )
+                ++j;
+
+            if ( j - i > length )
+                offset = i, length = j - i;
+
+            i = j;
+        }
+
+        if ( length == 0 )
+        {
+            // Without a strict byte there is nothing to look up, so fall back to a scan.
+            const std::span< std::uint8_t > buffer( const_cast< std::uint8_t* >( _text.data() ), _text.size() );
+
+            for ( const auto location : scanner::matches< scanner::algorithm_t::auto_t >( buffer, pattern ) )
+            {
+                if ( !callback( location ) )
+                    return;
+            }
+
+            return;
+        }
+
+        const auto [ first, last ] = range( { pattern.value.data() + offset, length } );
+
+        for ( auto i = first; i < last; ++i )
+        {
+            const std::size_t suffix = _suffixes[ i ];
+
+            if ( suffix < offset || suffix - offset + size > _text.size() )
+                continue;
+
+            const auto location = suffix - offset;
+
+            if ( pattern.matches( _text.data() + location ) && !callback( location ) )
+                return;
+        }
+    }
+
+    std::size_t suffix_array_t::count( const pattern_t& pattern, std::size_t limit ) const noexcept
+    {
+        std::size_t result = 0;
+
+        if ( limit == 0 )
+            return result;
+
+        visit( compiled_pattern_t( pattern ), [ & ]( std::uintptr_t ) { return ++result < limit; } );
+
+        return result;
+    }
+
+    std::vector< std::uintptr_t > suffix_array_t::locate( const pattern_t& pattern, std::size_t limit ) const noexcept
+    {
+        std::vector< std::uintptr_t > results;
+
+        if ( limit == 0 )
+            return results;
+
+        visit(
+            compiled_pattern_t( pattern ),
+            [ & ]( std::uintptr_t location )
+            {
+                results.push_back( location );
+                return results.size() < limit;
+            } );
+
+        std::sort( results.begin(), results.end() );
+        return results;
+    }
+}  // namespace wincpp::patterns
@@ -0,0 +1,928 @@
+#include "wincpp/patterns/values.hpp"
+
+#include <algorithm>
+#include <bit>
+
+#include "wincpp/core/cpu.hpp"
+#include "wincpp/core/error.hpp"
+
+#if defined( WINCPP_X86 )
+#include <immintrin.h>
+#endif
+
+namespace wincpp::patterns
+{
+    namespace
+    {
+        /// <summary>
+        /// Calls the function with a `std::type_identity` of the C++ type of the value type.
+        /// </summary>
+        template< typename function_t >
+        decltype( auto ) with_type( value_type_t type, function_t&& function )
+        {
+            switch ( type )
+            {
+                case value_type_t::i8_t: return function( std::type_identity< std::int8_t >{} );
+                case value_type_t::u8_t: return function( std::type_identity< std::uint8_t >{} );
+                case value_type_t::i16_t: return function( std::type_identity< std::int16_t >{} );
+                case value_type_t::u16_t: return function( std::type_identity< std::uint16_t >{} );
+                case value_type_t::i32_t: return function( std::type_identity< std::int32_t >{} );
+                case value_type_t::u32_t: return function( std::type_identity< std::uint32_t >{} );
+                case value_type_t::i64_t: return function( std::type_identity< std::int64_t >{} );
+                case value_type_t::u64_t: return function( std::type_identity< std::uint64_t >{} );
+                case value_type_t::f32_t: return function( std::type_identity< float >{} );
+                default: return function( std::type_identity< double >{} );
+            }
+        }
+
+        template< typename T >
+        T value_of( std::uint64_t bits ) noexcept
+        {
+            T value;
+            std::memcpy( &value, &bits, sizeof( T ) );
+            return value;
+        }
+
+        /// <summary>
+        /// Collects the matches of the kernels, and drops the ones that aren't aligned.
+        /// </summary>
+        struct collector_t
+        {
+            /// <summary>
+            /// Adds the match at the offset.
+            /// </summary>
+            /// <returns>False once the limit is reached.</returns>
+            bool add( std::size_t offset )
+            {
+                if ( offset & misaligned )
+                    return true;
+
+                results.push_back( offset );
+                return results.size() < limit;
+            }
+
+            /// <summary>
+            /// Adds the matches whose bits are set in the mask, where bit `i` stands for the byte offset `base + i * scale`.
+            /// </summary>
+            /// <returns>False once the limit is reached.</returns>
+            bool add( std::uint64_t mask, std::size_t base, std::size_t scale )
+            {
+                for ( ; mask; mask &= mask - 1 )
+                {
+                    if ( !add( base + std::countr_zero( mask ) * scale ) )
+                        return false;
+                }
+
+                return true;
+            }
+
+            std::vector< std::uintptr_t >& results;
+            std::size_t limit;
+
+            // The bits of an offset that must be clear for the alignment.
+            std::size_t misaligned;
+        };
+
+        // Every kernel compares the values at the offsets `0, step, 2 * step, ...` of the buffer, where the step is the alignment or the size of
+        // the type, whichever is smaller. Values wider than the step are found by loading each vector once per step within a value, and
+        // merging the masks by their offset, so the matches come out in order and the buffer is only read once. A narrower alignment is left
+        // to the collector. The kernels leave the end of the buffer that doesn't fill a vector to the scalar kernel.
+        //
+        // Integers are compared as `value - low <= high - low` in unsigned arithmetic, which holds for signed and unsigned types alike.
+
+        template< typename T >
+        bool find_scalar( const std::uint8_t* data, std::size_t first, std::size_t size, std::size_t step, T low, T high, collector_t& collector ) noexcept
+        {
+            const auto inside = [ & ]( std::size_t offset )
+            {
+                T value;
+                std::memcpy( &value, data + offset, sizeof( T ) );
+
+                if constexpr ( std::is_integral_v< T > )
+                {
+                    using U = std::make_unsigned_t< T >;
+                    return static_cast< U >( U( value ) - U( low ) ) <= static_cast< U >( U( high ) - U( low ) );
+                }
+                else
+                    return low <= value && value <= high;
+            };
+
+            // A constant stride lets the compiler unroll and vectorize the common, aligned case.
+            if ( step == sizeof( T ) )
+            {
+                for ( auto offset = first; offset + sizeof( T ) <= size; offset += sizeof( T ) )
+                {
+                    if ( inside( offset ) && !collector.add( offset ) )
+                        return false;
+                }
+            }
+            else
+            {
+                for ( auto offset = first; offset + sizeof( T ) <= size; offset += step )
+                {
+                    if ( inside( offset ) && !collector.add( offset ) )
+                        return false;
+                }
+            }
+
+            return true;
+        }
+
+#if defined( WINCPP_X86 )
+        // Before AVX-512 there is only a signed integer compare, so both sides of the unsigned one are flipped by the sign bit. The masks have a
+        // bit per byte, of which only the one of the first byte of each value is kept.
+
+        template< typename T >
+        using bits_t = std::conditional_t< sizeof( T ) == 1, std::uint8_t, std::conditional_t< sizeof( T ) == 2, std::uint16_t, std::conditional_t< sizeof( T ) == 4, std::uint32_t, std::uint64_t > > >;
+
+        template< typename T >
+        constexpr bits_t< T > sign_bit = static_cast< bits_t< T > >( bits_t< T >( 1 ) << ( sizeof( T ) * 8 - 1 ) );
+
+        template< typename T >
+        constexpr std::uint64_t lane_starts = sizeof( T ) == 1   ? 0xFFFFFFFFFFFFFFFF
+                                              : sizeof( T ) == 2 ? 0x5555555555555555
+                                              : sizeof( T ) == 4 ? 0x1111111111111111
+                                                                 : 0x0101010101010101;
+
+        // The bounds of a query in vector registers: the low bound, the sign bit and the flipped span for integers, and the low and high bound
+        // for floating point.
+
+        struct bounds_sse2_t
+        {
+            __m128i low, flip, span;
+        };
+
+        struct bounds_avx2_t
+        {
+            __m256i low, flip, span;
+        };
+
+        template< typename T >
+        WINCPP_TARGET( "sse2" )
+        __m128i broadcast_sse2( T value ) noexcept
+        {
+            if constexpr ( std::is_same_v< T, float > )
+                return _mm_castps_si128( _mm_set1_ps( value ) );
+            else if constexpr ( std::is_same_v< T, double > )
+                return _mm_castpd_si128( _mm_set1_pd( value ) );
+            else if constexpr ( sizeof( T ) == 1 )
+                return _mm_set1_epi8( static_cast< char >( value ) );
+            else if constexpr ( sizeof( T ) == 2 )
+                return _mm_set1_epi16( static_cast< short >( value ) );
+            else
+                return _mm_set1_epi32( static_cast< int >( value ) );
+        }
+
+        template< typename T >
+        WINCPP_TARGET( "sse2" )
+        bounds_sse2_t bounds_sse2( T low, T high ) noexcept
+        {
+            if constexpr ( std::is_floating_point_v< T > )
+                return { broadcast_sse2( low ), _mm_setzero_si128(), broadcast_sse2( high ) };
+            else
+            {
+                using U = bits_t< T >;
+                return { broadcast_sse2( U( low ) ), broadcast_sse2( sign_bit< T > ), broadcast_sse2( U( U( U( high ) - U( low ) ) ^ sign_bit< T > ) ) };
+            }
+        }
+
+        template< typename T >
+        WINCPP_TARGET( "sse2" )
+        std::uint32_t inside_sse2( const std::uint8_t* data, const bounds_sse2_t& bounds ) noexcept
+        {
+            if constexpr ( std::is_same_v< T, float > )
+            {
+                const auto value = _mm_loadu_ps( reinterpret_cast< const float* >( data ) );
+                return _mm_movemask_epi8( _mm_castps_si128(
+                    _mm_and_ps( _mm_cmpge_ps( value, _mm_castsi128_ps( bounds.low ) ), _mm_cmple_ps( value, _mm_castsi128_ps( bounds.span ) ) ) ) );
+            }
+            else if constexpr ( std::is_same_v< T, double > )
+            {
+                const auto value = _mm_loadu_pd( reinterpret_cast< const double* >( data ) );
+                return _mm_movemask_epi8( _mm_castpd_si128(
+                    _mm_and_pd( _mm_cmpge_pd( value, _mm_castsi128_pd( bounds.low ) ), _mm_cmple_pd( value, _mm_castsi128_pd( bounds.span ) ) ) ) );
+            }
+            else
+            {
+                const auto value = _mm_loadu_si128( reinterpret_cast< const __m128i* >( data ) );
+                __m128i outside;
+
+                if constexpr ( sizeof( T ) == 1 )
+                    outside = _mm_cmpgt_epi8( _mm_xor_si128( _mm_sub_epi8( value, bounds.low ), bounds.flip ), bounds.span );
+                else if constexpr ( sizeof( T ) == 2 )
+                    outside = _mm_cmpgt_epi16( _mm_xor_si128( _mm_sub_epi16( value, bounds.low ), bounds.flip ), bounds.span );
+                else
+                    outside = _mm_cmpgt_epi32( _mm_xor_si128( _mm_sub_epi32( value, bounds.low ), bounds.flip ), bounds.span );
+
+                return ~_mm_movemask_epi8( outside ) & 0xFFFF;
+            }
+        }
+
+        template< typename T >
+        WINCPP_TARGET( "sse2" )
+        bool find_sse2( const std::uint8_t* data, std::size_t size, std::size_t step, T low, T high, collector_t& collector ) noexcept
+        {
+            const auto bounds = bounds_sse2( low, high );
+
+            std::size_t i = 0;
+
+            for ( ; i + 16 + sizeof( T ) - 1 <= size; i += 16 )
+            {
+                std::uint64_t mask = 0;
+
+                for ( std::size_t shift = 0; shift < sizeof( T ); shift += step )
+                    mask |= ( inside_sse2< T >( data + i + shift, bounds ) & lane_starts< T > ) << shift;
+
+                if ( mask && !collector.add( mask, i, 1 ) )
+                    return false;
+            }
+
+            return find_scalar( data, i, size, step, low, high, collector );
+        }
+
+        template< typename T >
+        WINCPP_TARGET( "avx2" )
+        __m256i broadcast_avx2( T value ) noexcept
+        {
+            if constexpr ( std::is_same_v< T, float > )
+                return _mm256_castps_si256( _mm256_set1_ps( value ) );
+            else if constexpr ( std::is_same_v< T, double > )
+                return _mm256_castpd_si256( _mm256_set1_pd( value ) );
+            else if constexpr ( sizeof( T ) == 1 )
+                return _mm256_set1_epi8( static_cast< char >( value ) );
+            else if constexpr ( sizeof( T ) == 2 )
+                return _mm256_set1_epi16( static_cast< short >( value ) );
+            else if constexpr ( sizeof( T ) == 4 )
+                return _mm256_set1_epi32( static_cast< int >( value ) );
+            else
+                return _mm256_set1_epi64x( static_cast< long long >( value ) );
+        }
+
+        template< typename T >
+        WINCPP_TARGET( "avx2" )
+        bounds_avx2_t bounds_avx2( T low, T high ) noexcept
+        {
+            if constexpr ( std::is_floating_point_v< T > )
+                return { broadcast_avx2( low ), _mm256_setzero_si256(), broadcast_avx2( high ) };
+            else
+            {
+                using U = bits_t< T >;
+                return { broadcast_avx2( U( low ) ), broadcast_avx2( sign_bit< T > ), broadcast_avx2( U( U( U( high ) - U( low ) ) ^ sign_bit< T > ) ) };
+            }
+        }
+
+        template< typename T >
+        WINCPP_TARGET( "avx2" )
+        std::uint32_t inside_avx2( const std::uint8_t* data, const bounds_avx2_t& bounds ) noexcept
+        {
+            if constexpr ( std::is_same_v< T, float > )
+            {
+                const auto value = _mm256_loadu_ps( reinterpret_cast< const float* >( data ) );
+                return _mm256_movemask_epi8( _mm256_castps_si256( _mm256_and_ps( _mm256_cmp_ps( value, _mm256_castsi256_ps( bounds.low ), _CMP_GE_OQ ),
+                                                                                   _mm256_cmp_ps( value, _mm256_castsi256_ps( bounds.span ), _CMP_LE_OQ ) ) ) );
+            }
+            else if constexpr ( std::is_same_v< T, double > )
+            {
+                const auto value = _mm256_loadu_pd( reinterpret_cast< const double* >( data ) );
+                return _mm256_movemask_epi8( _mm256_castpd_si256( _mm256_and_pd( _mm256_cmp_pd( value, _mm256_castsi256_pd( bounds.low ), _CMP_GE_OQ ),
+                                                                                   _mm256_cmp_pd( value, _mm256_castsi256_pd( bounds.span ), _CMP_LE_OQ ) ) ) );
+            }
+            else
+            {
+                const auto value = _mm256_loadu_si256( reinterpret_cast< const __m256i* >( data ) );
+                __m256i outside;
+
+                if constexpr ( sizeof( T ) == 1 )
+                    outside = _mm256_cmpgt_epi8( _mm256_xor_si256( _mm256_sub_epi8( value, bounds.low ), bounds.flip ), bounds.span );
+                else if constexpr ( sizeof( T ) == 2 )
+                    outside = _mm256_cmpgt_epi16( _mm256_xor_si256( _mm256_sub_epi16( value, bounds.low ), bounds.flip ), bounds.span );
+                else if constexpr ( sizeof( T ) == 4 )
+                    outside = _mm256_cmpgt_epi32( _mm256_xor_si256( _mm256_sub_epi32( value, bounds.low ), bounds.flip ), bounds.span );
+                else
+                    outside = _mm256_cmpgt_epi64( _mm256_xor_si256( _mm256_sub_epi64( value, bounds.low ), bounds.flip ), bounds.span );
+
+                return ~static_cast< std::uint32_t >( _mm256_movemask_epi8( outside ) );
+            }
+        }
+
+        template< typename T >
+        WINCPP_TARGET( "avx2" )
+        bool find_avx2( const std::uint8_t* data, std::size_t size, std::size_t step, T low, T high, collector_t& collector ) noexcept
+        {
+            const auto bounds = bounds_avx2( low, high );
+
+            std::size_t i = 0;
+
+            for ( ; i + 32 + sizeof( T ) - 1 <= size; i += 32 )
+            {
+                std::uint64_t mask = 0;
+
+                for ( std::size_t shift = 0; shift < sizeof( T ); shift += step )
+                    mask |= ( inside_avx2< T >( data + i + shift, bounds ) & lane_starts< T > ) << shift;
+
+                if ( mask && !collector.add( mask, i, 1 ) )
+                    return false;
+            }
+
+            return find_scalar( data, i, size, step, low, high, collector );
+        }
+
+        // AVX-512 compares unsigned integers directly and produces a bit per value. Masks that are merged across shifts are spread out to a
+        // bit per byte first.
+
+        template< typename T >
+        WINCPP_TARGET( "avx512f,avx512bw" )
+        std::uint64_t inside_avx512( const std::uint8_t* data, T low, T high ) noexcept
+        {
+            if constexpr ( std::is_same_v< T, float > )
+            {
+                const auto value = _mm512_loadu_ps( data );
+                return _mm512_cmp_ps_mask( value, _mm512_set1_ps( low ), _CMP_GE_OQ ) & _mm512_cmp_ps_mask( value, _mm512_set1_ps( high ), _CMP_LE_OQ );
+            }
+            else if constexpr ( std::is_same_v< T, double > )
+            {
+                const auto value = _mm512_loadu_pd( data );
+                return _mm512_cmp_pd_mask( value, _mm512_set1_pd( low ), _CMP_GE_OQ ) & _mm512_cmp_pd_mask( value, _mm512_set1_pd( high ), _CMP_LE_OQ );
+            }
+            else
+            {
+                using U = bits_t< T >;
+
+                const auto value = _mm512_loadu_si512( data );
+                const auto lo = static_cast< U >( low ), span = static_cast< U >( U( high ) - U( low ) );
+
+                if constexpr ( sizeof( T ) == 1 )
+                    return _mm512_cmple_epu8_mask( _mm512_sub_epi8( value, _mm512_set1_epi8( static_cast< char >( lo ) ) ),
+                                                   _mm512_set1_epi8( static_cast< char >( span ) ) );
+                else if constexpr ( sizeof( T ) == 2 )
+                    return _mm512_cmple_epu16_mask( _mm512_sub_epi16( value, _mm512_set1_epi16( static_cast< short >( lo ) ) ),
+                                                    _mm512_set1_epi16( static_cast< short >( span ) ) );
+                else if constexpr ( sizeof( T ) == 4 )
+                    return _mm512_cmple_epu32_mask( _mm512_sub_epi32( value, _mm512_set1_epi32( static_cast< int >( lo ) ) ),
+                                                    _mm512_set1_epi32( static_cast< int >( span ) ) );
+                else
+                    return _mm512_cmple_epu64_mask( _mm512_sub_epi64( value, _mm512_set1_epi64( static_cast< long long >( lo ) ) ),
+                                                    _mm512_set1_epi64( static_cast< long long >( span ) ) );
+            }
+        }
+
+        template< typename T >
+        WINCPP_TARGET( "avx512f,avx512bw" )
+        std::uint64_t spread_avx512( std::uint64_t mask ) noexcept
+        {
+            const auto ones = _mm512_set1_epi8( -1 );
+
+            if constexpr ( sizeof( T ) == 1 )
+                return mask;
+            else if constexpr ( sizeof( T ) == 2 )
+                return _mm512_movepi8_mask( _mm512_maskz_mov_epi16( static_cast< __mmask32 >( mask ), ones ) ) & lane_starts< T >;
+            else if constexpr ( sizeof( T ) == 4 )
+                return _mm512_movepi8_mask( _mm512_maskz_mov_epi32( static_cast< __mmask16 >( mask ), ones ) ) & lane_starts< T >;
+            else
+                return _mm512_movepi8_mask( _mm512_maskz_mov_epi64( static_cast< __mmask8 >( mask ), ones ) ) & lane_starts< T >;
+        }
+
+        template< typename T >
+        WINCPP_TARGET( "avx512f,avx512bw" )
+        bool find_avx512( const std::uint8_t* data, std::size_t size, std::size_t step, T low, T high, collector_t& collector ) noexcept
+        {
+            std::size_t i = 0;
+
+            for ( ; i + 64 + sizeof( T ) - 1 <= size; i += 64 )
+            {
+                if ( step == sizeof( T ) )
+                {
+                    if ( const auto mask = inside_avx512( data + i, low, high ); mask && !collector.add( mask, i, sizeof( T ) ) )
+                        return false;
+
+                    continue;
+                }
+
+                std::uint64_t mask = 0;
+
+                for ( std::size_t shift = 0; shift < sizeof( T ); shift += step )
+                    mask |= spread_avx512< T >( inside_avx512( data + i + shift, low, high ) ) << shift;
+
+                if ( mask && !collector.add( mask, i, 1 ) )
+                    return false;
+            }
+
+            return find_scalar( data, i, size, step, low, high, collector );
+        }
+#endif
+
+        // `filter_values` narrows a bit set of candidates over consecutive values, a word of 64 values at a time, and skips the words that have
+        // no candidate left. Changes compare each value with its previous value, and a query compares it with the bounds like the kernels above.
+
+        enum class filter_t
+        {
+            range_t,
+            equal_t,
+            greater_t,
+            less_t
+        };
+
+        template< typename T, filter_t filter >
+        void filter_scalar(
+            const std::uint8_t* current,
+            const std::uint8_t* previous,
+            std::size_t first,
+            std::size_t count,
+            T low,
+            T high,
+            std::uint64_t* words,
+            bool invert ) noexcept
+        {
+            for ( auto i = first; i < count; ++i )
+            {
+                if ( !( ( words[ i / 64 ] >> ( i % 64 ) ) & 1 ) )
+                    continue;
+
+                T value, before;
+                std::memcpy( &value, current + i * sizeof( T ), sizeof( T ) );
+                std::memcpy( &before, previous + i * sizeof( T ), sizeof( T ) );
+
+                bool passes;
+
+                if constexpr ( filter == filter_t::range_t )
+                    passes = low <= value && value <= high;
+                else if constexpr ( filter == filter_t::equal_t )
+                    passes = value == before;
+                else if constexpr ( filter == filter_t::greater_t )
+                    passes = value > before;
+                else
+                    passes = value < before;
+
+                if ( passes == invert )
+                    words[ i / 64 ] &= ~( std::uint64_t( 1 ) << ( i % 64 ) );
+            }
+        }
+
+#if defined( WINCPP_X86 )
+        /// <summary>
+        /// Packs the bits of a byte mask that stand for the first byte of each value into consecutive bits.
+        /// </summary>
+        template< typename T >
+        constexpr std::uint64_t lanes_of( std::uint64_t bytes ) noexcept
+        {
+            if constexpr ( sizeof( T ) == 1 )
+                return bytes;
+            else if constexpr ( sizeof( T ) == 2 )
+            {
+                bytes &= 0x5555555555555555;
+                bytes = ( bytes | bytes >> 1 ) & 0x3333333333333333;
+                bytes = ( bytes | bytes >> 2 ) & 0x0F0F0F0F0F0F0F0F;
+                bytes = ( bytes | bytes >> 4 ) & 0x00FF00FF00FF00FF;
+                bytes = ( bytes | bytes >> 8 ) & 0x0000FFFF0000FFFF;
+                return ( bytes | bytes >> 16 ) & 0xFFFFFFFF;
+            }
+            else if constexpr ( sizeof( T ) == 4 )
+            {
+                bytes &= 0x1111111111111111;
+                bytes = ( bytes | bytes >> 3 ) & 0x0303030303030303;
+                bytes = ( bytes | bytes >> 6 ) & 0x000F000F000F000F;
+                bytes = ( bytes | bytes >> 12 ) & 0x000000FF000000FF;
+                return ( bytes | bytes >> 24 ) & 0xFFFF;
+            }
+            else
+            {
+                bytes &= 0x0101010101010101;
+                bytes = ( bytes | bytes >> 7 ) & 0x0003000300030003;
+                bytes = ( bytes | bytes >> 14 ) & 0x0000000F0000000F;
+                return ( bytes | bytes >> 28 ) & 0xFF;
+            }
+        }
+
+        template< typename T, filter_t filter >
+        WINCPP_TARGET( "sse2" )
+        std::uint32_t compare_sse2( const std::uint8_t* current, const std::uint8_t* previous, const bounds_sse2_t& bounds ) noexcept
+        {
+            if constexpr ( filter == filter_t::range_t )
+                return inside_sse2< T >( current, bounds );
+            else if constexpr ( filter == filter_t::less_t )
+                return compare_sse2< T, filter_t::greater_t >( previous, current, bounds );
+            else if constexpr ( std::is_same_v< T, float > )
+            {
+                const auto a = _mm_loadu_ps( reinterpret_cast< const float* >( current ) ), b = _mm_loadu_ps( reinterpret_cast< const float* >( previous ) );
+
+                if constexpr ( filter == filter_t::equal_t )
+                    return _mm_movemask_epi8( _mm_castps_si128( _mm_cmpeq_ps( a, b ) ) );
+                else
+                    return _mm_movemask_epi8( _mm_castps_si128( _mm_cmpgt_ps( a, b ) ) );
+            }
+            else if constexpr ( std::is_same_v< T, double > )
+            {
+                const auto a = _mm_loadu_pd( reinterpret_cast< const double* >( current ) ), b = _mm_loadu_pd( reinterpret_cast< const double* >( previous ) );
+
+                if constexpr ( filter == filter_t::equal_t )
+                    return _mm_movemask_epi8( _mm_castpd_si128( _mm_cmpeq_pd( a, b ) ) );
+                else
+                    return _mm_movemask_epi8( _mm_castpd_si128( _mm_cmpgt_pd( a, b ) ) );
+            }
+            else
+            {
+                auto a = _mm_loadu_si128( reinterpret_cast< const __m128i* >( current ) ), b = _mm_loadu_si128( reinterpret_cast< const __m128i* >( previous ) );
+
+                if constexpr ( filter == filter_t::equal_t )
+                {
+                    if constexpr ( sizeof( T ) == 1 )
+                        return _mm_movemask_epi8( _mm_cmpeq_epi8( a, b ) );
+                    else if constexpr ( sizeof( T ) == 2 )
+                        return _mm_movemask_epi8( _mm_cmpeq_epi16( a, b ) );
+                    else
+                        return _mm_movemask_epi8( _mm_cmpeq_epi32( a, b ) );
+                }
+                else
+                {
+                    if constexpr ( std::is_unsigned_v< T > )
+                        a = _mm_xor_si128( a, bounds.flip ), b = _mm_xor_si128( b, bounds.flip );
+
+                    if constexpr ( sizeof( T ) == 1 )
+                        return _mm_movemask_epi8( _mm_cmpgt_epi8( a, b ) );
+                    else if constexpr ( sizeof( T ) == 2 )
+                        return _mm_movemask_epi8( _mm_cmpgt_epi16( a, b ) );
+                    else
+                        return _mm_movemask_epi8( _mm_cmpgt_epi32( a, b ) );
+                }
+            }
+        }
+
+        template< typename T, filter_t filter >
+        WINCPP_TARGET( "sse2" )
+        std::size_t filter_sse2( const std::uint8_t* current, const std::uint8_t* previous, std::size_t count, T low, T high, std::uint64_t* words, bool invert ) noexcept
+        {
+            constexpr auto lanes = 16 / sizeof( T );
+
+            const auto bounds = bounds_sse2( low, high );
+            std::size_t w = 0;
+
+            for ( ; ( w + 1 ) * 64 <= count; ++w )
+            {
+                if ( !words[ w ] )
+                    continue;
+
+                std::uint64_t mask = 0;
+
+                for ( std::size_t k = 0; k < 64; k += lanes )
+                {
+                    const auto offset = ( w * 64 + k ) * sizeof( T );
+                    mask |= lanes_of< T >( compare_sse2< T, filter >( current + offset, previous + offset, bounds ) ) << k;
+                }
+
+                words[ w ] &= invert ? ~mask : mask;
+            }
+
+            return w * 64;
+        }
+
+        template< typename T, filter_t filter >
+        WINCPP_TARGET( "avx2" )
+        std::uint32_t compare_avx2( const std::uint8_t* current, const std::uint8_t* previous, const bounds_avx2_t& bounds ) noexcept
+        {
+            if constexpr ( filter == filter_t::range_t )
+                return inside_avx2< T >( current, bounds );
+            else if constexpr ( filter == filter_t::less_t )
+                return compare_avx2< T, filter_t::greater_t >( previous, current, bounds );
+            else if constexpr ( std::is_same_v< T, float > )
+            {
+                const auto a = _mm256_loadu_ps( reinterpret_cast< const float* >( current ) );
+                const auto b = _mm256_loadu_ps( reinterpret_cast< const float* >( previous ) );
+
+                if constexpr ( filter == filter_t::equal_t )
+                    return _mm256_movemask_epi8( _mm256_castps_si256( _mm256_cmp_ps( a, b, _CMP_EQ_OQ ) ) );
+                else
+                    return _mm256_movemask_epi8( _mm256_castps_si256( _mm256_cmp_ps( a, b, _CMP_GT_OQ ) ) );
+            }
+            else if constexpr ( std::is_same_v< T, double > )
+            {
+                const auto a = _mm256_loadu_pd( reinterpret_cast< const double* >( current ) );
+                const auto b = _mm256_loadu_pd( reinterpret_cast< const double* >( previous ) );
+
+                if constexpr ( filter == filter_t::equal_t )
+                    return _mm256_movemask_epi8( _mm256_castpd_si256( _mm256_cmp_pd( a, b, _CMP_EQ_OQ ) ) );
+                else
+                    return _mm256_movemask_epi8( _mm256_castpd_si256( _mm256_cmp_pd( a, b, _CMP_GT_OQ ) ) );
+            }
+            else
+            {
+                auto a = _mm256_loadu_si256( reinterpret_cast< const __m256i* >( current ) );
+                auto b = _mm256_loadu_si256( reinterpret_cast< const __m256i* >( previous ) );
+
+                if constexpr ( filter == filter_t::equal_t )
+                {
+                    if constexpr ( sizeof( T ) == 1 )
+                        return _mm256_movemask_epi8( _mm256_cmpeq_epi8( a, b ) );
+                    else if constexpr ( sizeof( T ) == 2 )
+                        return _mm256_movemask_epi8( _mm256_cmpeq_epi16( a, b ) );
+                    else if constexpr ( sizeof( T ) == 4 )
+                        return _mm256_movemask_epi8( _mm256_cmpeq_epi32( a, b ) );
+                    else
+                        return _mm256_movemask_epi8( _mm256_cmpeq_epi64( a, b ) );
+                }
+                else
+                {
+                    if constexpr ( std::is_unsigned_v< T > )
+                        a = _mm256_xor_si256( a, bounds.flip ), b = _mm256_xor_si256( b, bounds.flip );
+
+                    if constexpr ( sizeof( T ) == 1 )
+                        return _mm256_movemask_epi8( _mm256_cmpgt_epi8( a, b ) );
+                    else if constexpr ( sizeof( T ) == 2 )
+                        return _mm256_movemask_epi8( _mm256_cmpgt_epi16( a, b ) );
+                    else if constexpr ( sizeof( T ) == 4 )
+                        return _mm256_movemask_epi8( _mm256_cmpgt_epi32( a, b ) );
+                    else
+                        return _mm256_movemask_epi8( _mm256_cmpgt_epi64( a, b ) );
+                }
+            }
+        }
+
+        template< typename T, filter_t filter >
+        WINCPP_TARGET( "avx2" )
+        std::size_t filter_avx2( const std::uint8_t* current, const std::uint8_t* previous, std::size_t count, T low, T high, std::uint64_t* words, bool invert ) noexcept
+        {
+            constexpr auto lanes = 32 / sizeof( T );
+
+            const auto bounds = bounds_avx2( low, high );
+            std::size_t w = 0;
+
+            for ( ; ( w + 1 ) * 64 <= count; ++w )
+            {
+                if ( !words[ w ] )
+                    continue;
+
+                std::uint64_t mask = 0;
+
+                for ( std::size_t k = 0; k < 64; k += lanes )
+                {
+                    const auto offset = ( w * 64 + k ) * sizeof( T );
+                    mask |= lanes_of< T >( compare_avx2< T, filter >( current + offset, previous + offset, bounds ) ) << k;
+                }
+
+                words[ w ] &= invert ? ~mask : mask;
+            }
+
+            return w * 64;
+        }
+
+        template< typename T, filter_t filter >
+        WINCPP_TARGET( "avx512f,avx512bw" )
+        std::uint64_t compare_avx512( const std::uint8_t* current, const std::uint8_t* previous, T low, T high ) noexcept
+        {
+            if constexpr ( filter == filter_t::range_t )
+                return inside_avx512( current, low, high );
+            else if constexpr ( filter == filter_t::less_t )
+                return compare_avx512< T, filter_t::greater_t >( previous, current, low, high );
+            else if constexpr ( std::is_same_v< T, float > )
+            {
+                const auto a = _mm512_loadu_ps( current ), b = _mm512_loadu_ps( previous );
+
+                if constexpr ( filter == filter_t::equal_t )
+                    return _mm512_cmp_ps_mask( a, b, _CMP_EQ_OQ );
+                else
+                    return _mm512_cmp_ps_mask( a, b, _CMP_GT_OQ );
+            }
+            else if constexpr ( std::is_same_v< T, double > )
+            {
+                const auto a = _mm512_loadu_pd( current ), b = _mm512_loadu_pd( previous );
+
+                if constexpr ( filter == filter_t::equal_t )
+                    return _mm512_cmp_pd_mask( a, b, _CMP_EQ_OQ );
+                else
+                    return _mm512_cmp_pd_mask( a, b, _CMP_GT_OQ );
+            }
+            else
+            {
+                const auto a = _mm512_loadu_si512( current ), b = _mm512_loadu_si512( previous );
+
+                if constexpr ( filter == filter_t::equal_t )
+                {
+                    if constexpr ( sizeof( T ) == 1 )
+                        return _mm512_cmpeq_epi8_mask( a, b );
+                    else if constexpr ( sizeof( T ) == 2 )
+                        return _mm512_cmpeq_epi16_mask( a, b );
+                    else if constexpr ( sizeof( T ) == 4 )
+                        return _mm512_cmpeq_epi32_mask( a, b );
+                    else
+                        return _mm512_cmpeq_epi64_mask( a, b );
+                }
+                else if constexpr ( std::is_unsigned_v< T > )
+                {
+                    if constexpr ( sizeof( T ) == 1 )
+                        return _mm512_cmpgt_epu8_mask( a, b );
+                    else if constexpr ( sizeof( T ) == 2 )
+                        return _mm512_cmpgt_epu16_mask( a, b );
+                    else if constexpr ( sizeof( T ) == 4 )
+                        return _mm512_cmpgt_epu32_mask( a, b );
+                    else
+                        return _mm512_cmpgt_epu64_mask( a, b );
+                }
+                else
+                {
+                    if constexpr ( sizeof( T ) == 1 )
+                        return _mm512_cmpgt_epi8_mask( a, b );
+                    else if constexpr ( sizeof( T ) == 2 )
+                        return _mm512_cmpgt_epi16_mask( a, b );
+                    else if constexpr ( sizeof( T ) == 4 )
+                        return _mm512_cmpgt_epi32_mask( a, b );
+                    else
+                        return _mm512_cmpgt_epi64_mask( a, b );
+                }
+            }
+        }
+
+        template< typename T, filter_t filter >
+        WINCPP_TARGET( "avx512f,avx512bw" )
+        std::size_t filter_avx512( const std::uint8_t* current, const std::uint8_t* previous, std::size_t count, T low, T high, std::uint64_t* words, bool invert ) noexcept
+        {
+            constexpr auto lanes = 64 / sizeof( T );
+            std::size_t w = 0;
+
+            for ( ; ( w + 1 ) * 64 <= count; ++w )
+            {
+                if ( !words[ w ] )
+                    continue;
+
+                std::uint64_t mask = 0;
+
+                for ( std::size_t k = 0; k < 64; k += lanes )
+                {
+                    const auto offset = ( w * 64 + k ) * sizeof( T );
+                    mask |= compare_avx512< T, filter >( current + offset, previous + offset, low, high ) << k;
+                }
+
+                words[ w ] &= invert ? ~mask : mask;
+            }
+
+            return w * 64;
+        }
+#endif
+
+        /// <summary>
+        /// Runs the widest filter kernel the CPU supports over the whole words of the set, and the scalar kernel over the rest.
+        /// </summary>
+        template< typename T, filter_t filter >
+        void filter_words( const std::uint8_t* current, const std::uint8_t* previous, std::size_t count, T low, T high, std::uint64_t* words, bool invert ) noexcept
+        {
+            std::size_t done = 0;
+
+#if defined( WINCPP_X86 )
+            switch ( core::simd_level() )
+            {
+                case core::simd_level_t::avx512_t: done = filter_avx512< T, filter >( current, previous, count, low, high, words, invert ); break;
+                case core::simd_level_t::avx2_t: done = filter_avx2< T, filter >( current, previous, count, low, high, words, invert ); break;
+                case core::simd_level_t::sse2_t:
+                    // SSE2 has no 64-bit integer compare.
+                    if constexpr ( std::is_floating_point_v< T > || sizeof( T ) < 8 )
+                        done = filter_sse2< T, filter >( current, previous, count, low, high, words, invert );
+                    break;
+                default: break;
+            }
+#endif
+
+            filter_scalar< T, filter >( current, previous, done, count, low, high, words, invert );
+        }
+
+        /// <summary>
+        /// Clears the bits of the set past the count, and counts the bits left once the function has narrowed the rest.
+        /// </summary>
+        template< typename function_t >
+        std::size_t narrow( std::span< std::uint64_t > candidates, std::size_t count, function_t&& function )
+        {
+            for ( auto w = ( count + 63 ) / 64; w < candidates.size(); ++w )
+                candidates[ w ] = 0;
+
+            if ( count % 64 )
+                candidates[ count / 64 ] &= ( std::uint64_t( 1 ) << ( count % 64 ) ) - 1;
+
+            function();
+
+            std::size_t left = 0;
+
+            for ( const auto word : candidates )
+                left += std::popcount( word );
+
+            return left;
+        }
+    }  // namespace
+
+    value_query_t::value_query_t( value_type_t type, std::uint64_t low, std::uint64_t high, std::size_t alignment )
+        : type( type ),
+          low( low ),
+          high( high ),
+          alignment( alignment )
+    {
+        if ( !std::has_single_bit( alignment ) )
+            throw core::error::from_user( core::user_error_type_t::invalid_value_query_t, "The alignment {} isn't a power of two", alignment );
+
+        // Only the bits of the type take part, so the rest are cleared to keep queries of the same values equal.
+        if ( size() < sizeof( std::uint64_t ) )
+        {
+            const auto mask = ( std::uint64_t( 1 ) << size() * 8 ) - 1;
+            this->low &= mask;
+            this->high &= mask;
+        }
+
+        const auto ordered = with_type( type, [ & ]< typename T >( std::type_identity< T > )
+                                        { return value_of< T >( this->low ) <= value_of< T >( this->high ); } );
+
+        if ( !ordered )
+            throw core::error::from_user( core::user_error_type_t::invalid_value_query_t, "The value query has an empty range or a NaN bound" );
+    }
+
+    std::vector< std::uintptr_t > find_values( std::span< const std::uint8_t > buffer, const value_query_t& query, std::size_t limit ) noexcept
+    {
+        std::vector< std::uintptr_t > results;
+
+        if ( limit == 0 )
+            return results;
+
+        with_type(
+            query.type,
+            [ & ]< typename T >( std::type_identity< T > )
+            {
+                const auto step = std::min( query.alignment, sizeof( T ) );
+                const auto low = value_of< T >( query.low ), high = value_of< T >( query.high );
+
+                collector_t collector{ results, limit, query.alignment > sizeof( T ) ? query.alignment - 1 : 0 };
+
+#if defined( WINCPP_X86 )
+                switch ( core::simd_level() )
+                {
+                    case core::simd_level_t::avx512_t: find_avx512( buffer.data(), buffer.size(), step, low, high, collector ); return;
+                    case core::simd_level_t::avx2_t: find_avx2( buffer.data(), buffer.size(), step, low, high, collector ); return;
+                    case core::simd_level_t::sse2_t:
+                        // SSE2 has no 64-bit integer compare.
+                        if constexpr ( std::is_floating_point_v< T > || sizeof( T ) < 8 )
+                        {
+                            find_sse2( buffer.data(), buffer.size(), step, low, high, collector );
+                            return;
+                        }
+                        break;
+                    default: break;
+                }
+#endif
+
+                find_scalar( buffer.data(), 0, buffer.size(), step, low, high, collector );
+            } );
+
+        return results;
+    }
+
+    std::size_t filter_values( std::span< const std::uint8_t > values, const value_query_t& query, std::span< std::uint64_t > candidates ) noexcept
+    {
+        const auto count = std::min( values.size() / query.size(), candidates.size() * 64 );
+
+        return narrow(
+            candidates,
+            count,
+            [ & ]
+            {
+                with_type(
+                    query.type,
+                    [ & ]< typename T >( std::type_identity< T > )
+                    {
+                        filter_words< T, filter_t::range_t >(
+                            values.data(), values.data(), count, value_of< T >( query.low ), value_of< T >( query.high ), candidates.data(), false );
+                    } );
+            } );
+    }
+
+    std::size_t filter_values(
+        std::span< const std::uint8_t > values,
+        std::span< const std::uint8_t > previous,
+        value_type_t type,
+        value_change_t change,
+        std::span< std::uint64_t > candidates ) noexcept
+    {
+        const auto count = std::min( std::min( values.size(), previous.size() ) / size_of( type ), candidates.size() * 64 );
+
+        return narrow(
+            candidates,
+            count,
+            [ & ]
+            {
+                with_type(
+                    type,
+                    [ & ]< typename T >( std::type_identity< T > )
+                    {
+                        const auto words = candidates.data();
+
+                        switch ( change )
+                        {
+                            case value_change_t::changed_t:
+                                filter_words< T, filter_t::equal_t >( values.data(), previous.data(), count, T{}, T{}, words, true );
+                                break;
+                            case value_change_t::unchanged_t:
+                                filter_words< T, filter_t::equal_t >( values.data(), previous.data(), count, T{}, T{}, words, false );
+                                break;
+                            case value_change_t::increased_t:
+                                filter_words< T, filter_t::greater_t >( values.data(), previous.data(), count, T{}, T{}, words, false );
+                                break;
+                            case value_change_t::decreased_t:
+                                filter_words< T, filter_t::less_t >( values.data(), previous.data(), count, T{}, T{}, words, false );
+                                break;
+                        }
+                    } );
+            } );
+    }
+}  // namespace wincpp::patterns